@@ -0,0 +1,494 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL_timer.h>
+
+#include <pestacle/math/average.h>
+#include <pestacle/math/vector.h>
+#include <pestacle/math/matrix.h>
+#include <pestacle/math/randomizer.h>
+#include <pestacle/math/array_ops_backend.h>
+#include <pestacle/image/gaussian.h>
+
+
+/******************************************************************************
+  Micro-benchmarks of the math kernels of libpestacle, on square matrices from
+  64 x 64 to 4096 x 4096 and, for the filters, on a range of kernel lengths.
+  Each kernel is run until it is warm, then repeatedly until the minimum time
+  and repetition count are reached. The median time gives the time per
+  element and the memory throughput, the latter counting the bytes each
+  element of the output requires to read and write.
+
+  Usage : bench_math [--csv | --json] [--filter <text>] [--max-size <n>]
+                     [--min-time <seconds>]
+ *****************************************************************************/
+
+
+// --- Benchmarks -------------------------------------------------------------
+
+typedef struct {
+	size_t size;
+	size_t kernel_len;
+	Matrix U;
+	Matrix V;
+	Matrix W;
+	Vector kernel;
+	Randomizer rng;
+	GaussianFilter filter;
+	real_t sink; // Keeps the reductions alive
+} BenchContext;
+
+
+typedef struct {
+	const char* name;
+	bool has_kernel_len;      // Swept over the kernel lengths
+	size_t bytes_per_element; // Read and written per output element
+	void (*run)(BenchContext*);
+} Benchmark;
+
+
+static void
+bench_convolution__mirror(
+	BenchContext* context
+) {
+	const real_t* src = context->U.data;
+	real_t* dst = context->V.data;
+	for(size_t i = context->size; i != 0; --i, src += context->U.row_stride, dst += context->V.row_stride)
+		array_ops_convolution__mirror(dst, src, context->kernel.data, context->size, context->kernel_len);
+}
+
+
+static void
+bench_rowwise_convolution__mirror(
+	BenchContext* context
+) {
+	Matrix_rowwise_convolution__mirror(&(context->V), &(context->U), &(context->kernel));
+}
+
+
+static void
+bench_colwise_convolution__mirror(
+	BenchContext* context
+) {
+	Matrix_colwise_convolution__mirror(&(context->V), &(context->U), &(context->kernel));
+}
+
+
+static void
+bench_rowwise_box_filter(
+	BenchContext* context
+) {
+	Matrix_rowwise_box_filter(&(context->V), &(context->U), context->kernel_len);
+}
+
+
+static void
+bench_colwise_box_filter(
+	BenchContext* context
+) {
+	Matrix_colwise_box_filter(&(context->V), &(context->U), context->kernel_len);
+}
+
+
+static void
+bench_gaussian_recursive(
+	BenchContext* context
+) {
+	Matrix_copy(&(context->V), &(context->U));
+	GaussianFilter_transform(&(context->filter), &(context->V));
+}
+
+
+static void
+bench_transpose(
+	BenchContext* context
+) {
+	Matrix_transpose(&(context->V), &(context->U));
+}
+
+
+static void
+bench_resample_nearest(
+	BenchContext* context
+) {
+	Matrix_resample_nearest(&(context->V), &(context->W));
+}
+
+
+static void
+bench_random_uniform(
+	BenchContext* context
+) {
+	real_t* dst = context->V.data;
+	for(size_t i = context->size; i != 0; --i, dst += context->V.row_stride)
+		for(size_t j = 0; j < context->size; ++j)
+			dst[j] = Randomizer_next_uniform(&(context->rng));
+}
+
+
+static void
+bench_add(
+	BenchContext* context
+) {
+	Matrix_add(&(context->V), &(context->U));
+}
+
+
+static void
+bench_reduction_sum(
+	BenchContext* context
+) {
+	context->sink += Matrix_reduction_sum(&(context->U));
+}
+
+
+static const Benchmark
+benchmarks[] = {
+	{ "array_ops_convolution__mirror",      true,  2 * sizeof(real_t), bench_convolution__mirror },
+	{ "Matrix_rowwise_convolution__mirror", true,  2 * sizeof(real_t), bench_rowwise_convolution__mirror },
+	{ "Matrix_colwise_convolution__mirror", true,  2 * sizeof(real_t), bench_colwise_convolution__mirror },
+	{ "Matrix_rowwise_box_filter",          true,  2 * sizeof(real_t), bench_rowwise_box_filter },
+	{ "Matrix_colwise_box_filter",          true,  2 * sizeof(real_t), bench_colwise_box_filter },
+	{ "GaussianFilter_transform__recursive", false, 3 * sizeof(real_t), bench_gaussian_recursive },
+	{ "Matrix_transpose",                   false, 2 * sizeof(real_t), bench_transpose },
+	{ "Matrix_resample_nearest",            false, 2 * sizeof(real_t), bench_resample_nearest },
+	{ "Randomizer_next_uniform",            false, 1 * sizeof(real_t), bench_random_uniform },
+	{ "Matrix_add",                         false, 3 * sizeof(real_t), bench_add },
+	{ "Matrix_reduction_sum",               false, 1 * sizeof(real_t), bench_reduction_sum },
+	{ 0, false, 0, 0 }
+};
+
+
+static const size_t
+kernel_lens[] = { 3, 7, 15, 31, 63, 0 };
+
+
+static void
+BenchContext_init(
+	BenchContext* self,
+	size_t size,
+	size_t kernel_len
+) {
+	self->size = size;
+	self->kernel_len = kernel_len;
+	self->sink = (real_t)0;
+
+	Randomizer_init(&(self->rng), RandomizerSize_1024);
+	Randomizer_seed(&(self->rng), 42);
+
+	Matrix_init(&(self->U), size, size);
+	Matrix_init(&(self->V), size, size);
+	Matrix_init(&(self->W), size / 2, size / 2);
+	Matrix_random_uniform(&(self->U), &(self->rng));
+	Matrix_random_uniform(&(self->W), &(self->rng));
+	Matrix_fill(&(self->V), (real_t)0);
+
+	Vector_init(&(self->kernel), kernel_len);
+	Vector_set_gaussian_kernel(&(self->kernel), ((real_t)kernel_len) / 6);
+
+	GaussianFilter_init(
+		&(self->filter),
+		size,
+		size,
+		(real_t)3,
+		GaussianFilterMode__MIRROR,
+		GaussianFilterMethod__RECURSIVE
+	);
+}
+
+
+static void
+BenchContext_destroy(
+	BenchContext* self
+) {
+	GaussianFilter_destroy(&(self->filter));
+	Vector_destroy(&(self->kernel));
+	Matrix_destroy(&(self->W));
+	Matrix_destroy(&(self->V));
+	Matrix_destroy(&(self->U));
+	Randomizer_destroy(&(self->rng));
+}
+
+
+// --- Measurements -----------------------------------------------------------
+
+#define BENCH_MIN_REPETITION_COUNT 5
+#define BENCH_MAX_REPETITION_COUNT 1000
+
+
+typedef struct {
+	const char* name;
+	size_t size;
+	size_t kernel_len; // 0 if not relevant
+	size_t repetition_count;
+	double min_time;
+	double median_time;
+	double mean_time;
+	double stddev_time;
+	double ns_per_element;
+	double gb_per_second;
+} BenchResult;
+
+
+static double
+bench_elapsed(
+	Uint64 start_time
+) {
+	return ((double)(SDL_GetPerformanceCounter() - start_time)) / SDL_GetPerformanceFrequency();
+}
+
+
+static int
+bench_compare_times(
+	const void* a,
+	const void* b
+) {
+	double x = *((const double*)a);
+	double y = *((const double*)b);
+	return (x > y) - (x < y);
+}
+
+
+static void
+bench_measure(
+	const Benchmark* benchmark,
+	BenchContext* context,
+	double min_time,
+	BenchResult* result
+) {
+	// Warm up the caches, the branch predictors and the CPU frequency
+	Uint64 start_time = SDL_GetPerformanceCounter();
+	do
+		benchmark->run(context);
+	while(bench_elapsed(start_time) < min_time / 10);
+
+	// Time the repetitions
+	double times[BENCH_MAX_REPETITION_COUNT];
+	size_t repetition_count = 0;
+	double total_time = 0;
+
+	while(
+		(repetition_count < BENCH_MIN_REPETITION_COUNT) ||
+		((total_time < min_time) && (repetition_count < BENCH_MAX_REPETITION_COUNT))
+	) {
+		Uint64 repetition_start_time = SDL_GetPerformanceCounter();
+		benchmark->run(context);
+		times[repetition_count] = bench_elapsed(repetition_start_time);
+		total_time += times[repetition_count];
+		repetition_count += 1;
+	}
+
+	// Statistics
+	AverageResult average;
+	AverageResult_init(&average);
+	for(size_t i = 0; i < repetition_count; ++i)
+		AverageResult_accumulate(&average, (real_t)times[i]);
+
+	qsort(times, repetition_count, sizeof(double), bench_compare_times);
+
+	size_t element_count = context->size * context->size;
+
+	result->name = benchmark->name;
+	result->size = context->size;
+	result->kernel_len = benchmark->has_kernel_len ? context->kernel_len : 0;
+	result->repetition_count = repetition_count;
+	result->min_time = times[0];
+	result->median_time = times[repetition_count / 2];
+	result->mean_time = AverageResult_mean(&average);
+	result->stddev_time = AverageResult_stddev(&average);
+	result->ns_per_element = 1e9 * result->median_time / element_count;
+	result->gb_per_second = 1e-9 * (benchmark->bytes_per_element * element_count) / result->median_time;
+}
+
+
+// --- Reporting --------------------------------------------------------------
+
+enum BenchFormat {
+	BenchFormat__text,
+	BenchFormat__csv,
+	BenchFormat__json
+}; // enum BenchFormat
+
+
+static void
+bench_print_header(
+	enum BenchFormat format,
+	FILE* fp
+) {
+	const char* backend = array_ops_get_backend()->name;
+
+	switch(format) {
+		case BenchFormat__text:
+			fprintf(fp, "backend %s\n", backend);
+			fprintf(
+				fp,
+				"%-38s %6s %6s %6s %12s %12s %12s %10s %8s\n",
+				"kernel", "size", "kernel", "reps", "median (us)", "min (us)", "stddev (us)", "ns/elem", "GB/s"
+			);
+			break;
+
+		case BenchFormat__csv:
+			fprintf(fp, "backend,kernel,size,kernel_len,repetitions,median_s,min_s,mean_s,stddev_s,ns_per_element,gb_per_s\n");
+			break;
+
+		case BenchFormat__json:
+			fprintf(fp, "{\n  \"backend\": \"%s\",\n  \"results\": [", backend);
+			break;
+	}
+}
+
+
+static void
+bench_print_result(
+	enum BenchFormat format,
+	const BenchResult* result,
+	bool is_first,
+	FILE* fp
+) {
+	switch(format) {
+		case BenchFormat__text:
+			fprintf(
+				fp,
+				"%-38s %6zu %6zu %6zu %12.2f %12.2f %12.2f %10.3f %8.2f\n",
+				result->name,
+				result->size,
+				result->kernel_len,
+				result->repetition_count,
+				1e6 * result->median_time,
+				1e6 * result->min_time,
+				1e6 * result->stddev_time,
+				result->ns_per_element,
+				result->gb_per_second
+			);
+			break;
+
+		case BenchFormat__csv:
+			fprintf(
+				fp,
+				"%s,%s,%zu,%zu,%zu,%.9g,%.9g,%.9g,%.9g,%.6g,%.6g\n",
+				array_ops_get_backend()->name,
+				result->name,
+				result->size,
+				result->kernel_len,
+				result->repetition_count,
+				result->median_time,
+				result->min_time,
+				result->mean_time,
+				result->stddev_time,
+				result->ns_per_element,
+				result->gb_per_second
+			);
+			break;
+
+		case BenchFormat__json:
+			fprintf(
+				fp,
+				"%s\n    {\"kernel\": \"%s\", \"size\": %zu, \"kernel_len\": %zu, \"repetitions\": %zu, "
+				"\"median_s\": %.9g, \"min_s\": %.9g, \"mean_s\": %.9g, \"stddev_s\": %.9g, "
+				"\"ns_per_element\": %.6g, \"gb_per_s\": %.6g}",
+				is_first ? "" : ",",
+				result->name,
+				result->size,
+				result->kernel_len,
+				result->repetition_count,
+				result->median_time,
+				result->min_time,
+				result->mean_time,
+				result->stddev_time,
+				result->ns_per_element,
+				result->gb_per_second
+			);
+			break;
+	}
+
+	fflush(fp);
+}
+
+
+static void
+bench_print_footer(
+	enum BenchFormat format,
+	FILE* fp
+) {
+	if (format == BenchFormat__json)
+		fprintf(fp, "\n  ]\n}\n");
+}
+
+
+// --- Main -------------------------------------------------------------------
+
+static void
+bench_print_usage(
+	const char* prog_name
+) {
+	fprintf(
+		stderr,
+		"Usage: %s [--csv | --json] [--filter <text>] [--max-size <n>] [--min-time <seconds>]\n",
+		prog_name
+	);
+}
+
+
+int
+main(
+	int argc,
+	char *argv[]
+) {
+	enum BenchFormat format = BenchFormat__text;
+	const char* filter = 0;
+	size_t max_size = 4096;
+	double min_time = .25;
+
+	// Parse the arguments
+	for(int i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "--csv"))
+			format = BenchFormat__csv;
+		else if (!strcmp(argv[i], "--json"))
+			format = BenchFormat__json;
+		else if ((!strcmp(argv[i], "--filter")) && (i + 1 < argc))
+			filter = argv[++i];
+		else if ((!strcmp(argv[i], "--max-size")) && (i + 1 < argc))
+			max_size = (size_t)strtoul(argv[++i], 0, 10);
+		else if ((!strcmp(argv[i], "--min-time")) && (i + 1 < argc))
+			min_time = strtod(argv[++i], 0);
+		else {
+			bench_print_usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	#ifdef DEBUG
+	fprintf(stderr, "warning: debug build, use MODE=rls for meaningful timings\n");
+	#endif
+
+	// Run the benchmarks
+	bench_print_header(format, stdout);
+
+	bool is_first = true;
+	for(const Benchmark* benchmark = benchmarks; benchmark->name; ++benchmark) {
+		if (filter && (!strstr(benchmark->name, filter)))
+			continue;
+
+		for(size_t size = 64; size <= max_size; size *= 2) {
+			for(const size_t* kernel_len = kernel_lens; *kernel_len; ++kernel_len) {
+				BenchContext context;
+				BenchContext_init(&context, size, *kernel_len);
+
+				BenchResult result;
+				bench_measure(benchmark, &context, min_time, &result);
+				bench_print_result(format, &result, is_first, stdout);
+				is_first = false;
+
+				BenchContext_destroy(&context);
+
+				if (!benchmark->has_kernel_len)
+					break;
+			}
+		}
+	}
+
+	bench_print_footer(format, stdout);
+
+	// Job done
+	return EXIT_SUCCESS;
+}
@@ -8,14 +8,35 @@ extern "C" {
 
 #include <SDL.h>
 #include <pestacle/scope.h>
+#include <pestacle/thread_pool.h>
 #include <pestacle/graph_profile.h>
+#include <pestacle/graph_memory.h>
+#include <pestacle/graph_pipeline.h>
 #include <pestacle/math/vector.h>
 #include <pestacle/math/matrix.h>
 
 
+/*
+ * A level groups nodes that only depends on nodes from the previous levels,
+ * thus nodes of a level can be updated concurrently. Nodes which have to be
+ * updated on the main thread come first in a level.
+ */
+
+typedef struct {
+	size_t start;
+	size_t count;
+	size_t main_thread_count;
+} GraphLevel;
+
+
 struct s_Graph {
 	size_t sorted_node_count;
 	Node** sorted_nodes;
+	size_t level_count;
+	GraphLevel* levels;
+	ThreadPool* thread_pool;
+	GraphPipeline* pipeline;
+	GraphMemoryPlan* memory_plan;
 }; // struct s_Graph
 
 typedef struct s_Graph Graph;
@@ -40,6 +61,35 @@ Graph_setup(
 );
 
 
+/*
+ * Set the thread pool used to update the graph, and by the nodes to
+ * parallelize their own update
+ *   thread_pool : the thread pool, 0 for a serial update
+ */
+
+extern void
+Graph_set_thread_pool(
+	Graph* self,
+	ThreadPool* thread_pool
+);
+
+
+/*
+ * Set how many frames the source nodes are updated ahead of the rest of the
+ * graph, on a dedicated thread. Raises the throughput of deep graphs, each
+ * frame of advance adding one frame of latency. To be called after setup.
+ *   depth : number of frames of advance, 0 to update the sources in line
+ *
+ * Returns false if the pipeline could not be started
+ */
+
+extern bool
+Graph_set_pipeline_depth(
+	Graph* self,
+	size_t depth
+);
+
+
 extern void
 Graph_update(
 	Graph* self
@@ -0,0 +1,58 @@
+#ifndef PESTACLE_GRAPH_MEMORY_H
+#define PESTACLE_GRAPH_MEMORY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/******************************************************************************
+  Memory planning for the outputs of a graph. Nodes requesting an output
+  buffer (see Node_request_output_buffer) share a pool of buffers : a buffer
+  is reused once the nodes reading the previous output it held are updated.
+  Lifetimes are counted in levels, so that the plan holds for a parallel
+  update. Outputs of static nodes, computed once, and outputs read by no
+  node keep a buffer of their own. A node able to run in place takes over
+  the buffer of its first input when it is the only reader of that input.
+ *****************************************************************************/
+
+
+#include <stddef.h>
+#include <pestacle/math/real.h>
+
+
+struct s_Graph;
+
+typedef struct {
+	size_t buffer_count;
+	real_t** buffers;
+	size_t* buffer_lens;
+	size_t request_count;  // Number of nodes using the buffers
+	size_t requested_len;  // Total length of the outputs using the buffers
+	size_t in_place_count; // Number of nodes updating the output of their input
+} GraphMemoryPlan;
+
+
+/*
+ * Assign a buffer to each node of the graph requesting an output buffer.
+ * To be called once all the nodes of the graph are set up.
+ */
+
+extern void
+GraphMemoryPlan_init(
+	GraphMemoryPlan* self,
+	struct s_Graph* graph
+);
+
+
+extern void
+GraphMemoryPlan_destroy(
+	GraphMemoryPlan* self
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PESTACLE_GRAPH_MEMORY_H */
@@ -0,0 +1,106 @@
+#ifndef PESTACLE_GRAPH_PIPELINE_H
+#define PESTACLE_GRAPH_PIPELINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/******************************************************************************
+  Pipelined update of the source nodes of a graph. A producer thread updates
+  the source nodes up to 'depth' frames ahead of the rest of the graph,
+  copying their outputs into a ring of slots : depth 1 is double buffering,
+  depth 2 triple buffering. The rest of the graph reads the outputs latched
+  in a slot, released at the next frame. A deeper pipeline absorbs more
+  jitter of the sources, at the cost of one frame of latency per slot.
+ *****************************************************************************/
+
+
+#include <SDL_atomic.h>
+#include <SDL_thread.h>
+#include <SDL_mutex.h>
+#include <pestacle/node.h>
+
+
+typedef struct {
+	size_t source_count;
+	Node** sources;
+	size_t* source_indices;   // Index of each source in the sorted nodes
+
+	size_t slot_count;
+	NodeOutput* outputs;      // slot_count x source_count latched outputs
+	Matrix* matrices;         // Storage for the latched matrix outputs
+	real_t* update_times;     // slot_count x source_count update durations
+
+	size_t read_slot;
+	size_t write_slot;
+	bool has_read_slot;
+
+	SDL_sem* free_slots;
+	SDL_sem* ready_slots;
+	SDL_atomic_t quit;
+	SDL_Thread* thread;
+} GraphPipeline;
+
+
+/*
+ * Returns true if the node can be updated ahead of the rest of the graph :
+ * it has no input, an update method and is not bound to the main thread. A
+ * stateless node is not pipelined, as it is only updated once.
+ */
+
+extern bool
+GraphPipeline_is_source(
+	const Node* node
+);
+
+
+/*
+ * Initialize a pipeline and start its producer thread
+ *   nodes : the nodes of the graph, in topological order
+ *   depth : number of frames the sources can run ahead, at least 1
+ *
+ * Returns false if the producer thread could not be started
+ */
+
+extern bool
+GraphPipeline_init(
+	GraphPipeline* self,
+	Node** nodes,
+	size_t node_count,
+	size_t depth
+);
+
+
+extern void
+GraphPipeline_destroy(
+	GraphPipeline* self
+);
+
+
+/*
+ * Release the slot read during the previous frame, then wait for the next
+ * slot to be filled and latch the source outputs to it.
+ */
+
+extern void
+GraphPipeline_acquire(
+	GraphPipeline* self
+);
+
+
+/*
+ * Update durations of the sources, for the slot currently read
+ */
+
+extern const real_t*
+GraphPipeline_update_times(
+	const GraphPipeline* self
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PESTACLE_GRAPH_PIPELINE_H */
@@ -7,10 +7,16 @@ extern "C" {
 
 #include <SDL.h>
 #include <pestacle/math/average.h>
+#include <pestacle/math/histogram.h>
+#include <pestacle/trace.h>
+#include <pestacle/perf_counters.h>
+#include <pestacle/thread_pool.h>
 
 
 typedef struct {
 	AverageResult time;
+	Histogram time_histogram;
+	PerfCounterValues counters; // Sums over the updates
 } NodeProfile;
 
 
@@ -21,11 +27,30 @@ NodeProfile_update(
 );
 
 
+/*
+ * Accumulate the counts of one update, from the counters read before and
+ * after it
+ */
+
+extern void
+NodeProfile_update_counters(
+	NodeProfile* self,
+	const PerfCounterValues* start_values,
+	const PerfCounterValues* end_values
+);
+
+
 struct s_Graph;
 
 typedef struct {
 	AverageResult time;
+	Histogram time_histogram;
 	NodeProfile* node_profiles;
+	Trace* trace;                // Timeline of the node updates, 0 if none
+	PerfCounters* perf_counters; // Counters read around the node updates, 0 if none
+	ThreadPool* counted_thread_pool; // Pool whose workers are counted, 0 if none
+	real_t frame_period;             // Budget of a graph update in seconds, 0 if none
+	size_t over_frame_period_count;  // Graph updates longer than frame_period
 } GraphProfile;
 
 
@@ -42,6 +67,49 @@ GraphProfile_destroy(
 );
 
 
+/*
+ * Record the updates of each node to a trace, in addition to their times
+ */
+
+extern void
+GraphProfile_set_trace(
+	GraphProfile* self,
+	Trace* trace
+);
+
+
+/*
+ * Count the graph updates longer than frame_period seconds
+ */
+
+extern void
+GraphProfile_set_frame_period(
+	GraphProfile* self,
+	real_t frame_period
+);
+
+
+/*
+ * Read hardware performance counters around the update of each node. The
+ * counts include the worker threads of the graph's thread pool, thus the
+ * nodes of a level are then updated one after the other, each still
+ * spreading its own work over the pool.
+ */
+
+extern void
+GraphProfile_set_perf_counters(
+	GraphProfile* self,
+	PerfCounters* perf_counters
+);
+
+
+/*
+ * Print the mean, standard deviation and percentiles of the update times of
+ * each node and of the whole graph, and the number of graph updates longer
+ * than the frame period, if set. With performance counters, also print the
+ * instructions per cycle and the misses per output pixel of each node.
+ */
+
 extern void
 GraphProfile_print_report(
 	GraphProfile* self,
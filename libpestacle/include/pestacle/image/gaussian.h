@@ -15,10 +15,35 @@ enum GaussianFilterMode {
 }; // enum GaussianFilterMode
 
 
+/*
+ * CONVOLUTION : convolution with a kernel of 6 * floor(sigma) + 1 taps
+ * RECURSIVE   : Young - van Vliet recursive filter, with a cost independent
+ *               of sigma. Requires sigma >= 0.5. The boundaries are handled
+ *               as in Triggs - Sdika, the MIRROR mode mirroring 3 sigma
+ *               values on each side.
+ */
+
+enum GaussianFilterMethod {
+	GaussianFilterMethod__CONVOLUTION,
+	GaussianFilterMethod__RECURSIVE
+}; // enum GaussianFilterMethod
+
+
 typedef struct {
 	Matrix U;
-	Vector kernel;
 	enum GaussianFilterMode mode;
+	enum GaussianFilterMethod method;
+
+	// Convolution method
+	Vector kernel;
+
+	// Recursive method : y[n] = B x[n] + a1 y[n-1] + a2 y[n-2] + a3 y[n-3]
+	double coeffs[4];
+	double boundary_matrix[9];
+	size_t row_padding_len;
+	size_t col_padding_len;
+	Matrix row_padding;
+	Matrix col_padding;
 } GaussianFilter;
 
 
@@ -29,7 +54,8 @@ GaussianFilter_init(
 	size_t row_count,
 	size_t col_count,
 	real_t sigma,
-	enum GaussianFilterMode mode
+	enum GaussianFilterMode mode,
+	enum GaussianFilterMethod method
 );
 
 
@@ -46,6 +72,20 @@ GaussianFilter_transform(
 );
 
 
+/*
+ * Same as GaussianFilter_transform, the rows and columns being split among
+ * the threads of the pool
+ *   thread_pool : the thread pool, 0 to run on the calling thread only
+ */
+
+extern void
+GaussianFilter_parallel_transform(
+	GaussianFilter* self,
+	Matrix* matrix,
+	ThreadPool* thread_pool
+);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -11,12 +11,48 @@ extern "C" {
 #include <pestacle/math/randomizer.h>
 
 
+/*
+ * Precision of the transcendental functions (exp, log, pow). The exact
+ * precision uses the C library, the fast precision uses the vectorised
+ * approximations of pestacle/math/fast_math.h. The default is exact.
+ */
+
+typedef enum {
+	ArrayOpsPrecision__exact,
+	ArrayOpsPrecision__fast
+} ArrayOpsPrecision;
+
+
+extern ArrayOpsPrecision
+array_ops_get_precision();
+
+
+extern void
+array_ops_set_precision(
+	ArrayOpsPrecision precision
+);
+
+
+/*
+ * Arrays are allocated on ARRAY_OPS_ALIGNMENT bytes boundaries, the size of a
+ * cache line and of the widest SIMD registers, and are released with
+ * array_ops_free
+ */
+
+#define ARRAY_OPS_ALIGNMENT 64
+
 extern real_t*
 array_ops_allocate(
 	size_t len
 );
 
 
+extern void
+array_ops_free(
+	real_t* array
+);
+
+
 extern void
 array_ops_print(
 	const real_t* src,
@@ -67,6 +103,22 @@ array_ops_copy(
 );
 
 
+/*
+ * Transposes a block of row_count rows of col_count values, the rows of src
+ * being src_stride values apart, and the rows of dst dst_stride values apart
+ */
+
+extern void
+array_ops_transpose(
+	real_t* dst,
+	const real_t* src,
+	size_t row_count,
+	size_t col_count,
+	size_t dst_stride,
+	size_t src_stride
+);
+
+
 extern void
 array_ops_set_gaussian_kernel(
 	real_t* dst,
@@ -110,6 +162,18 @@ array_ops_log(
 );
 
 
+/*
+ * x^exponent, for x >= 0
+ */
+
+extern void
+array_ops_pow(
+	real_t* dst,
+	size_t len,
+	real_t exponent
+);
+
+
 extern void
 array_ops_heaviside(
 	real_t* dst,
@@ -134,6 +198,40 @@ array_ops_scale(
 );
 
 
+/*
+ * Element-wise operations, to be chained in a program run by array_ops_run
+ */
+
+typedef enum {
+	ArrayOpCode__inc,       // x + arg
+	ArrayOpCode__scale,     // x * arg
+	ArrayOpCode__square,    // x * x
+	ArrayOpCode__exp,       // exp(x)
+	ArrayOpCode__heaviside  // 0 if x < arg, 1 otherwise
+} ArrayOpCode;
+
+
+typedef struct {
+	ArrayOpCode code;
+	real_t arg;
+} ArrayOp;
+
+
+/*
+ * Apply a sequence of element-wise operations, block by block, so that each
+ * block stays in cache for the whole sequence : the array is read and
+ * written once, whatever the number of operations.
+ */
+
+extern void
+array_ops_run(
+	real_t* dst,
+	size_t len,
+	const ArrayOp* ops,
+	size_t op_count
+);
+
+
 extern void
 array_ops_scaled_copy(
 	real_t* dst,
@@ -322,6 +420,40 @@ array_ops_strided_convolution__mirror(
 );
 
 
+
+/*
+ * Column-wise convolution of a block of block_len adjacent columns, len rows
+ * long, the rows of src being src_stride values apart, and the rows of dst
+ * dst_stride values apart. Each output row is accumulated
+ * with unit stride, with the same results as block_len calls to the strided
+ * convolutions.
+ */
+
+extern void
+array_ops_block_convolution__zero(
+	real_t* dst,
+	const real_t* src,
+	const real_t* kernel,
+	size_t len,
+	size_t kernel_len,
+	size_t block_len,
+	size_t dst_stride,
+	size_t src_stride
+);
+
+
+extern void
+array_ops_block_convolution__mirror(
+	real_t* dst,
+	const real_t* src,
+	const real_t* kernel,
+	size_t len,
+	size_t kernel_len,
+	size_t block_len,
+	size_t dst_stride,
+	size_t src_stride
+);
+
 extern void
 array_ops_box_filter(
 	real_t* dst,
@@ -331,6 +463,59 @@ array_ops_box_filter(
 );
 
 
+/*
+ * Column-wise box filter of a block of at most 128 adjacent columns, len
+ * rows long, the rows of src and dst being src_stride and dst_stride values
+ * apart. Gives the same results as array_ops_box_filter on each column.
+ */
+
+extern void
+array_ops_block_box_filter(
+	real_t* dst,
+	const real_t* src,
+	size_t len,
+	size_t filter_size,
+	size_t block_len,
+	size_t dst_stride,
+	size_t src_stride
+);
+
+
+/*
+ * Number of values of the buffer of array_ops_block_iterated_box_filter
+ */
+
+extern size_t
+array_ops_iterated_box_filter_buffer_len(
+	const size_t* filter_sizes,
+	size_t pass_count,
+	size_t block_len
+);
+
+
+/*
+ * Successive box filters of sizes filter_sizes, on a block of at most 128
+ * adjacent columns, len rows long, the rows of src and dst being src_stride
+ * and dst_stride values apart. The passes are fused in a single traversal,
+ * each pass keeping its last inputs in a ring buffer, and the running sums
+ * are compensated, so that they do not drift along long columns. buffer is a
+ * scratch area of array_ops_iterated_box_filter_buffer_len values.
+ */
+
+extern void
+array_ops_block_iterated_box_filter(
+	real_t* dst,
+	const real_t* src,
+	size_t len,
+	const size_t* filter_sizes,
+	size_t pass_count,
+	size_t block_len,
+	size_t dst_stride,
+	size_t src_stride,
+	real_t* buffer
+);
+
+
 #ifdef __cplusplus
 }
 #endif
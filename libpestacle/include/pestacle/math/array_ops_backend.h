@@ -0,0 +1,115 @@
+#ifndef PESTACLE_MATH_ARRAY_OPS_BACKEND_H
+#define PESTACLE_MATH_ARRAY_OPS_BACKEND_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/******************************************************************************
+  Backends of the array_ops routines. The scalar backend is always available,
+  the SIMD backends are compiled in on the matching architecture and used if
+  the CPU supports them. The best backend is selected on first use, based on
+  the same CPU feature checks as the ones logged at startup.
+
+  The SIMD backends give the same results as the scalar backend for finite
+  values, except for the sums, which are computed in a different order. The
+  fast_* kernels compute the approximations of pestacle/math/fast_math.h.
+
+  box_filter_step advances len running sums of a box filter by one step : it
+  adds head - tail to sum with the Kahan-Neumaier compensation comp, writes
+  (sum + comp) / filter_size to dst, and copies head to tail.
+ *****************************************************************************/
+
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <pestacle/math/real.h>
+
+
+typedef struct {
+	void (*fill)(real_t* dst, size_t len, real_t value);
+	void (*copy)(real_t* dst, const real_t* src, size_t len);
+	void (*transpose)(real_t* dst, const real_t* src, size_t row_count, size_t col_count, size_t dst_stride, size_t src_stride);
+	void (*heaviside)(real_t* dst, size_t len, real_t threshold);
+	void (*inc)(real_t* dst, size_t len, real_t shift);
+	void (*scale)(real_t* dst, size_t len, real_t factor);
+	void (*scaled_copy)(real_t* dst, const real_t* src, size_t len, real_t factor);
+	real_t (*reduction_min)(const real_t* src, size_t len);
+	real_t (*reduction_max)(const real_t* src, size_t len);
+	real_t (*reduction_sum)(const real_t* src, size_t len);
+	real_t (*reduction_square_sum)(const real_t* src, size_t len);
+	void (*add)(real_t* dst, const real_t* src, size_t len);
+	void (*sub)(real_t* dst, const real_t* src, size_t len);
+	void (*scaled_add)(real_t* dst, const real_t* src, size_t len, real_t factor);
+	void (*mul)(real_t* dst, const real_t* src, size_t len);
+	void (*div)(real_t* dst, const real_t* src, size_t len);
+	void (*min)(real_t* dst, const real_t* src, size_t len);
+	void (*scaled_min)(real_t* dst, const real_t* src, size_t len, real_t factor);
+	void (*max)(real_t* dst, const real_t* src, size_t len);
+	void (*scaled_max)(real_t* dst, const real_t* src, size_t len, real_t factor);
+	void (*box_filter_step)(real_t* dst, real_t* sum, real_t* comp, real_t* tail, const real_t* head, size_t len, real_t filter_size);
+	void (*square_root)(real_t* dst, size_t len);
+	void (*fast_exp)(real_t* dst, size_t len);
+	void (*fast_log)(real_t* dst, size_t len);
+	void (*fast_pow)(real_t* dst, size_t len, real_t exponent);
+} ArrayOpsKernels;
+
+
+typedef struct {
+	const char* name;
+	bool (*is_supported)();
+	ArrayOpsKernels kernels;
+} ArrayOpsBackend;
+
+
+extern const ArrayOpsBackend array_ops_scalar_backend;
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ARRAY_OPS_HAS_X86_BACKENDS
+extern const ArrayOpsBackend array_ops_sse41_backend;
+extern const ArrayOpsBackend array_ops_avx2_backend;
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define ARRAY_OPS_HAS_NEON_BACKEND
+extern const ArrayOpsBackend array_ops_neon_backend;
+#endif
+
+
+/*
+ * Returns the backends compiled in, the scalar one first, 0 terminated
+ */
+
+extern const ArrayOpsBackend* const*
+array_ops_list_backends();
+
+
+/*
+ * Returns the fastest backend supported by the CPU
+ */
+
+extern const ArrayOpsBackend*
+array_ops_best_backend();
+
+
+extern const ArrayOpsBackend*
+array_ops_get_backend();
+
+
+/*
+ * Select the backend used by the array_ops routines. The backend has to be
+ * supported by the CPU.
+ */
+
+extern void
+array_ops_set_backend(
+	const ArrayOpsBackend* backend
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PESTACLE_MATH_ARRAY_OPS_BACKEND_H */
@@ -0,0 +1,86 @@
+#ifndef PESTACLE_MATH_FAST_MATH_H
+#define PESTACLE_MATH_FAST_MATH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/******************************************************************************
+  Fast approximations of exp, log and pow, after the Cephes single precision
+  routines. They only use additions, multiplications, comparisons and bit
+  manipulations, and are vectorised by the SIMD backends of array_ops, which
+  give the same results as the scalar functions below.
+
+  Maximum errors, measured against the correctly rounded results :
+    fast_exp : 1 ULP, for x in [-87.3, 88.3]
+    fast_log : 1 ULP, for x in [FLT_MIN, FLT_MAX]
+    fast_pow : 5 ULP, for |y log(x)| <= 4, the error grows with |y log(x)|
+ *****************************************************************************/
+
+
+#include <pestacle/math/real.h>
+
+
+// Clamping bounds of fast_exp : 0 below, +inf above
+#define FAST_MATH_EXP_LO ((real_t)-87.33654475f)
+#define FAST_MATH_EXP_HI ((real_t)88.37626266f)
+
+// ln(2) split in two parts, for an exact range reduction
+#define FAST_MATH_LN2_HI ((real_t)0.693359375f)
+#define FAST_MATH_LN2_LO ((real_t)-2.12194440e-4f)
+
+#define FAST_MATH_LOG2E  ((real_t)1.44269504088896341f)
+#define FAST_MATH_SQRTHF ((real_t)0.707106781186547524f)
+
+// Polynomial approximation of (exp(r) - 1 - r) / r^2 on [-ln(2) / 2, ln(2) / 2]
+#define FAST_MATH_EXP_P0 ((real_t)1.9875691500e-4f)
+#define FAST_MATH_EXP_P1 ((real_t)1.3981999507e-3f)
+#define FAST_MATH_EXP_P2 ((real_t)8.3334519073e-3f)
+#define FAST_MATH_EXP_P3 ((real_t)4.1665795894e-2f)
+#define FAST_MATH_EXP_P4 ((real_t)1.6666665459e-1f)
+#define FAST_MATH_EXP_P5 ((real_t)5.0000001201e-1f)
+
+// Polynomial approximation of (log(1 + m) - m + m^2 / 2) / m^3 on
+// [sqrt(1/2) - 1, sqrt(2) - 1]
+#define FAST_MATH_LOG_P0 ((real_t)7.0376836292e-2f)
+#define FAST_MATH_LOG_P1 ((real_t)-1.1514610310e-1f)
+#define FAST_MATH_LOG_P2 ((real_t)1.1676998740e-1f)
+#define FAST_MATH_LOG_P3 ((real_t)-1.2420140846e-1f)
+#define FAST_MATH_LOG_P4 ((real_t)1.4249322787e-1f)
+#define FAST_MATH_LOG_P5 ((real_t)-1.6668057665e-1f)
+#define FAST_MATH_LOG_P6 ((real_t)2.0000714765e-1f)
+#define FAST_MATH_LOG_P7 ((real_t)-2.4999993993e-1f)
+#define FAST_MATH_LOG_P8 ((real_t)3.3333331174e-1f)
+
+
+/*
+ * Results below FLT_MIN are flushed to zero, NaN gives NaN
+ */
+
+extern real_t
+fast_exp(real_t x);
+
+
+/*
+ * Inputs below FLT_MIN are handled as FLT_MIN, 0 gives -inf, negative values
+ * and NaN give NaN
+ */
+
+extern real_t
+fast_log(real_t x);
+
+
+/*
+ * exp(y log(x)), for x >= 0 and y != 0
+ */
+
+extern real_t
+fast_pow(real_t x, real_t y);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PESTACLE_MATH_FAST_MATH_H */
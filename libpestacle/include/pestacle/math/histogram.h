@@ -0,0 +1,100 @@
+#ifndef PESTACLE_MATH_HISTOGRAM_H
+#define PESTACLE_MATH_HISTOGRAM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pestacle/math/real.h>
+
+
+/*
+ * Log-bucketed histogram of durations, in the manner of HdrHistogram. The
+ * durations are counted in nanoseconds, each power of two range being split
+ * in HISTOGRAM_SUB_BUCKET_COUNT / 2 buckets, so that the percentiles are
+ * known within 1 / 32 of their value, with a fixed memory footprint.
+ * Durations above HISTOGRAM_MAX_DURATION fall in the last bucket.
+ */
+
+
+#define HISTOGRAM_SUB_BUCKET_BITS 6
+#define HISTOGRAM_SUB_BUCKET_COUNT (1 << HISTOGRAM_SUB_BUCKET_BITS)
+#define HISTOGRAM_MAX_BITS 40
+#define HISTOGRAM_BUCKET_COUNT \
+	((HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BUCKET_BITS + 2) * (HISTOGRAM_SUB_BUCKET_COUNT / 2))
+#define HISTOGRAM_MAX_DURATION ((real_t)(((uint64_t)1) << HISTOGRAM_MAX_BITS) * (real_t)1e-9)
+
+
+typedef struct {
+	uint64_t count;
+	uint64_t max;
+	uint64_t bucket_counts[HISTOGRAM_BUCKET_COUNT];
+} Histogram;
+
+
+extern void
+Histogram_init(
+	Histogram* self
+);
+
+
+/*
+ * Record a duration, in seconds
+ */
+
+extern void
+Histogram_accumulate(
+	Histogram* self,
+	real_t x
+);
+
+
+extern size_t
+Histogram_count(
+	const Histogram* self
+);
+
+
+/*
+ * Returns the largest duration recorded, in seconds
+ */
+
+extern real_t
+Histogram_max(
+	const Histogram* self
+);
+
+
+/*
+ * Returns the duration, in seconds, below which lie a fraction p of the
+ * recorded durations, p being in [0, 1]. It is the upper bound of the bucket
+ * holding that duration, or the largest duration recorded if smaller, 0 if
+ * the histogram is empty.
+ */
+
+extern real_t
+Histogram_percentile(
+	const Histogram* self,
+	real_t p
+);
+
+
+/*
+ * Returns the number of recorded durations above x seconds, up to the
+ * precision of the buckets
+ */
+
+extern size_t
+Histogram_count_above(
+	const Histogram* self,
+	real_t x
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PESTACLE_MATH_HISTOGRAM_H */
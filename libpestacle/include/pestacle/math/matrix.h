@@ -7,17 +7,25 @@ extern "C" {
 
 
 #include <pestacle/math/vector.h>
+#include <pestacle/thread_pool.h>
 
-// row major matrix
+// row major matrix, the rows being row_stride values apart, data_len being the
+// number of coefficients
 
 typedef struct {
 	size_t row_count;
 	size_t col_count;
+	size_t row_stride;
 	size_t data_len;
 	real_t* data;
 } Matrix;
 
 
+/*
+ * The storage is aligned on ARRAY_OPS_ALIGNMENT bytes. Matrix_init packs the
+ * rows, Matrix_init_padded pads them so that each row is aligned as well.
+ */
+
 extern void
 Matrix_init(
 	Matrix* self,
@@ -26,12 +34,48 @@ Matrix_init(
 );
 
 
+extern void
+Matrix_init_padded(
+	Matrix* self,
+	size_t row_count,
+	size_t col_count
+);
+
+
+/*
+ * Initialize a matrix referencing a block of another matrix, without copy :
+ * the view has the row stride of the other matrix and shares its storage. It
+ * is valid as long as the storage of the other matrix is, and must not be
+ * destroyed.
+ */
+
+extern void
+Matrix_init_view(
+	Matrix* self,
+	const Matrix* other,
+	size_t row,
+	size_t col,
+	size_t row_count,
+	size_t col_count
+);
+
+
 extern void
 Matrix_destroy(
 	Matrix* self
 );
 
 
+/*
+ * True if the rows are packed, without padding between them
+ */
+
+extern bool
+Matrix_is_contiguous(
+	const Matrix* self
+);
+
+
 extern void
 Matrix_print(
 	const Matrix* self,
@@ -78,6 +122,14 @@ Matrix_transpose(
 );
 
 
+extern void
+Matrix_parallel_transpose(
+	Matrix* self,
+	const Matrix* other,
+	ThreadPool* thread_pool
+);
+
+
 extern void
 Matrix_fill(
 	Matrix* self,
@@ -129,6 +181,27 @@ Matrix_heaviside(
 );
 
 
+/*
+ * Apply a sequence of element-wise operations, see array_ops_run
+ */
+
+extern void
+Matrix_run(
+	Matrix* self,
+	const ArrayOp* ops,
+	size_t op_count
+);
+
+
+extern void
+Matrix_parallel_run(
+	Matrix* self,
+	const ArrayOp* ops,
+	size_t op_count,
+	ThreadPool* thread_pool
+);
+
+
 extern real_t
 Matrix_reduction_min(
 	const Matrix* self
@@ -301,6 +374,118 @@ Matrix_rowwise_box_filter(
 );
 
 
+extern void
+Matrix_colwise_box_filter(
+	Matrix* self,
+	const Matrix* other,
+	size_t filter_size
+);
+
+
+/*
+ * Applies pass_count box filters in a row, of sizes filter_sizes, in a single
+ * traversal of the matrix, with compensated running sums. Up to the rounding
+ * errors, same as successive calls to the box filter above.
+ */
+
+extern void
+Matrix_rowwise_iterated_box_filter(
+	Matrix* self,
+	const Matrix* other,
+	const size_t* filter_sizes,
+	size_t pass_count
+);
+
+
+extern void
+Matrix_colwise_iterated_box_filter(
+	Matrix* self,
+	const Matrix* other,
+	const size_t* filter_sizes,
+	size_t pass_count
+);
+
+
+/*
+ * Parallel versions of the filters : the rows (the columns for the column-wise
+ * filters) are split among the threads of the pool.
+ *   thread_pool : the thread pool, 0 to run on the calling thread only
+ */
+
+extern void
+Matrix_parallel_rowwise_convolution__zero(
+	Matrix* self,
+	const Matrix* other,
+	const Vector* kernel,
+	ThreadPool* thread_pool
+);
+
+
+extern void
+Matrix_parallel_colwise_convolution__zero(
+	Matrix* self,
+	const Matrix* other,
+	const Vector* kernel,
+	ThreadPool* thread_pool
+);
+
+
+extern void
+Matrix_parallel_rowwise_convolution__mirror(
+	Matrix* self,
+	const Matrix* other,
+	const Vector* kernel,
+	ThreadPool* thread_pool
+);
+
+
+extern void
+Matrix_parallel_colwise_convolution__mirror(
+	Matrix* self,
+	const Matrix* other,
+	const Vector* kernel,
+	ThreadPool* thread_pool
+);
+
+
+extern void
+Matrix_parallel_rowwise_box_filter(
+	Matrix* self,
+	const Matrix* other,
+	size_t filter_size,
+	ThreadPool* thread_pool
+);
+
+
+extern void
+Matrix_parallel_colwise_box_filter(
+	Matrix* self,
+	const Matrix* other,
+	size_t filter_size,
+	ThreadPool* thread_pool
+);
+
+
+extern void
+Matrix_parallel_rowwise_iterated_box_filter(
+	Matrix* self,
+	const Matrix* other,
+	const size_t* filter_sizes,
+	size_t pass_count,
+	ThreadPool* thread_pool
+);
+
+
+extern void
+Matrix_parallel_colwise_iterated_box_filter(
+	Matrix* self,
+	const Matrix* other,
+	const size_t* filter_sizes,
+	size_t pass_count,
+	ThreadPool* thread_pool
+);
+
+
 #ifdef __cplusplus
 }
 #endif
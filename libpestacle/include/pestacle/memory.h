@@ -22,6 +22,24 @@ checked_calloc(
 );
 
 
+/*
+ * Allocates size bytes, aligned on alignment bytes, a power of 2. The memory
+ * has to be released with aligned_free.
+ */
+
+extern void*
+checked_aligned_malloc(
+	size_t size,
+	size_t alignment
+);
+
+
+extern void
+aligned_free(
+	void* ptr
+);
+
+
 #ifdef __cplusplus
 }
 #endif
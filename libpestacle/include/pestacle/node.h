@@ -11,6 +11,7 @@ extern "C" {
 #include <pestacle/string_list.h>
 #include <pestacle/data_type.h>
 #include <pestacle/parameter.h>
+#include <pestacle/thread_pool.h>
 #include <pestacle/math/matrix.h>
 
 
@@ -68,11 +69,20 @@ typedef struct {
 } NodeDelegateMethods;
 
 
+enum NodeDelegateFlag {
+	NodeDelegateFlag__none        = 0,
+	NodeDelegateFlag__main_thread = 1 << 0, // update must run on the main thread
+	NodeDelegateFlag__stateless   = 1 << 1, // output only depends on the inputs and parameters
+	NodeDelegateFlag__in_place    = 1 << 2  // update can overwrite the output of the first input
+}; // enum NodeDelegateFlag
+
+
 typedef struct {
 	const char* name;
 	const NodeInputDefinition* input_defs;
 	const ParameterDefinition* parameter_defs;
 	NodeDelegateMethods methods;
+	unsigned int flags; // combination of NodeDelegateFlag values
 } NodeDelegate;
 
 
@@ -88,6 +98,22 @@ struct s_Node {
 
 	Node** inputs;
 	ParameterValue* parameters;
+
+	Uint64 version;         // Incremented each time the output is updated
+	Uint64* input_versions; // Versions of the inputs at the last update
+
+	bool requests_output_buffer; // See Node_request_output_buffer
+	Matrix output_buffer;        // Output buffer provided by the graph
+	bool is_in_place;            // Output buffer is the one of the first input
+	bool is_view;                // See Node_request_output_view
+
+	ArrayOp* element_wise_ops;    // See Node_set_element_wise_ops
+	size_t element_wise_op_count;
+	Node* fusion_head;            // Node running the update of this one, 0 if none
+
+	ThreadPool* thread_pool; // Pool for data parallel updates, 0 if none
+
+	const NodeOutput* latched_output; // Output copy read by the other nodes, 0 if none
 }; // struct s_Node
 
 
@@ -97,6 +123,12 @@ NodeDelegate_has_inputs(
 );
 
 
+extern size_t
+NodeDelegate_input_count(
+	const NodeDelegate* self
+);
+
+
 /*
  * Creates a new node instance
  *   name : name of the instance, will make a copy of the string
@@ -192,6 +224,100 @@ Node_update(
 );
 
 
+/*
+ * Returns true if the output of a node has to be updated : a stateless node
+ * is outdated only if one of its inputs changed since its last update, a node
+ * without update method never is, any other node always is.
+ */
+
+extern bool
+Node_is_outdated(
+	const Node* self
+);
+
+
+/*
+ * Records that the output of a node was updated from its current inputs
+ */
+
+extern void
+Node_mark_updated(
+	Node* self
+);
+
+
+/*
+ * Request the graph to provide the output matrix of a node, to be called
+ * from the setup method once the output descriptor is set. The matrix is
+ * then available as self->output_buffer for the update and output methods,
+ * and may share its storage with the outputs of other nodes : the update
+ * method has to overwrite the whole matrix, and the node must not depend on
+ * the content of its output from one update to the next.
+ *
+ * A node flagged with NodeDelegateFlag__in_place may be given the output
+ * buffer of its first input, when it is the only reader of that input. Its
+ * is_in_place member is then set, and the update has to transform its output
+ * buffer directly instead of reading the first input.
+ */
+
+extern void
+Node_request_output_buffer(
+	Node* self
+);
+
+
+/*
+ * Declare that the output matrix of a node references a block of the output
+ * of its first input, to be called from the setup method instead of
+ * Node_request_output_buffer. The graph then keeps the storage of the first
+ * input alive for as long as the output of the node is read, and never lets
+ * another node write to it in place. The update method points
+ * self->output_buffer to the block with Matrix_init_view.
+ */
+
+extern void
+Node_request_output_view(
+	Node* self
+);
+
+
+/*
+ * Declare that the update of a node is a sequence of element-wise operations
+ * applied to its output buffer, to be called from the setup method. The
+ * update method fills the output buffer with its first input, unless the
+ * node runs in place, then calls Node_run_element_wise_ops.
+ *
+ * The operations of a chain of such nodes running in place are fused by the
+ * graph into the update of the first node of the chain, so that the frame is
+ * read and written once for the whole chain.
+ */
+
+extern void
+Node_set_element_wise_ops(
+	Node* self,
+	const ArrayOp* ops,
+	size_t op_count
+);
+
+
+extern void
+Node_run_element_wise_ops(
+	Node* self
+);
+
+
+/*
+ * Append the element-wise operations of a node to the ones of the node
+ * running its update
+ */
+
+extern void
+Node_fuse_element_wise_ops(
+	Node* self,
+	Node* other
+);
+
+
 extern NodeOutput
 Node_output(
 	Node* self
@@ -0,0 +1,111 @@
+#ifndef PESTACLE_PERF_COUNTERS_H
+#define PESTACLE_PERF_COUNTERS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/******************************************************************************
+  Hardware performance counters of a set of threads, read with
+  perf_event_open on Linux. Each thread added to the set gets its own group
+  of counters, and a read sums the counts of all the groups. The counts of a
+  group sharing the hardware with other events are scaled by the fraction of
+  time it was actually counting. The counters which cannot be opened, because
+  the kernel does not allow it or the CPU does not have them, read as 0. On
+  other platforms, no counter is available.
+ *****************************************************************************/
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <SDL_atomic.h>
+#include <SDL_thread.h>
+
+
+enum PerfCounter {
+	PerfCounter__cycles = 0,
+	PerfCounter__instructions,
+	PerfCounter__cache_misses, // Last level cache misses on most CPUs
+	PerfCounter__branch_misses,
+	PerfCounter__count
+}; // enum PerfCounter
+
+
+typedef struct {
+	uint64_t values[PerfCounter__count];
+	uint64_t time_enabled; // Nanoseconds, summed over the groups
+	uint64_t time_running; // Nanoseconds actually counting, 0 if no count
+} PerfCounterValues;
+
+
+typedef struct {
+	SDL_threadID thread_id;
+	int leader_fd;                  // -1 if no counter could be opened
+	int fds[PerfCounter__count];    // -1 if not available
+	size_t value_count;             // Number of counters in the group
+	size_t value_indices[PerfCounter__count];
+} PerfCounterGroup;
+
+
+#define PERF_COUNTERS_MAX_THREAD_COUNT 256
+
+typedef struct {
+	bool is_available[PerfCounter__count]; // On the thread calling init
+	SDL_SpinLock lock;
+	SDL_atomic_t group_count;
+	PerfCounterGroup groups[PERF_COUNTERS_MAX_THREAD_COUNT];
+} PerfCounters;
+
+
+/*
+ * Returns false, logging the reason, if no counter is available to the
+ * calling thread. The counters have to be destroyed in any case.
+ */
+
+extern bool
+PerfCounters_init(
+	PerfCounters* self
+);
+
+
+extern void
+PerfCounters_destroy(
+	PerfCounters* self
+);
+
+
+extern bool
+PerfCounters_is_available(
+	const PerfCounters* self,
+	enum PerfCounter counter
+);
+
+
+/*
+ * Add the calling thread to the counted threads, if not already
+ */
+
+extern void
+PerfCounters_add_thread(
+	PerfCounters* self
+);
+
+
+/*
+ * Read the counters summed over the counted threads, adding the calling
+ * thread to them. Any thread can read the counters.
+ */
+
+extern void
+PerfCounters_read(
+	PerfCounters* self,
+	PerfCounterValues* values
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PESTACLE_PERF_COUNTERS_H */
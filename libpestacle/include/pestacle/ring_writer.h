@@ -0,0 +1,175 @@
+#ifndef PESTACLE_RING_WRITER_H
+#define PESTACLE_RING_WRITER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/******************************************************************************
+  Writes items from a dedicated thread, through a ring of slots owned by the
+  caller. The pushing thread copies an item into a free slot, with a copy
+  callback, and the writer thread hands the filled slots, in order, to a
+  write callback. When all the slots are pending, a push either waits for a
+  free slot or drops the item. Destroying the writer waits for the pending
+  slots to be written.
+ *****************************************************************************/
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <SDL_atomic.h>
+#include <SDL_thread.h>
+#include <SDL_mutex.h>
+
+
+typedef enum {
+	RingWriterPolicy__block,   // Wait for a free slot
+	RingWriterPolicy__drop     // Drop the item when no slot is free
+} RingWriterPolicy;
+
+
+/*
+ * Copy an item to a slot, called from the pushing thread
+ */
+
+typedef void (*RingWriter__copy)(
+	void* caller,
+	void* slot,
+	const void* item
+);
+
+
+/*
+ * Write a slot, called from the writer thread. Returns false on failure.
+ */
+
+typedef bool (*RingWriter__write)(
+	void* caller,
+	void* slot
+);
+
+
+typedef struct {
+	RingWriterPolicy policy;
+	RingWriter__copy copy;
+	RingWriter__write write;
+	void* caller;
+
+	uint8_t* slots;     // Owned by the caller
+	size_t slot_count;
+	size_t slot_size;
+	bool* is_last;      // For each slot, true to stop the writer thread
+	size_t write_slot;
+	size_t read_slot;
+
+	SDL_atomic_t queued_count;
+	SDL_atomic_t written_count;
+	SDL_atomic_t failed_count;
+	SDL_atomic_t dropped_count;
+
+	SDL_sem* free_slots;
+	SDL_sem* ready_slots;
+	SDL_Thread* thread;
+} RingWriter;
+
+
+/*
+ * Initialize a writer over slot_count slots of slot_size bytes, and start
+ * its writer thread. The slots should remain valid until the writer is
+ * destroyed.
+ *
+ * Returns false if the writer thread could not be started
+ */
+
+extern bool
+RingWriter_init(
+	RingWriter* self,
+	void* slots,
+	size_t slot_count,
+	size_t slot_size,
+	RingWriterPolicy policy,
+	RingWriter__copy copy,
+	RingWriter__write write,
+	void* caller,
+	const char* thread_name
+);
+
+
+/*
+ * Wait until the pending slots are written, then stop the writer thread
+ */
+
+extern void
+RingWriter_destroy(
+	RingWriter* self
+);
+
+
+/*
+ * Copy an item to a free slot and queue it, or drop it if no slot is free
+ * and the policy allows it. Returns false if the item was dropped.
+ */
+
+extern bool
+RingWriter_push(
+	RingWriter* self,
+	const void* item
+);
+
+
+/*
+ * Wait until the pending slots are written
+ */
+
+extern void
+RingWriter_wait(
+	RingWriter* self
+);
+
+
+/*
+ * Number of items queued so far, a running total rather than the current
+ * depth of the queue
+ */
+
+extern size_t
+RingWriter_queued_count(
+	RingWriter* self
+);
+
+
+/*
+ * Number of items waiting to be written
+ */
+
+extern size_t
+RingWriter_pending_count(
+	RingWriter* self
+);
+
+
+extern size_t
+RingWriter_written_count(
+	RingWriter* self
+);
+
+
+extern size_t
+RingWriter_failed_count(
+	RingWriter* self
+);
+
+
+extern size_t
+RingWriter_dropped_count(
+	RingWriter* self
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PESTACLE_RING_WRITER_H */
@@ -0,0 +1,177 @@
+#ifndef PESTACLE_THREAD_POOL_H
+#define PESTACLE_THREAD_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/******************************************************************************
+  Persistent pool of worker threads, implementing a work stealing scheduler.
+  A job is a function processing a range of indices. Each thread owns a deque
+  of ranges : it splits the range it runs in halves, pushing the right halves
+  on its deque, which are stolen by the idle threads. The thread waiting for
+  a job to complete participates to its execution, thus a job can submit
+  other jobs, and threads outside of the pool can submit jobs.
+ *****************************************************************************/
+
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <SDL_atomic.h>
+#include <SDL_thread.h>
+#include <SDL_mutex.h>
+
+
+typedef void (*ThreadPoolJob)(
+	void* context,
+	size_t begin,
+	size_t end
+);
+
+
+typedef struct {
+	ThreadPoolJob job;
+	void* context;
+	size_t grain;
+	SDL_atomic_t pending_count; // Number of indices still to be processed
+} ThreadPoolTaskGroup;
+
+
+typedef struct {
+	ThreadPoolTaskGroup* group;
+	size_t begin;
+	size_t end;
+} ThreadPoolTask;
+
+
+#define THREAD_POOL_DEQUE_CAPACITY 256
+
+typedef struct {
+	SDL_SpinLock lock;
+	size_t top;    // Oldest task, the one stolen by other threads
+	size_t bottom; // Past the newest task, the one run by the owner
+	ThreadPoolTask tasks[THREAD_POOL_DEQUE_CAPACITY];
+} ThreadPoolDeque;
+
+
+struct s_ThreadPool;
+
+typedef struct {
+	struct s_ThreadPool* pool;
+	size_t index;
+	ThreadPoolDeque deque;
+} ThreadPoolWorker;
+
+
+struct s_ThreadPool {
+	size_t thread_count;
+	SDL_Thread** threads;
+
+	// One worker per thread, the last one being shared by the threads
+	// outside the pool
+	size_t worker_count;
+	ThreadPoolWorker* workers;
+
+	SDL_mutex* mutex;
+	SDL_cond* wake_up;
+	SDL_atomic_t queued_task_count;
+	SDL_atomic_t sleeping_thread_count;
+	SDL_atomic_t quit;
+}; // struct s_ThreadPool
+
+typedef struct s_ThreadPool ThreadPool;
+
+
+/*
+ * Initialize a thread pool
+ *   thread_count : number of worker threads, in addition to the caller thread
+ *
+ * Returns false if the threads could not be created
+ */
+
+extern bool
+ThreadPool_init(
+	ThreadPool* self,
+	size_t thread_count
+);
+
+
+extern void
+ThreadPool_destroy(
+	ThreadPool* self
+);
+
+
+/*
+ * Submit a job over the range [begin, end), returns immediately
+ *   self : the thread pool, if 0 the job is run immediately by the caller
+ *   group : tracks the completion of the job, must live until it completes
+ *   grain : the range is not split below that size
+ */
+
+extern void
+ThreadPool_submit(
+	ThreadPool* self,
+	ThreadPoolTaskGroup* group,
+	ThreadPoolJob job,
+	void* context,
+	size_t begin,
+	size_t end,
+	size_t grain
+);
+
+
+/*
+ * Run pending tasks until the job tracked by group is completed
+ */
+
+extern void
+ThreadPool_wait(
+	ThreadPool* self,
+	ThreadPoolTaskGroup* group
+);
+
+
+/*
+ * Submit a job over the range [begin, end) and wait for its completion
+ */
+
+extern void
+ThreadPool_parallel_for(
+	ThreadPool* self,
+	ThreadPoolJob job,
+	void* context,
+	size_t begin,
+	size_t end,
+	size_t grain
+);
+
+
+/*
+ * Number of workers of a pool, 1 if self is 0
+ */
+
+extern size_t
+ThreadPool_worker_count(
+	const ThreadPool* self
+);
+
+
+/*
+ * Index, below ThreadPool_worker_count, of the worker of the calling thread,
+ * 0 if self is 0. A worker runs one task at a time, unless the task waits for
+ * an other job. The threads outside of the pool share the last worker.
+ */
+
+extern size_t
+ThreadPool_worker_index(
+	ThreadPool* self
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PESTACLE_THREAD_POOL_H */
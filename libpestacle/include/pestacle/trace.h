@@ -0,0 +1,92 @@
+#ifndef PESTACLE_TRACE_H
+#define PESTACLE_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/******************************************************************************
+  Timeline of named time spans, saved in the Chrome trace event format read
+  by chrome://tracing and Perfetto. The spans are stored in a ring buffer
+  allocated up front, which any thread appends to without locking : a thread
+  reserves a slot with an atomic increment, and once the buffer is full the
+  newest spans overwrite the oldest ones. Each thread gets its own track.
+ *****************************************************************************/
+
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <SDL_atomic.h>
+#include <SDL_thread.h>
+
+
+typedef struct {
+	const char* name;
+	SDL_threadID thread_id;
+	Uint64 start_time;
+	Uint64 end_time;
+} TraceEvent;
+
+
+typedef struct {
+	SDL_atomic_t event_count; // Events recorded, including the overwritten ones
+	size_t capacity;          // Power of two
+	TraceEvent* events;
+	Uint64 start_time;
+	SDL_threadID main_thread_id;
+} Trace;
+
+
+#define TRACE_DEFAULT_CAPACITY (((size_t)1) << 18)
+
+
+/*
+ * Initialize a trace holding the last capacity events, capacity being
+ * rounded up to a power of two. The calling thread is named as the main one.
+ */
+
+extern void
+Trace_init(
+	Trace* self,
+	size_t capacity
+);
+
+
+extern void
+Trace_destroy(
+	Trace* self
+);
+
+
+/*
+ * Record a span, with times given by SDL_GetPerformanceCounter, on the track
+ * of the calling thread. The name is not copied, and has to stay valid until
+ * the trace is saved.
+ */
+
+extern void
+Trace_record(
+	Trace* self,
+	const char* name,
+	Uint64 start_time,
+	Uint64 end_time
+);
+
+
+/*
+ * Save the trace as JSON, to be called once no thread records anymore
+ */
+
+extern bool
+Trace_save(
+	const Trace* self,
+	const char* path
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PESTACLE_TRACE_H */
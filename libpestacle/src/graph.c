@@ -137,6 +137,105 @@ Graph_topological_sort(
 }
 
 
+static bool
+Node_is_main_thread_only(
+	const Node* self
+) {
+	return (self->delegate->flags & NodeDelegateFlag__main_thread) != 0;
+}
+
+
+static void
+Graph_compute_levels(
+	Graph* self
+) {
+	assert(self);
+	assert(self->sorted_nodes);
+
+	// Compute the level of each node : 0 for a node without inputs, otherwise
+	// one plus the highest level of its inputs
+	size_t* node_levels =
+		(size_t*)checked_malloc(self->sorted_node_count * sizeof(size_t));
+
+	TreeMap map;
+	TreeMap_init(&map);
+
+	self->level_count = 0;
+	for(size_t i = 0; i < self->sorted_node_count; ++i) {
+		Node* node = self->sorted_nodes[i];
+
+		size_t level = 0;
+		Node** input_ptr = node->inputs;
+		const NodeInputDefinition* input_def = node->delegate->input_defs;
+		for( ; !NodeInputDefinition_is_last(input_def); ++input_ptr, ++input_def) {
+			if (*input_ptr != 0) {
+				TreeMapNode* it = TreeMap_find(&map, *input_ptr);
+				assert(it);
+
+				size_t input_level = *((size_t*)it->value);
+				if (level < input_level + 1)
+					level = input_level + 1;
+			}
+		}
+
+		node_levels[i] = level;
+		TreeMap_insert(&map, node)->value = node_levels + i;
+
+		if (self->level_count < level + 1)
+			self->level_count = level + 1;
+	}
+
+	// Count the nodes of each level
+	self->levels =
+		(GraphLevel*)checked_calloc(self->level_count, sizeof(GraphLevel));
+
+	for(size_t i = 0; i < self->sorted_node_count; ++i) {
+		GraphLevel* level = self->levels + node_levels[i];
+
+		level->count += 1;
+		if (Node_is_main_thread_only(self->sorted_nodes[i]))
+			level->main_thread_count += 1;
+	}
+
+	for(size_t i = 1; i < self->level_count; ++i)
+		self->levels[i].start = self->levels[i - 1].start + self->levels[i - 1].count;
+
+	// Sort the nodes by level, keeping the topological order within a level
+	size_t* main_thread_pos =
+		(size_t*)checked_malloc(self->level_count * sizeof(size_t));
+
+	size_t* worker_pos =
+		(size_t*)checked_malloc(self->level_count * sizeof(size_t));
+
+	for(size_t i = 0; i < self->level_count; ++i) {
+		main_thread_pos[i] = self->levels[i].start;
+		worker_pos[i] = self->levels[i].start + self->levels[i].main_thread_count;
+	}
+
+	Node** sorted_nodes =
+		(Node**)checked_malloc(self->sorted_node_count * sizeof(Node*));
+
+	for(size_t i = 0; i < self->sorted_node_count; ++i) {
+		Node* node = self->sorted_nodes[i];
+		size_t level = node_levels[i];
+
+		if (Node_is_main_thread_only(node))
+			sorted_nodes[main_thread_pos[level]++] = node;
+		else
+			sorted_nodes[worker_pos[level]++] = node;
+	}
+
+	free(self->sorted_nodes);
+	self->sorted_nodes = sorted_nodes;
+
+	// Job done
+	free(worker_pos);
+	free(main_thread_pos);
+	free(node_levels);
+	TreeMap_destroy(&map);
+}
+
+
 bool
 Graph_init(
 	Graph* self,
@@ -147,6 +246,11 @@ Graph_init(
 	// Initialize members
 	self->sorted_node_count = 0;
 	self->sorted_nodes = 0;
+	self->level_count = 0;
+	self->levels = 0;
+	self->thread_pool = 0;
+	self->pipeline = 0;
+	self->memory_plan = 0;
 
 	// Sort the nodes
 	if (!Graph_topological_sort(self, scope))
@@ -156,6 +260,9 @@ Graph_init(
 	if (!Graph_check_graph_is_complete(self))
 		goto failure;
 
+	// Group the nodes by dependency levels
+	Graph_compute_levels(self);
+
 	// Job done
 	return true;
 
@@ -171,6 +278,18 @@ Graph_destroy(
 ) {
 	assert(self);
 
+	if (self->pipeline) {
+		GraphPipeline_destroy(self->pipeline);
+		free(self->pipeline);
+		self->pipeline = 0;
+	}
+
+	if (self->memory_plan) {
+		GraphMemoryPlan_destroy(self->memory_plan);
+		free(self->memory_plan);
+		self->memory_plan = 0;
+	}
+
 	if (self->sorted_nodes) {
 		free(self->sorted_nodes);
 
@@ -179,6 +298,93 @@ Graph_destroy(
 		self->sorted_nodes = 0;
 		#endif
 	}
+
+	if (self->levels) {
+		free(self->levels);
+
+		#ifdef DEBUG
+		self->level_count = 0;
+		self->levels = 0;
+		#endif
+	}
+}
+
+
+void
+Graph_set_thread_pool(
+	Graph* self,
+	ThreadPool* thread_pool
+) {
+	assert(self);
+
+	self->thread_pool = thread_pool;
+
+	// The nodes use the same pool for their data parallel updates
+	Node** node_ptr = self->sorted_nodes;
+	for(size_t i = self->sorted_node_count; i != 0; --i, ++node_ptr)
+		(*node_ptr)->thread_pool = thread_pool;
+}
+
+
+bool
+Graph_set_pipeline_depth(
+	Graph* self,
+	size_t depth
+) {
+	assert(self);
+
+	// Stop the current pipeline
+	if (self->pipeline) {
+		GraphPipeline_destroy(self->pipeline);
+		free(self->pipeline);
+		self->pipeline = 0;
+	}
+
+	if (depth == 0)
+		return true;
+
+	// Start a new one
+	GraphPipeline* pipeline = (GraphPipeline*)checked_malloc(sizeof(GraphPipeline));
+	if (!GraphPipeline_init(pipeline, self->sorted_nodes, self->sorted_node_count, depth)) {
+		free(pipeline);
+		return false;
+	}
+
+	self->pipeline = pipeline;
+	return true;
+}
+
+
+static void
+Graph_fuse_element_wise_nodes(
+	Graph* self
+) {
+	// A node running in place is the only reader of its first input, and is
+	// updated at most when that input is : if both are element-wise, the
+	// node can be updated along with its input
+	size_t fused_count = 0;
+	Node** node_ptr = self->sorted_nodes;
+	for(size_t i = self->sorted_node_count; i != 0; --i, ++node_ptr) {
+		Node* node = *node_ptr;
+		if ((!node->is_in_place) || (!node->element_wise_op_count))
+			continue;
+
+		if (NodeDelegate_input_count(node->delegate) != 1)
+			continue;
+
+		Node* input = node->inputs[0];
+		if (!input->element_wise_op_count)
+			continue;
+
+		if (input->fusion_head)
+			input = input->fusion_head;
+
+		Node_fuse_element_wise_ops(input, node);
+		fused_count += 1;
+	}
+
+	if (fused_count > 0)
+		SDL_Log("%zu element-wise node(s) fused", fused_count);
 }
 
 
@@ -221,22 +427,294 @@ Graph_setup(
 		free(full_delegate_path_str);
 	}
 
+	// Provide the requested output buffers
+	self->memory_plan = (GraphMemoryPlan*)checked_malloc(sizeof(GraphMemoryPlan));
+	GraphMemoryPlan_init(self->memory_plan, self);
+
+	// Fuse the chains of element-wise nodes
+	Graph_fuse_element_wise_nodes(self);
+
 	// Job done
 	StringList_destroy(&str_list);
 	return true;
 }
 
 
+static bool
+Graph_node_needs_update(
+	const Node* node
+) {
+	// Pipelined sources are updated by the pipeline thread, and nodes whose
+	// output would not change are skipped
+	return (!node->latched_output) && Node_is_outdated(node);
+}
+
+
+static void
+Graph_update_node(
+	Node* node
+) {
+	if (Graph_node_needs_update(node)) {
+		Node_update(node);
+		Node_mark_updated(node);
+	}
+}
+
+
+static void
+Graph_update_node_job(
+	void* context,
+	size_t begin,
+	size_t end
+) {
+	Node** nodes = (Node**)context;
+
+	for(size_t i = begin; i < end; ++i)
+		Graph_update_node(nodes[i]);
+}
+
+
+static void
+Graph_update_parallel(
+	Graph* self
+) {
+	assert(self);
+	assert(self->thread_pool);
+
+	// Update the levels one after the other
+	const GraphLevel* level = self->levels;
+	for(size_t i = self->level_count; i != 0; --i, ++level) {
+		Node** node_ptr = self->sorted_nodes + level->start;
+
+		// The worker threads update the nodes that can run on any thread...
+		ThreadPoolTaskGroup group;
+		ThreadPool_submit(
+			self->thread_pool,
+			&group,
+			Graph_update_node_job,
+			node_ptr,
+			level->main_thread_count,
+			level->count,
+			1
+		);
+
+		// ... while this thread updates the nodes bound to the main thread
+		for(size_t j = level->main_thread_count; j != 0; --j, ++node_ptr)
+			Graph_update_node(*node_ptr);
+
+		ThreadPool_wait(self->thread_pool, &group);
+	}
+}
+
+
 void
 Graph_update(
 	Graph* self
 ) {
 	assert(self);
 
+	// Switch to the next outputs of the pipelined sources
+	if (self->pipeline)
+		GraphPipeline_acquire(self->pipeline);
+
+	if (self->thread_pool) {
+		Graph_update_parallel(self);
+		return;
+	}
+
 	// Update the nodes in topological order
 	Node** node_ptr = self->sorted_nodes;
 	for(size_t i = self->sorted_node_count; i != 0; --i, ++node_ptr)
-		Node_update(*node_ptr);
+		Graph_update_node(*node_ptr);
+}
+
+
+static void
+Graph_update_node_with_profile(
+	Node* node,
+	NodeProfile* profile,
+	GraphProfile* graph_profile
+) {
+	if (!Graph_node_needs_update(node))
+		return;
+
+	// Update the node, reading the counters as close to it as possible
+	PerfCounterValues start_values, end_values;
+	if (graph_profile->perf_counters)
+		PerfCounters_read(graph_profile->perf_counters, &start_values);
+
+	Uint64 node_start_time = SDL_GetPerformanceCounter();
+	Node_update(node);
+	Uint64 node_end_time = SDL_GetPerformanceCounter();
+
+	if (graph_profile->perf_counters) {
+		PerfCounters_read(graph_profile->perf_counters, &end_values);
+		NodeProfile_update_counters(profile, &start_values, &end_values);
+	}
+
+	Node_mark_updated(node);
+
+	// Track the running time for that node
+	if (graph_profile->trace)
+		Trace_record(graph_profile->trace, node->name, node_start_time, node_end_time);
+
+	NodeProfile_update(
+		profile,
+		((real_t)(node_end_time - node_start_time)) / SDL_GetPerformanceFrequency()
+	);
+}
+
+
+typedef struct {
+	Node** nodes;
+	NodeProfile* profiles;
+	GraphProfile* graph_profile;
+} GraphProfileJobContext;
+
+
+static void
+Graph_update_node_with_profile_job(
+	void* context,
+	size_t begin,
+	size_t end
+) {
+	GraphProfileJobContext* job_context = (GraphProfileJobContext*)context;
+
+	for(size_t i = begin; i < end; ++i)
+		Graph_update_node_with_profile(
+			job_context->nodes[i],
+			job_context->profiles + i,
+			job_context->graph_profile
+		);
+}
+
+
+typedef struct {
+	PerfCounters* perf_counters;
+	ThreadPool* thread_pool;
+	bool* is_counted;         // For each worker thread of the pool
+	SDL_atomic_t started_count;
+	int task_count;
+} GraphCountWorkersJobContext;
+
+
+static void
+Graph_count_workers_job(
+	void* context,
+	size_t begin,
+	size_t end
+) {
+	GraphCountWorkersJobContext* job_context = (GraphCountWorkersJobContext*)context;
+	ThreadPool* thread_pool = job_context->thread_pool;
+
+	for(size_t i = begin; i < end; ++i) {
+		// Other threads outside of the pool might run the task, they are not
+		// counted
+		size_t index = ThreadPool_worker_index(thread_pool);
+		if (index < thread_pool->thread_count) {
+			PerfCounters_add_thread(job_context->perf_counters);
+			job_context->is_counted[index] = true;
+		}
+
+		// Hold the thread until all the tasks started, so that each task runs
+		// on its own thread
+		SDL_AtomicIncRef(&(job_context->started_count));
+		while(SDL_AtomicGet(&(job_context->started_count)) < job_context->task_count)
+			SDL_Delay(1);
+	}
+}
+
+
+// Add the worker threads of the pool to the threads counted by the profile
+static void
+Graph_count_workers(
+	Graph* self,
+	GraphProfile* profile
+) {
+	ThreadPool* thread_pool = self->thread_pool;
+
+	GraphCountWorkersJobContext job_context;
+	job_context.perf_counters = profile->perf_counters;
+	job_context.thread_pool = thread_pool;
+	job_context.is_counted = (bool*)checked_calloc(thread_pool->thread_count, sizeof(bool));
+	job_context.task_count = (int)ThreadPool_worker_count(thread_pool);
+
+	// One task per thread which can run them, until each worker got one
+	for(size_t i = 0; i < thread_pool->thread_count; ) {
+		if (job_context.is_counted[i]) {
+			++i;
+			continue;
+		}
+
+		SDL_AtomicSet(&(job_context.started_count), 0);
+		ThreadPool_parallel_for(
+			thread_pool,
+			Graph_count_workers_job,
+			&job_context,
+			0,
+			(size_t)job_context.task_count,
+			1
+		);
+	}
+
+	free(job_context.is_counted);
+	profile->counted_thread_pool = thread_pool;
+}
+
+
+static void
+Graph_update_parallel_with_profile(
+	Graph* self,
+	GraphProfile* profile
+) {
+	assert(self);
+	assert(self->thread_pool);
+
+	// The counters of a node sum the counts of all the threads during its
+	// update, thus the nodes of a level are updated one after the other
+	if (profile->perf_counters) {
+		if (profile->counted_thread_pool != self->thread_pool)
+			Graph_count_workers(self, profile);
+
+		Node** node_ptr = self->sorted_nodes;
+		NodeProfile* profile_ptr = profile->node_profiles;
+
+		for(size_t i = self->sorted_node_count; i != 0; --i, ++node_ptr, ++profile_ptr)
+			Graph_update_node_with_profile(*node_ptr, profile_ptr, profile);
+
+		return;
+	}
+
+	// Update the levels one after the other
+	const GraphLevel* level = self->levels;
+	for(size_t i = self->level_count; i != 0; --i, ++level) {
+		Node** node_ptr = self->sorted_nodes + level->start;
+		NodeProfile* profile_ptr = profile->node_profiles + level->start;
+
+		// The worker threads update the nodes that can run on any thread...
+		GraphProfileJobContext job_context = {
+			node_ptr,
+			profile_ptr,
+			profile
+		};
+
+		ThreadPoolTaskGroup group;
+		ThreadPool_submit(
+			self->thread_pool,
+			&group,
+			Graph_update_node_with_profile_job,
+			&job_context,
+			level->main_thread_count,
+			level->count,
+			1
+		);
+
+		// ... while this thread updates the nodes bound to the main thread
+		for(size_t j = level->main_thread_count; j != 0; --j, ++node_ptr, ++profile_ptr)
+			Graph_update_node_with_profile(*node_ptr, profile_ptr, profile);
+
+		ThreadPool_wait(self->thread_pool, &group);
+	}
 }
 
 
@@ -248,28 +726,41 @@ Graph_update_with_profile(
 	assert(self);
 	assert(profile);
 
-	// Update the nodes in topological order
-	Node** node_ptr = self->sorted_nodes;
-	NodeProfile* profile_ptr = profile->node_profiles;
-
 	Uint64 start_time = SDL_GetPerformanceCounter();
 
-	for(size_t i = self->sorted_node_count; i != 0; --i, ++node_ptr, ++profile_ptr) {
-		// Update the node
-		Uint64 node_start_time = SDL_GetPerformanceCounter();
-		Node_update(*node_ptr);
-		Uint64 node_end_time = SDL_GetPerformanceCounter();
+	// Switch to the next outputs of the pipelined sources, tracking the time
+	// they took to be updated
+	if (self->pipeline) {
+		GraphPipeline_acquire(self->pipeline);
+		if (profile->trace)
+			Trace_record(profile->trace, "pipeline acquire", start_time, SDL_GetPerformanceCounter());
+
+		const real_t* update_time = GraphPipeline_update_times(self->pipeline);
+		for(size_t i = 0; i < self->pipeline->source_count; ++i)
+			NodeProfile_update(
+				profile->node_profiles + self->pipeline->source_indices[i],
+				update_time[i]
+			);
+	}
+
+	if (self->thread_pool)
+		Graph_update_parallel_with_profile(self, profile);
+	else {
+		// Update the nodes in topological order
+		Node** node_ptr = self->sorted_nodes;
+		NodeProfile* profile_ptr = profile->node_profiles;
 
-		// Track the running time for that node
-		NodeProfile_update(
-			profile_ptr,
-			((real_t)(node_end_time - node_start_time)) / SDL_GetPerformanceFrequency()
-		);
+		for(size_t i = self->sorted_node_count; i != 0; --i, ++node_ptr, ++profile_ptr)
+			Graph_update_node_with_profile(*node_ptr, profile_ptr, profile);
 	}
 
 	Uint64 end_time = SDL_GetPerformanceCounter();
-	AverageResult_accumulate(
-		&(profile->time),
-		((real_t)(end_time - start_time)) / SDL_GetPerformanceFrequency()
-	);
+	real_t time_interval =
+		((real_t)(end_time - start_time)) / SDL_GetPerformanceFrequency();
+
+	AverageResult_accumulate(&(profile->time), time_interval);
+	Histogram_accumulate(&(profile->time_histogram), time_interval);
+
+	if ((profile->frame_period > 0) && (time_interval > profile->frame_period))
+		profile->over_frame_period_count += 1;
 }
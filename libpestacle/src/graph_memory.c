@@ -0,0 +1,287 @@
+#include <assert.h>
+#include <SDL_log.h>
+#include <pestacle/graph.h>
+#include <pestacle/memory.h>
+#include <pestacle/tree_map.h>
+#include <pestacle/graph_memory.h>
+#include <pestacle/math/array_ops.h>
+
+
+static bool
+GraphMemoryPlan_is_static_node(
+	const Node* node,
+	const bool* input_is_static
+) {
+	// A node without update method never changes, a stateless node does
+	// not change if its inputs do not
+	if (!node->delegate->methods.update)
+		return true;
+
+	if (!(node->delegate->flags & NodeDelegateFlag__stateless))
+		return false;
+
+	const Node* const* input_ptr = (const Node* const*)node->inputs;
+	const NodeInputDefinition* input_def = node->delegate->input_defs;
+	for(size_t i = 0; !NodeInputDefinition_is_last(input_def); ++i, ++input_ptr, ++input_def)
+		if ((*input_ptr) && (!input_is_static[i]))
+			return false;
+
+	return true;
+}
+
+
+static bool
+GraphMemoryPlan_can_run_in_place(
+	const Node* node,
+	const bool* input_is_static
+) {
+	// The first input has to use a planned buffer of the same size, and has
+	// to be updated each time the node is, as its output is overwritten. It
+	// is the case if the first input is not stateless, or if both are and
+	// the other inputs never change.
+	if (!(node->delegate->flags & NodeDelegateFlag__in_place))
+		return false;
+
+	if (!node->requests_output_buffer)
+		return false;
+
+	const Node* input = node->inputs[0];
+	if ((!input) || (!input->requests_output_buffer) || input_is_static[0])
+		return false;
+
+	if (input->output_buffer.data_len != node->output_buffer.data_len)
+		return false;
+
+	if (!(input->delegate->flags & NodeDelegateFlag__stateless))
+		return true;
+
+	if (!(node->delegate->flags & NodeDelegateFlag__stateless))
+		return false;
+
+	size_t input_count = NodeDelegate_input_count(node->delegate);
+	for(size_t i = 1; i < input_count; ++i)
+		if ((node->inputs[i]) && (!input_is_static[i]))
+			return false;
+
+	return true;
+}
+
+
+void
+GraphMemoryPlan_init(
+	GraphMemoryPlan* self,
+	Graph* graph
+) {
+	assert(self);
+	assert(graph);
+
+	size_t node_count = graph->sorted_node_count;
+
+	// Initialize members
+	self->buffer_count = 0;
+	self->request_count = 0;
+	self->requested_len = 0;
+	self->in_place_count = 0;
+	self->buffers = (real_t**)checked_malloc(node_count * sizeof(real_t*));
+	self->buffer_lens = (size_t*)checked_malloc(node_count * sizeof(size_t));
+
+	// Retrieve the level of each node
+	size_t* node_levels = (size_t*)checked_malloc(node_count * sizeof(size_t));
+	for(size_t i = 0; i < graph->level_count; ++i) {
+		const GraphLevel* level = graph->levels + i;
+		for(size_t j = 0; j < level->count; ++j)
+			node_levels[level->start + j] = i;
+	}
+
+	// Compute the last level at which each output is read, and which nodes
+	// are static
+	size_t* last_levels = (size_t*)checked_malloc(node_count * sizeof(size_t));
+	bool* is_static = (bool*)checked_malloc(node_count * sizeof(bool));
+	size_t* read_counts = (size_t*)checked_calloc(node_count, sizeof(size_t));
+	size_t* in_place_inputs = (size_t*)checked_malloc(node_count * sizeof(size_t));
+	size_t* node_indices = (size_t*)checked_malloc(node_count * sizeof(size_t));
+	bool* input_is_static = 0;
+	size_t input_capacity = 0;
+
+	TreeMap map;
+	TreeMap_init(&map);
+
+	for(size_t i = 0; i < node_count; ++i) {
+		Node* node = graph->sorted_nodes[i];
+
+		last_levels[i] = node_levels[i];
+		in_place_inputs[i] = ~((size_t)0);
+		node_indices[i] = i;
+		TreeMap_insert(&map, node)->value = node_indices + i;
+
+		if (!NodeDelegate_has_inputs(node->delegate)) {
+			is_static[i] = GraphMemoryPlan_is_static_node(node, 0);
+			continue;
+		}
+
+		size_t input_count = NodeDelegate_input_count(node->delegate);
+		if (input_capacity < input_count) {
+			free(input_is_static);
+			input_capacity = input_count;
+			input_is_static = (bool*)checked_malloc(input_capacity * sizeof(bool));
+		}
+
+		Node** input_ptr = node->inputs;
+		for(size_t j = 0; j < input_count; ++j, ++input_ptr) {
+			if (!(*input_ptr))
+				continue;
+
+			TreeMapNode* it = TreeMap_find(&map, *input_ptr);
+			assert(it);
+
+			size_t input_index = *((size_t*)it->value);
+			input_is_static[j] = is_static[input_index];
+			read_counts[input_index] += 1;
+			if (last_levels[input_index] < node_levels[i])
+				last_levels[input_index] = node_levels[i];
+		}
+
+		is_static[i] = GraphMemoryPlan_is_static_node(node, input_is_static);
+
+		if (GraphMemoryPlan_can_run_in_place(node, input_is_static)) {
+			TreeMapNode* it = TreeMap_find(&map, node->inputs[0]);
+			in_place_inputs[i] = *((size_t*)it->value);
+		}
+	}
+
+	// The output of a view is stored in the output of its first input, which
+	// thus has to live as long as the view is read. Views of views are
+	// resolved by walking the nodes in reverse topological order.
+	for(size_t i = node_count; i != 0; --i) {
+		Node* node = graph->sorted_nodes[i - 1];
+		if (!node->is_view)
+			continue;
+
+		TreeMapNode* it = TreeMap_find(&map, node->inputs[0]);
+		size_t input_index = *((size_t*)it->value);
+
+		if (!read_counts[i - 1])
+			last_levels[input_index] = ~((size_t)0);
+		else if (last_levels[input_index] < last_levels[i - 1])
+			last_levels[input_index] = last_levels[i - 1];
+	}
+
+	// Assign the buffers, in topological order. A buffer is free once the
+	// level at which it was last read is over.
+	size_t* buffer_end_levels = (size_t*)checked_malloc(node_count * sizeof(size_t));
+	size_t* node_buffers = (size_t*)checked_malloc(node_count * sizeof(size_t));
+
+	for(size_t i = 0; i < node_count; ++i) {
+		Node* node = graph->sorted_nodes[i];
+		if (!node->requests_output_buffer)
+			continue;
+
+		size_t len = node->output_buffer.data_len;
+		self->request_count += 1;
+		self->requested_len += len;
+
+		// Static outputs, outputs read by the host and outputs that may be
+		// updated ahead of the graph stay alive
+		size_t end_level = last_levels[i];
+		if (is_static[i] || (!read_counts[i]) || GraphPipeline_is_source(node))
+			end_level = ~((size_t)0);
+
+		// Take over the buffer of the first input if this node is its only
+		// reader
+		size_t input_index = in_place_inputs[i];
+		if ((input_index != ~((size_t)0)) && (read_counts[input_index] == 1)) {
+			size_t input_buffer = node_buffers[input_index];
+			if (buffer_end_levels[input_buffer] == node_levels[i]) {
+				buffer_end_levels[input_buffer] = end_level;
+				node_buffers[i] = input_buffer;
+				node->is_in_place = true;
+				self->in_place_count += 1;
+				continue;
+			}
+		}
+
+		// Pick the smallest free buffer large enough, otherwise the largest
+		// free buffer, to be grown
+		size_t best = self->buffer_count;
+		for(size_t j = 0; j < self->buffer_count; ++j) {
+			if ((buffer_end_levels[j] == ~((size_t)0)) || (buffer_end_levels[j] >= node_levels[i]))
+				continue;
+
+			if (best == self->buffer_count)
+				best = j;
+			else if (self->buffer_lens[j] >= len) {
+				if ((self->buffer_lens[best] < len) || (self->buffer_lens[j] < self->buffer_lens[best]))
+					best = j;
+			}
+			else if (self->buffer_lens[j] > self->buffer_lens[best])
+				best = j;
+		}
+
+		if (best == self->buffer_count) {
+			self->buffer_lens[best] = 0;
+			self->buffer_count += 1;
+		}
+
+		if (self->buffer_lens[best] < len)
+			self->buffer_lens[best] = len;
+
+		buffer_end_levels[best] = end_level;
+		node_buffers[i] = best;
+	}
+
+	// Allocate the buffers
+	size_t buffer_len_sum = 0;
+	for(size_t i = 0; i < self->buffer_count; ++i) {
+		self->buffers[i] = array_ops_allocate(self->buffer_lens[i]);
+		array_ops_fill(self->buffers[i], self->buffer_lens[i], (real_t)0);
+		buffer_len_sum += self->buffer_lens[i];
+	}
+
+	for(size_t i = 0; i < node_count; ++i) {
+		Node* node = graph->sorted_nodes[i];
+		if (node->requests_output_buffer)
+			node->output_buffer.data = self->buffers[node_buffers[i]];
+	}
+
+	if (self->request_count > 0)
+		SDL_Log(
+			"%zu output(s) share %zu buffer(s), %zu bytes instead of %zu bytes, %zu update(s) in place",
+			self->request_count,
+			self->buffer_count,
+			buffer_len_sum * sizeof(real_t),
+			self->requested_len * sizeof(real_t),
+			self->in_place_count
+		);
+
+	// Job done
+	free(node_buffers);
+	free(buffer_end_levels);
+	TreeMap_destroy(&map);
+	free(input_is_static);
+	free(node_indices);
+	free(in_place_inputs);
+	free(read_counts);
+	free(is_static);
+	free(last_levels);
+	free(node_levels);
+}
+
+
+void
+GraphMemoryPlan_destroy(
+	GraphMemoryPlan* self
+) {
+	assert(self);
+
+	for(size_t i = 0; i < self->buffer_count; ++i)
+		array_ops_free(self->buffers[i]);
+
+	free(self->buffer_lens);
+	free(self->buffers);
+
+	#ifdef DEBUG
+	self->buffer_count = 0;
+	self->buffers = 0;
+	self->buffer_lens = 0;
+	#endif
+}
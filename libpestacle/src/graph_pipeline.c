@@ -0,0 +1,319 @@
+#include <string.h>
+#include <assert.h>
+#include <SDL_log.h>
+#include <SDL_timer.h>
+#include <pestacle/memory.h>
+#include <pestacle/graph_pipeline.h>
+
+
+bool
+GraphPipeline_is_source(
+	const Node* node
+) {
+	assert(node);
+	assert(node->delegate);
+
+	return
+		(!NodeDelegate_has_inputs(node->delegate)) &&
+		(node->delegate->methods.update) &&
+		(node->delegate->methods.output) &&
+		(!(node->delegate->flags & (NodeDelegateFlag__main_thread | NodeDelegateFlag__stateless)));
+}
+
+
+static void
+GraphPipeline_latch_output(
+	NodeOutput* dst,
+	const Node* node
+) {
+	NodeOutput src = node->delegate->methods.output(node);
+
+	switch(node->out_descriptor.type) {
+		case DataType__matrix:
+			Matrix_copy((Matrix*)dst->matrix, src.matrix);
+			break;
+
+		case DataType__rgb_surface: {
+			const uint8_t* src_row = (const uint8_t*)src.rgb_surface->pixels;
+			uint8_t* dst_row = (uint8_t*)dst->rgb_surface->pixels;
+			size_t row_len = 4 * (size_t)dst->rgb_surface->w;
+
+			for(int i = dst->rgb_surface->h; i != 0; --i, src_row += src.rgb_surface->pitch, dst_row += dst->rgb_surface->pitch)
+				memcpy(dst_row, src_row, row_len);
+		} break;
+
+		default:
+			assert(0);
+	}
+}
+
+
+static int
+GraphPipeline_producer_main(
+	void* data
+) {
+	GraphPipeline* self = (GraphPipeline*)data;
+
+	while(true) {
+		// Wait for a slot to fill
+		SDL_SemWait(self->free_slots);
+		if (SDL_AtomicGet(&(self->quit)))
+			break;
+
+		// Update the sources and latch their outputs to the slot
+		NodeOutput* output = self->outputs + self->write_slot * self->source_count;
+		real_t* update_time = self->update_times + self->write_slot * self->source_count;
+		Node** node_ptr = self->sources;
+		for(size_t i = self->source_count; i != 0; --i, ++node_ptr, ++output, ++update_time) {
+			Uint64 start_time = SDL_GetPerformanceCounter();
+			Node_update(*node_ptr);
+			Uint64 end_time = SDL_GetPerformanceCounter();
+
+			GraphPipeline_latch_output(output, *node_ptr);
+
+			*update_time =
+				((real_t)(end_time - start_time)) / SDL_GetPerformanceFrequency();
+		}
+
+		// Hand the slot to the rest of the graph
+		self->write_slot = (self->write_slot + 1) % self->slot_count;
+		SDL_SemPost(self->ready_slots);
+	}
+
+	return 0;
+}
+
+
+static void
+GraphPipeline_destroy_slots(
+	GraphPipeline* self
+) {
+	NodeOutput* output = self->outputs;
+	Matrix* matrix = self->matrices;
+	for(size_t i = 0; i < self->slot_count; ++i) {
+		Node** node_ptr = self->sources;
+		for(size_t j = self->source_count; j != 0; --j, ++node_ptr, ++output, ++matrix) {
+			switch((*node_ptr)->out_descriptor.type) {
+				case DataType__matrix:
+					Matrix_destroy(matrix);
+					break;
+
+				case DataType__rgb_surface:
+					if (output->rgb_surface)
+						SDL_FreeSurface(output->rgb_surface);
+					break;
+
+				default:
+					break;
+			}
+		}
+	}
+}
+
+
+bool
+GraphPipeline_init(
+	GraphPipeline* self,
+	Node** nodes,
+	size_t node_count,
+	size_t depth
+) {
+	assert(self);
+	assert(nodes);
+	assert(depth > 0);
+
+	// Initialize members
+	self->source_count = 0;
+	self->slot_count = depth + 1;
+	self->read_slot = 0;
+	self->write_slot = 0;
+	self->has_read_slot = false;
+	self->free_slots = 0;
+	self->ready_slots = 0;
+	self->thread = 0;
+	SDL_AtomicSet(&(self->quit), 0);
+
+	// Collect the sources
+	self->sources = (Node**)checked_malloc(node_count * sizeof(Node*));
+	self->source_indices = (size_t*)checked_malloc(node_count * sizeof(size_t));
+
+	for(size_t i = 0; i < node_count; ++i)
+		if (GraphPipeline_is_source(nodes[i])) {
+			self->sources[self->source_count] = nodes[i];
+			self->source_indices[self->source_count] = i;
+			self->source_count += 1;
+		}
+
+	// Allocate the slots
+	size_t output_count = self->slot_count * self->source_count;
+	self->outputs = (NodeOutput*)checked_malloc(output_count * sizeof(NodeOutput));
+	self->matrices = (Matrix*)checked_malloc(output_count * sizeof(Matrix));
+	self->update_times = (real_t*)checked_malloc(output_count * sizeof(real_t));
+
+	bool surfaces_created = true;
+	NodeOutput* output = self->outputs;
+	Matrix* matrix = self->matrices;
+	real_t* update_time = self->update_times;
+	for(size_t i = 0; i < self->slot_count; ++i) {
+		Node** node_ptr = self->sources;
+		for(size_t j = self->source_count; j != 0; --j, ++node_ptr, ++output, ++matrix, ++update_time) {
+			const DataDescriptor* descriptor = &((*node_ptr)->out_descriptor);
+
+			*update_time = (real_t)0;
+			switch(descriptor->type) {
+				case DataType__matrix:
+					Matrix_init(matrix, descriptor->matrix.height, descriptor->matrix.width);
+					Matrix_fill(matrix, (real_t)0);
+					output->matrix = matrix;
+					break;
+
+				case DataType__rgb_surface:
+					output->rgb_surface =
+						SDL_CreateRGBSurfaceWithFormat(
+							0,
+							(int)descriptor->rgb_surface.width,
+							(int)descriptor->rgb_surface.height,
+							32,
+							SDL_PIXELFORMAT_RGBA32
+						);
+					surfaces_created &= (output->rgb_surface != 0);
+					break;
+
+				default:
+					assert(0);
+			}
+		}
+	}
+
+	if (!surfaces_created) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to create pipeline surfaces: %s",
+			SDL_GetError()
+		);
+		goto failure;
+	}
+
+	// Create the producer thread, which can fill all the slots but the one
+	// read by the rest of the graph
+	self->free_slots = SDL_CreateSemaphore((Uint32)self->slot_count);
+	self->ready_slots = SDL_CreateSemaphore(0);
+	if ((!self->free_slots) || (!self->ready_slots)) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to create pipeline semaphores: %s",
+			SDL_GetError()
+		);
+		goto failure;
+	}
+
+	self->thread =
+		SDL_CreateThread(
+			GraphPipeline_producer_main,
+			"pestacle-sources",
+			self
+		);
+
+	if (!self->thread) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to create pipeline thread: %s",
+			SDL_GetError()
+		);
+		goto failure;
+	}
+
+	// The other nodes now read the latched outputs
+	for(size_t i = 0; i < self->source_count; ++i)
+		self->sources[i]->latched_output = self->outputs + i;
+
+	// Job done
+	return true;
+
+failure:
+	GraphPipeline_destroy(self);
+	return false;
+}
+
+
+void
+GraphPipeline_destroy(
+	GraphPipeline* self
+) {
+	assert(self);
+
+	// Stop the producer thread
+	if (self->thread) {
+		SDL_AtomicSet(&(self->quit), 1);
+		SDL_SemPost(self->free_slots);
+		SDL_WaitThread(self->thread, 0);
+	}
+
+	if (self->ready_slots)
+		SDL_DestroySemaphore(self->ready_slots);
+
+	if (self->free_slots)
+		SDL_DestroySemaphore(self->free_slots);
+
+	// Restore the sources
+	for(size_t i = 0; i < self->source_count; ++i)
+		self->sources[i]->latched_output = 0;
+
+	// Release the slots
+	GraphPipeline_destroy_slots(self);
+
+	free(self->update_times);
+	free(self->matrices);
+	free(self->outputs);
+	free(self->source_indices);
+	free(self->sources);
+
+	#ifdef DEBUG
+	self->source_count = 0;
+	self->sources = 0;
+	self->source_indices = 0;
+	self->slot_count = 0;
+	self->outputs = 0;
+	self->matrices = 0;
+	self->update_times = 0;
+	self->free_slots = 0;
+	self->ready_slots = 0;
+	self->thread = 0;
+	#endif
+}
+
+
+void
+GraphPipeline_acquire(
+	GraphPipeline* self
+) {
+	assert(self);
+
+	// Release the slot of the previous frame
+	if (self->has_read_slot) {
+		SDL_SemPost(self->free_slots);
+		self->read_slot = (self->read_slot + 1) % self->slot_count;
+	}
+
+	// Wait for the next slot
+	SDL_SemWait(self->ready_slots);
+	self->has_read_slot = true;
+
+	// Latch the source outputs to that slot
+	const NodeOutput* output = self->outputs + self->read_slot * self->source_count;
+	for(size_t i = 0; i < self->source_count; ++i) {
+		self->sources[i]->latched_output = output + i;
+		self->sources[i]->version += 1;
+	}
+}
+
+
+const real_t*
+GraphPipeline_update_times(
+	const GraphPipeline* self
+) {
+	assert(self);
+	assert(self->has_read_slot);
+
+	return self->update_times + self->read_slot * self->source_count;
+}
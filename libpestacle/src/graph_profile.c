@@ -13,6 +13,12 @@ NodeProfile_init(
 	assert(self);
 
 	AverageResult_init(&(self->time));
+	Histogram_init(&(self->time_histogram));
+
+	for(size_t i = 0; i < PerfCounter__count; ++i)
+		self->counters.values[i] = 0;
+	self->counters.time_enabled = 0;
+	self->counters.time_running = 0;
 }
 
 
@@ -26,6 +32,24 @@ NodeProfile_update(
 	assert(!isnan(time_interval));
 
 	AverageResult_accumulate(&(self->time), time_interval);
+	Histogram_accumulate(&(self->time_histogram), time_interval);
+}
+
+
+void
+NodeProfile_update_counters(
+	NodeProfile* self,
+	const PerfCounterValues* start_values,
+	const PerfCounterValues* end_values
+) {
+	assert(self);
+	assert(start_values);
+	assert(end_values);
+
+	for(size_t i = 0; i < PerfCounter__count; ++i)
+		self->counters.values[i] += end_values->values[i] - start_values->values[i];
+	self->counters.time_enabled += end_values->time_enabled - start_values->time_enabled;
+	self->counters.time_running += end_values->time_running - start_values->time_running;
 }
 
 
@@ -40,6 +64,7 @@ GraphProfile_init(
 	assert(graph);
 
 	AverageResult_init(&(self->time));
+	Histogram_init(&(self->time_histogram));
 
 	self->node_profiles =
 		(NodeProfile*)checked_malloc(graph->sorted_node_count * sizeof(NodeProfile));
@@ -47,6 +72,12 @@ GraphProfile_init(
 	NodeProfile* profile_ptr = self->node_profiles;
 	for(size_t i = graph->sorted_node_count; i != 0; --i, ++profile_ptr)
 		NodeProfile_init(profile_ptr);
+
+	self->trace = 0;
+	self->perf_counters = 0;
+	self->counted_thread_pool = 0;
+	self->frame_period = 0;
+	self->over_frame_period_count = 0;
 }
 
 
@@ -60,6 +91,117 @@ GraphProfile_destroy(
 }
 
 
+void
+GraphProfile_set_trace(
+	GraphProfile* self,
+	Trace* trace
+) {
+	assert(self);
+
+	self->trace = trace;
+}
+
+
+void
+GraphProfile_set_frame_period(
+	GraphProfile* self,
+	real_t frame_period
+) {
+	assert(self);
+
+	self->frame_period = frame_period;
+}
+
+
+void
+GraphProfile_set_perf_counters(
+	GraphProfile* self,
+	PerfCounters* perf_counters
+) {
+	assert(self);
+
+	self->perf_counters = perf_counters;
+}
+
+
+static void
+GraphProfile_print_counters(
+	const PerfCounters* perf_counters,
+	NodeProfile* profile,
+	const Node* node,
+	FILE* fp
+) {
+	const uint64_t* values = profile->counters.values;
+
+	// The pipelined sources are updated without counters, and the counters
+	// might never have had the hardware
+	bool has_counts = profile->counters.time_running != 0;
+
+	size_t pixel_count = 0;
+	switch(node->out_descriptor.type) {
+		case DataType__matrix:
+			pixel_count = node->out_descriptor.matrix.width * node->out_descriptor.matrix.height;
+			break;
+
+		case DataType__rgb_surface:
+			pixel_count = node->out_descriptor.rgb_surface.width * node->out_descriptor.rgb_surface.height;
+			break;
+
+		default:
+			break;
+	}
+
+	real_t update_count = (real_t)AverageResult_count(&(profile->time));
+	real_t pixel_sum = update_count * pixel_count;
+
+	bool has_cycles = has_counts && PerfCounters_is_available(perf_counters, PerfCounter__cycles);
+
+	fprintf(fp, "      IPC ");
+	if (has_cycles && PerfCounters_is_available(perf_counters, PerfCounter__instructions) && (values[PerfCounter__cycles] != 0))
+		fprintf(fp, "%.2f", ((real_t)values[PerfCounter__instructions]) / values[PerfCounter__cycles]);
+	else
+		fprintf(fp, "n/a");
+
+	fprintf(fp, ", cache misses/px ");
+	if (has_counts && PerfCounters_is_available(perf_counters, PerfCounter__cache_misses) && (pixel_sum > 0))
+		fprintf(fp, "%.4f", ((real_t)values[PerfCounter__cache_misses]) / pixel_sum);
+	else
+		fprintf(fp, "n/a");
+
+	fprintf(fp, ", branch misses/px ");
+	if (has_counts && PerfCounters_is_available(perf_counters, PerfCounter__branch_misses) && (pixel_sum > 0))
+		fprintf(fp, "%.4f", ((real_t)values[PerfCounter__branch_misses]) / pixel_sum);
+	else
+		fprintf(fp, "n/a");
+
+	fprintf(fp, ", cycles/px ");
+	if (has_cycles && (pixel_sum > 0))
+		fprintf(fp, "%.2f\n", ((real_t)values[PerfCounter__cycles]) / pixel_sum);
+	else
+		fprintf(fp, "n/a\n");
+}
+
+
+static void
+GraphProfile_print_times(
+	AverageResult* time,
+	const Histogram* time_histogram,
+	FILE* fp
+) {
+	fprintf(
+		fp,
+		"%.3f msec (+/- %.3f), p50 %.3f, p90 %.3f, p99 %.3f, p99.9 %.3f, max %.3f\n",
+		1e3f * AverageResult_mean(time),
+		3 * 1e3f * AverageResult_stddev(time),
+		1e3f * Histogram_percentile(time_histogram, (real_t).5),
+		1e3f * Histogram_percentile(time_histogram, (real_t).9),
+		1e3f * Histogram_percentile(time_histogram, (real_t).99),
+		1e3f * Histogram_percentile(time_histogram, (real_t).999),
+		1e3f * Histogram_max(time_histogram)
+	);
+}
+
+
 void
 GraphProfile_print_report(
 	GraphProfile* self,
@@ -120,20 +262,23 @@ GraphProfile_print_report(
 		for(size_t j = 0; j < node_id_max_len - node_id_len; ++j)
 			fputc(' ', fp);
 
+		fprintf(fp, " => ");
+		GraphProfile_print_times(&(profile_ptr->time), &(profile_ptr->time_histogram), fp);
+
+		if (self->perf_counters)
+			GraphProfile_print_counters(self->perf_counters, profile_ptr, *node_ptr, fp);
+	}
+
+	fprintf(fp, "total ");
+	GraphProfile_print_times(&(self->time), &(self->time_histogram), fp);
+
+	if (self->frame_period > 0)
 		fprintf(
 			fp,
-			" => %.3f msec (+/- %.3f)\n",
-			1e3f * AverageResult_mean(&(profile_ptr->time)),
-			3 * 1e3f * AverageResult_stddev(&(profile_ptr->time))
+			"%zu update(s) over the %.3f msec frame period\n",
+			self->over_frame_period_count,
+			1e3f * self->frame_period
 		);
-	}
-
-	fprintf(
-		fp,
-		"total %.3f msec (+/- %.3f)\n",
-		1e3f * AverageResult_mean(&(self->time)),
-		3 * 1e3f * AverageResult_stddev(&(self->time))
-	);
 
 	// Release ressources
 	StringList_destroy(&str_list);
@@ -1,8 +1,297 @@
 #include <tgmath.h>
 #include <assert.h>
+#include <pestacle/memory.h>
 #include <pestacle/image/gaussian.h>
 
 
+// Minimum number of coefficients processed by a task of the recursive method
+#define GAUSSIAN_FILTER_GRAIN_SIZE 16384
+
+// Number of columns filtered together by the recursive method
+#define GAUSSIAN_FILTER_BLOCK_LEN 128
+
+
+// --- Recursive method -------------------------------------------------------
+
+static void
+GaussianFilter_init_recursive(
+	GaussianFilter* self,
+	real_t sigma
+) {
+	// Young - van Vliet coefficients
+	double s = sigma;
+	double q;
+	if (s >= 2.5)
+		q = 0.98711 * s - 0.96330;
+	else
+		q = 3.97156 - 4.14554 * sqrt(1 - 0.26891 * s);
+
+	double b0 = 1.57825 + 2.44413 * q + 1.4281 * q * q + 0.422205 * q * q * q;
+	double a[3] = {
+		(2.44413 * q + 2.85619 * q * q + 1.26661 * q * q * q) / b0,
+		-(1.4281 * q * q + 1.26661 * q * q * q) / b0,
+		(0.422205 * q * q * q) / b0
+	};
+	double B = 1 - (a[0] + a[1] + a[2]);
+
+	self->coeffs[0] = B;
+	for(size_t i = 0; i < 3; ++i)
+		self->coeffs[i + 1] = a[i];
+
+	/*
+	 * Triggs - Sdika boundary matrix : when the input is constant past the
+	 * end of the signal, the first 3 values of the anti-causal pass past the
+	 * end are a linear function of the last 3 values of the causal pass, both
+	 * taken relative to the constant. The columns of the matrix are obtained
+	 * by running both passes from each of the 3 unit states, long enough for
+	 * the responses to vanish.
+	 */
+	size_t len = 20 * ((size_t)ceil(s)) + 64;
+	double* w = (double*)checked_malloc(len * sizeof(double));
+
+	for(size_t c = 0; c < 3; ++c) {
+		double state[3] = { 0, 0, 0 };
+		state[c] = 1;
+
+		for(size_t n = 0; n < len; ++n) {
+			w[n] = a[0] * state[0] + a[1] * state[1] + a[2] * state[2];
+			state[2] = state[1];
+			state[1] = state[0];
+			state[0] = w[n];
+		}
+
+		state[0] = state[1] = state[2] = 0;
+		for(size_t n = len; n != 0; --n) {
+			double y = B * w[n - 1] + a[0] * state[0] + a[1] * state[1] + a[2] * state[2];
+			state[2] = state[1];
+			state[1] = state[0];
+			state[0] = y;
+		}
+
+		for(size_t r = 0; r < 3; ++r)
+			self->boundary_matrix[3 * r + c] = state[r];
+	}
+
+	free(w);
+
+	// Mirrored values on each side
+	size_t padding_len = (size_t)ceil(3 * s);
+	size_t row_count = self->U.row_count;
+	size_t col_count = self->U.col_count;
+
+	self->row_padding_len = 0;
+	self->col_padding_len = 0;
+
+	if (self->mode == GaussianFilterMode__MIRROR) {
+		self->row_padding_len = (padding_len < col_count) ? padding_len : col_count - 1;
+		self->col_padding_len = (padding_len < row_count) ? padding_len : row_count - 1;
+	}
+
+	if (self->row_padding_len > 0)
+		Matrix_init(&(self->row_padding), row_count, self->row_padding_len);
+
+	if (self->col_padding_len > 0)
+		Matrix_init(&(self->col_padding), self->col_padding_len, col_count);
+}
+
+
+/*
+ * One step of the recursion, for lane_count adjacent signals. The state,
+ * y[n-1], y[n-2] and y[n-3], is kept in double precision, the poles of the
+ * filter being close to 1 for large values of sigma.
+ */
+
+static inline void
+GaussianFilter_recursive_step(
+	const double* coeffs,
+	real_t* y,
+	const real_t* x,
+	double* state[3],
+	size_t lane_count
+) {
+	// y[n] replaces y[n-3]
+	double* y1 = state[0];
+	double* y2 = state[1];
+	double* y3 = state[2];
+	for(size_t j = 0; j < lane_count; ++j) {
+		y3[j] = coeffs[0] * x[j] + coeffs[1] * y1[j] + coeffs[2] * y2[j] + coeffs[3] * y3[j];
+		y[j] = (real_t)y3[j];
+	}
+
+	state[0] = y3;
+	state[1] = y1;
+	state[2] = y2;
+}
+
+
+/*
+ * Filters lane_count adjacent signals of len values, src_stride values apart
+ * in src and dst_stride values apart in dst. padding receives the
+ * padding_len mirrored values after the end of each signal, padding_stride
+ * values apart.
+ */
+
+static void
+GaussianFilter_recursive_filter(
+	const GaussianFilter* self,
+	real_t* dst,
+	const real_t* src,
+	real_t* padding,
+	size_t len,
+	size_t lane_count,
+	size_t dst_stride,
+	size_t src_stride,
+	size_t padding_len,
+	size_t padding_stride
+) {
+	assert(lane_count <= GAUSSIAN_FILTER_BLOCK_LEN);
+
+	const double* coeffs = self->coeffs;
+	const double* M = self->boundary_matrix;
+
+	double state_data[3][GAUSSIAN_FILTER_BLOCK_LEN];
+	double* state[3] = { state_data[0], state_data[1], state_data[2] };
+	real_t discarded[GAUSSIAN_FILTER_BLOCK_LEN];
+
+	// Initial state : the signal is null before its start in ZERO mode, and
+	// constant before the mirrored values in MIRROR mode
+	const real_t* start = src + padding_len * src_stride;
+	for(size_t i = 0; i < 3; ++i)
+		for(size_t j = 0; j < lane_count; ++j)
+			state[i][j] = (self->mode == GaussianFilterMode__MIRROR) ? start[j] : (real_t)0;
+
+	// Causal pass, over the mirrored values before the start
+	for(size_t i = padding_len; i != 0; --i)
+		GaussianFilter_recursive_step(coeffs, discarded, src + i * src_stride, state, lane_count);
+
+	// Causal pass, over the signal
+	for(size_t i = 0; i < len; ++i)
+		GaussianFilter_recursive_step(coeffs, dst + i * dst_stride, src + i * src_stride, state, lane_count);
+
+	// Causal pass, over the mirrored values after the end
+	for(size_t i = 1; i <= padding_len; ++i)
+		GaussianFilter_recursive_step(coeffs, padding + (i - 1) * padding_stride, src + (len - 1 - i) * src_stride, state, lane_count);
+
+	// Initial state of the anti-causal pass, the signal being null after the
+	// end in ZERO mode, and constant after the mirrored values in MIRROR mode
+	const real_t* end = src + (len - 1 - padding_len) * src_stride;
+	for(size_t j = 0; j < lane_count; ++j) {
+		double u = (self->mode == GaussianFilterMode__MIRROR) ? end[j] : (real_t)0;
+		double d1 = state[0][j] - u;
+		double d2 = state[1][j] - u;
+		double d3 = state[2][j] - u;
+
+		for(size_t r = 0; r < 3; ++r)
+			state_data[r][j] = u + M[3 * r] * d1 + M[3 * r + 1] * d2 + M[3 * r + 2] * d3;
+	}
+
+	for(size_t r = 0; r < 3; ++r)
+		state[r] = state_data[r];
+
+	// Anti-causal pass, over the mirrored values after the end
+	for(size_t i = padding_len; i != 0; --i) {
+		real_t* y = padding + (i - 1) * padding_stride;
+		GaussianFilter_recursive_step(coeffs, y, y, state, lane_count);
+	}
+
+	// Anti-causal pass, over the signal
+	for(size_t i = len; i != 0; --i) {
+		real_t* y = dst + (i - 1) * dst_stride;
+		GaussianFilter_recursive_step(coeffs, y, y, state, lane_count);
+	}
+}
+
+
+typedef struct {
+	GaussianFilter* self;
+	Matrix* matrix;
+} GaussianFilterJobContext;
+
+
+static void
+GaussianFilter_recursive_rowwise_job(
+	void* context,
+	size_t begin,
+	size_t end
+) {
+	const GaussianFilterJobContext* job_context = (const GaussianFilterJobContext*)context;
+	GaussianFilter* self = job_context->self;
+	const Matrix* matrix = job_context->matrix;
+
+	for(size_t i = begin; i < end; ++i)
+		GaussianFilter_recursive_filter(
+			self,
+			self->U.data + i * self->U.row_stride,
+			matrix->data + i * matrix->row_stride,
+			self->row_padding_len > 0 ? self->row_padding.data + i * self->row_padding_len : 0,
+			matrix->col_count,
+			1,
+			1,
+			1,
+			self->row_padding_len,
+			1
+		);
+}
+
+
+static void
+GaussianFilter_recursive_colwise_job(
+	void* context,
+	size_t begin,
+	size_t end
+) {
+	const GaussianFilterJobContext* job_context = (const GaussianFilterJobContext*)context;
+	GaussianFilter* self = job_context->self;
+	Matrix* matrix = job_context->matrix;
+
+	// Process the columns by blocks, each row of a block being contiguous
+	for(size_t j = begin; j < end; j += GAUSSIAN_FILTER_BLOCK_LEN)
+		GaussianFilter_recursive_filter(
+			self,
+			matrix->data + j,
+			self->U.data + j,
+			self->col_padding_len > 0 ? self->col_padding.data + j : 0,
+			matrix->row_count,
+			(end - j < GAUSSIAN_FILTER_BLOCK_LEN) ? end - j : GAUSSIAN_FILTER_BLOCK_LEN,
+			matrix->row_stride,
+			self->U.row_stride,
+			self->col_padding_len,
+			matrix->col_count
+		);
+}
+
+
+static void
+GaussianFilter_recursive_transform(
+	GaussianFilter* self,
+	Matrix* matrix,
+	ThreadPool* thread_pool
+) {
+	GaussianFilterJobContext job_context = { self, matrix };
+
+	size_t row_grain = GAUSSIAN_FILTER_GRAIN_SIZE / matrix->col_count;
+	ThreadPool_parallel_for(
+		thread_pool,
+		GaussianFilter_recursive_rowwise_job,
+		&job_context,
+		0,
+		matrix->row_count,
+		row_grain > 0 ? row_grain : 1
+	);
+
+	size_t block_count = GAUSSIAN_FILTER_GRAIN_SIZE / (matrix->row_count * GAUSSIAN_FILTER_BLOCK_LEN);
+	ThreadPool_parallel_for(
+		thread_pool,
+		GaussianFilter_recursive_colwise_job,
+		&job_context,
+		0,
+		matrix->col_count,
+		(block_count > 0 ? block_count : 1) * GAUSSIAN_FILTER_BLOCK_LEN
+	);
+}
+
+
+// --- Gaussian filter --------------------------------------------------------
 
 void
 GaussianFilter_init(
@@ -10,20 +299,31 @@ GaussianFilter_init(
 	size_t row_count,
 	size_t col_count,
 	real_t sigma,
-	enum GaussianFilterMode mode
+	enum GaussianFilterMode mode,
+	enum GaussianFilterMethod method
 ) {
 	assert(self);
 	assert(sigma > (real_t)0);
-	
+	assert((method != GaussianFilterMethod__RECURSIVE) || (sigma >= (real_t).5));
+
 	self->mode = mode;
+	self->method = method;
 
 	Matrix_init(&(self->U), row_count, col_count);
 	Matrix_fill(&(self->U), (real_t)0);
 
-	// Compute the Gaussian kernel
-	size_t kernel_size = 6 * ((size_t)floor(sigma)) + 1;
-	Vector_init(&(self->kernel), kernel_size);
-	Vector_set_gaussian_kernel(&(self->kernel), sigma);
+	switch(self->method) {
+		case GaussianFilterMethod__CONVOLUTION: {
+			// Compute the Gaussian kernel
+			size_t kernel_size = 6 * ((size_t)floor(sigma)) + 1;
+			Vector_init(&(self->kernel), kernel_size);
+			Vector_set_gaussian_kernel(&(self->kernel), sigma);
+		} break;
+
+		case GaussianFilterMethod__RECURSIVE:
+			GaussianFilter_init_recursive(self, sigma);
+			break;
+	}
 }
 
 
@@ -34,7 +334,19 @@ GaussianFilter_destroy(
 	assert(self);
 
 	Matrix_destroy(&(self->U));
-	Vector_destroy(&(self->kernel));
+
+	switch(self->method) {
+		case GaussianFilterMethod__CONVOLUTION:
+			Vector_destroy(&(self->kernel));
+			break;
+
+		case GaussianFilterMethod__RECURSIVE:
+			if (self->row_padding_len > 0)
+				Matrix_destroy(&(self->row_padding));
+			if (self->col_padding_len > 0)
+				Matrix_destroy(&(self->col_padding));
+			break;
+	}
 }
 
 
@@ -42,36 +354,55 @@ void
 GaussianFilter_transform(
 	GaussianFilter* self,
 	Matrix* matrix
+) {
+	GaussianFilter_parallel_transform(self, matrix, 0);
+}
+
+
+void
+GaussianFilter_parallel_transform(
+	GaussianFilter* self,
+	Matrix* matrix,
+	ThreadPool* thread_pool
 ) {
 	assert(self);
 	assert(matrix->row_count == self->U.row_count);
 	assert(matrix->col_count == self->U.col_count);
 
+	if (self->method == GaussianFilterMethod__RECURSIVE) {
+		GaussianFilter_recursive_transform(self, matrix, thread_pool);
+		return;
+	}
+
 	switch(self->mode) {
 		case GaussianFilterMode__ZERO:
-			Matrix_rowwise_convolution__zero(
+			Matrix_parallel_rowwise_convolution__zero(
 				&(self->U),
 				matrix,
-				&(self->kernel)
+				&(self->kernel),
+				thread_pool
 			);
-			Matrix_colwise_convolution__zero(
+			Matrix_parallel_colwise_convolution__zero(
 				matrix,
 				&(self->U),
-				&(self->kernel)
+				&(self->kernel),
+				thread_pool
 			);
 			break;
 
 		case GaussianFilterMode__MIRROR:
-			Matrix_rowwise_convolution__mirror(
+			Matrix_parallel_rowwise_convolution__mirror(
 				&(self->U),
 				matrix,
-				&(self->kernel)
+				&(self->kernel),
+				thread_pool
 			);
-			Matrix_colwise_convolution__mirror(
+			Matrix_parallel_colwise_convolution__mirror(
 				matrix,
 				&(self->U),
-				&(self->kernel)
+				&(self->kernel),
+				thread_pool
 			);
-			break;	
+			break;
 	}
 }
@@ -1,21 +1,123 @@
 #include <tgmath.h>
 #include <stdlib.h>
 #include <sys/types.h>
+#include <assert.h>
+#include <SDL_atomic.h>
 #include <pestacle/math/array_ops.h>
+#include <pestacle/math/array_ops_backend.h>
 #include <pestacle/memory.h>
 
 
+#define ARRAY_OPS_BOX_FILTER_BLOCK_LEN 128
+
+
 static real_t
 square(real_t x) {
 	return x * x;
 }
 
 
+// --- Backends ---------------------------------------------------------------
+
+static const ArrayOpsBackend* const
+array_ops_backends[] = {
+	&array_ops_scalar_backend,
+	#ifdef ARRAY_OPS_HAS_X86_BACKENDS
+	&array_ops_sse41_backend,
+	&array_ops_avx2_backend,
+	#endif
+	#ifdef ARRAY_OPS_HAS_NEON_BACKEND
+	&array_ops_neon_backend,
+	#endif
+	0
+};
+
+
+static void* array_ops_current_backend = 0;
+static SDL_atomic_t array_ops_precision = { ArrayOpsPrecision__exact };
+
+
+const ArrayOpsBackend* const*
+array_ops_list_backends() {
+	return array_ops_backends;
+}
+
+
+const ArrayOpsBackend*
+array_ops_best_backend() {
+	// The backends are listed from the slowest to the fastest
+	const ArrayOpsBackend* ret = &array_ops_scalar_backend;
+	for(const ArrayOpsBackend* const* backend_ptr = array_ops_backends; *backend_ptr; ++backend_ptr)
+		if ((*backend_ptr)->is_supported())
+			ret = *backend_ptr;
+
+	return ret;
+}
+
+
+const ArrayOpsBackend*
+array_ops_get_backend() {
+	const ArrayOpsBackend* ret =
+		(const ArrayOpsBackend*)SDL_AtomicGetPtr(&array_ops_current_backend);
+
+	// Select the backend on first use
+	if (!ret) {
+		ret = array_ops_best_backend();
+		SDL_AtomicSetPtr(&array_ops_current_backend, (void*)ret);
+	}
+
+	return ret;
+}
+
+
+void
+array_ops_set_backend(
+	const ArrayOpsBackend* backend
+) {
+	assert(backend);
+	assert(backend->is_supported());
+
+	SDL_AtomicSetPtr(&array_ops_current_backend, (void*)backend);
+}
+
+
+static inline const ArrayOpsKernels*
+array_ops_kernels() {
+	return &(array_ops_get_backend()->kernels);
+}
+
+
+// --- Precision --------------------------------------------------------------
+
+ArrayOpsPrecision
+array_ops_get_precision() {
+	return (ArrayOpsPrecision)SDL_AtomicGet(&array_ops_precision);
+}
+
+
+void
+array_ops_set_precision(
+	ArrayOpsPrecision precision
+) {
+	SDL_AtomicSet(&array_ops_precision, (int)precision);
+}
+
+
+// --- Operations -------------------------------------------------------------
+
 real_t*
 array_ops_allocate(
 	size_t len
 ) {
-	return (real_t*)checked_malloc(sizeof(real_t) * len);
+	return (real_t*)checked_aligned_malloc(sizeof(real_t) * len, ARRAY_OPS_ALIGNMENT);
+}
+
+
+void
+array_ops_free(
+	real_t* array
+) {
+	aligned_free(array);
 }
 
 
@@ -40,8 +142,7 @@ array_ops_fill(
 	size_t len,
 	real_t value
 ) {
-	for( ; len != 0; --len, ++dst)
-		*dst = value;
+	array_ops_kernels()->fill(dst, len, value);
 }
 
 
@@ -110,8 +211,20 @@ array_ops_copy(
 	const real_t* src,
 	size_t len
 ) {
-	for( ; len != 0; --len, ++dst, ++src)
-		*dst = *src;
+	array_ops_kernels()->copy(dst, src, len);
+}
+
+
+void
+array_ops_transpose(
+	real_t* dst,
+	const real_t* src,
+	size_t row_count,
+	size_t col_count,
+	size_t dst_stride,
+	size_t src_stride
+) {
+	array_ops_kernels()->transpose(dst, src, row_count, col_count, dst_stride, src_stride);
 }
 
 
@@ -161,8 +274,7 @@ array_ops_sqrt(
 	real_t* dst,
 	size_t len
 ) {
-	for( ; len != 0; --len, ++dst)
-		*dst = sqrt(*dst);
+	array_ops_kernels()->square_root(dst, len);
 }
 
 
@@ -171,6 +283,11 @@ array_ops_exp(
 	real_t* dst,
 	size_t len
 ) {
+	if (array_ops_get_precision() == ArrayOpsPrecision__fast) {
+		array_ops_kernels()->fast_exp(dst, len);
+		return;
+	}
+
 	for( ; len != 0; --len, ++dst)
 		*dst = exp(*dst);
 }
@@ -181,23 +298,44 @@ array_ops_log(
 	real_t* dst,
 	size_t len
 ) {
+	if (array_ops_get_precision() == ArrayOpsPrecision__fast) {
+		array_ops_kernels()->fast_log(dst, len);
+		return;
+	}
+
 	for( ; len != 0; --len, ++dst)
 		*dst = log(*dst);
 }
 
 
+void
+array_ops_pow(
+	real_t* dst,
+	size_t len,
+	real_t exponent
+) {
+	if (exponent == 0) {
+		array_ops_kernels()->fill(dst, len, (real_t)1);
+		return;
+	}
+
+	if (array_ops_get_precision() == ArrayOpsPrecision__fast) {
+		array_ops_kernels()->fast_pow(dst, len, exponent);
+		return;
+	}
+
+	for( ; len != 0; --len, ++dst)
+		*dst = pow(*dst, exponent);
+}
+
+
 void
 array_ops_heaviside(
 	real_t* dst,
 	size_t len,
 	real_t threshold
 ) {
-	for( ; len != 0; --len, ++dst) {
-		if (*dst < threshold)
-			*dst = (real_t)0;
-		else
-			*dst = (real_t)1;
-	}
+	array_ops_kernels()->heaviside(dst, len, threshold);
 }
 
 
@@ -207,8 +345,7 @@ array_ops_inc(
 	size_t len,
 	real_t shift
 ) {
-	for( ; len != 0; --len, ++dst)
-		*dst += shift;
+	array_ops_kernels()->inc(dst, len, shift);
 }
 
 
@@ -218,8 +355,54 @@ array_ops_scale(
 	size_t len,
 	real_t factor
 ) {
-	for( ; len != 0; --len, ++dst)
-		*dst *= factor;
+	array_ops_kernels()->scale(dst, len, factor);
+}
+
+
+// Number of coefficients processed at once by array_ops_run
+#define ARRAY_OPS_RUN_BLOCK_LEN 1024
+
+
+void
+array_ops_run(
+	real_t* dst,
+	size_t len,
+	const ArrayOp* ops,
+	size_t op_count
+) {
+	while(len != 0) {
+		size_t block_len = len;
+		if (block_len > ARRAY_OPS_RUN_BLOCK_LEN)
+			block_len = ARRAY_OPS_RUN_BLOCK_LEN;
+
+		const ArrayOp* op = ops;
+		for(size_t i = op_count; i != 0; --i, ++op) {
+			switch(op->code) {
+				case ArrayOpCode__inc:
+					array_ops_inc(dst, block_len, op->arg);
+					break;
+
+				case ArrayOpCode__scale:
+					array_ops_scale(dst, block_len, op->arg);
+					break;
+
+				case ArrayOpCode__square:
+					array_ops_square(dst, block_len);
+					break;
+
+				case ArrayOpCode__exp:
+					array_ops_exp(dst, block_len);
+					break;
+
+				case ArrayOpCode__heaviside:
+					array_ops_heaviside(dst, block_len, op->arg);
+					break;
+			}
+		}
+
+		dst += block_len;
+		len -= block_len;
+	}
 }
 
 
@@ -230,8 +413,7 @@ array_ops_scaled_copy(
 	size_t len,
 	real_t factor
 ) {
-	for( ; len != 0; --len, ++dst, ++src)
-		*dst = factor * (*src);
+	array_ops_kernels()->scaled_copy(dst, src, len, factor);
 }
 
 
@@ -241,11 +423,7 @@ array_ops_reduction_min(
 	const real_t* src,
 	size_t len
 ) {
-	real_t ret = *src;
-	for(--len, ++src; len != 0; --len, ++src)
-		ret = fmin(ret, *src);
-
-	return ret;
+	return array_ops_kernels()->reduction_min(src, len);
 }
 
 
@@ -254,11 +432,7 @@ array_ops_reduction_max(
 	const real_t* src,
 	size_t len
 ) {
-	real_t ret = *src;
-	for(--len, ++src; len != 0; --len, ++src)
-		ret = fmax(ret, *src);
-
-	return ret;
+	return array_ops_kernels()->reduction_max(src, len);
 }
 
 
@@ -267,11 +441,7 @@ array_ops_reduction_sum(
 	const real_t* src,
 	size_t len
 ) {
-	real_t ret = (*src);
-	for(--len, ++src; len != 0; --len, ++src)
-		ret += (*src);
-
-	return ret;
+	return array_ops_kernels()->reduction_sum(src, len);
 }
 
 
@@ -295,11 +465,7 @@ array_ops_reduction_square_sum(
 	const real_t* src,
 	size_t len
 ) {
-	real_t ret = (*src) * (*src);
-	for(--len, ++src; len != 0; --len, ++src)
-		ret = fma(*src, *src, ret);
-
-	return ret;
+	return array_ops_kernels()->reduction_square_sum(src, len);
 }
 
 
@@ -399,8 +565,7 @@ array_ops_add(
 	const real_t* src,
 	size_t len
 ) {
-	for( ; len != 0; --len, ++dst, ++src)
-		*dst += (*src);
+	array_ops_kernels()->add(dst, src, len);
 }
 
 
@@ -410,8 +575,7 @@ array_ops_sub(
 	const real_t* src,
 	size_t len
 ) {
-	for( ; len != 0; --len, ++dst, ++src)
-		*dst -= (*src);
+	array_ops_kernels()->sub(dst, src, len);
 }
 
 
@@ -422,8 +586,7 @@ array_ops_scaled_add(
 	size_t len,
 	real_t factor
 ) {
-	for( ; len != 0; --len, ++dst, ++src)
-		*dst = fma(factor, *src, *dst);
+	array_ops_kernels()->scaled_add(dst, src, len, factor);
 }
 
 
@@ -433,8 +596,7 @@ array_ops_mul(
 	const real_t* src,
 	size_t len
 ) {
-	for( ; len != 0; --len, ++dst, ++src)
-		*dst *= (*src);
+	array_ops_kernels()->mul(dst, src, len);
 }
 
 
@@ -444,8 +606,7 @@ array_ops_div(
 	const real_t* src,
 	size_t len
 ) {
-	for( ; len != 0; --len, ++dst, ++src)
-		*dst /= (*src);
+	array_ops_kernels()->div(dst, src, len);
 }
 
 
@@ -455,8 +616,7 @@ array_ops_min(
 	const real_t* src,
 	size_t len
 ) {
-	for( ; len != 0; --len, ++dst, ++src)
-		*dst = fmin(*dst, *src);
+	array_ops_kernels()->min(dst, src, len);
 }
 
 
@@ -467,8 +627,7 @@ array_ops_scaled_min(
 	size_t len,
 	real_t factor
 ) {
-	for( ; len != 0; --len, ++dst, ++src)
-		*dst = factor * fmin(*dst, *src);
+	array_ops_kernels()->scaled_min(dst, src, len, factor);
 }
 
 
@@ -478,8 +637,7 @@ array_ops_max(
 	const real_t* src,
 	size_t len
 ) {
-	for( ; len != 0; --len, ++dst, ++src)
-		*dst = fmax(*dst, *src);
+	array_ops_kernels()->max(dst, src, len);
 }
 
 
@@ -490,8 +648,7 @@ array_ops_scaled_max(
 	size_t len,
 	real_t factor
 ) {
-	for( ; len != 0; --len, ++dst, ++src)
-		*dst = factor * fmax(*dst, *src);
+	array_ops_kernels()->scaled_max(dst, src, len, factor);
 }
 
 
@@ -735,6 +892,91 @@ array_ops_strided_convolution__mirror(
 }
 
 
+
+/*
+ * Accumulates kernel[t] times the source rows t - first, for the taps t in
+ * [first, last], in the block of block_len values of dst
+ */
+
+static void
+array_ops_block_convolution_taps(
+	const ArrayOpsKernels* kernels,
+	real_t* dst,
+	const real_t* src,
+	const real_t* kernel,
+	size_t first,
+	size_t last,
+	size_t block_len,
+	size_t stride
+) {
+	for(size_t t = first; t <= last; ++t, src += stride)
+		kernels->scaled_add(dst, src, block_len, kernel[t]);
+}
+
+
+void
+array_ops_block_convolution__zero(
+	real_t* dst,
+	const real_t* src,
+	const real_t* kernel,
+	size_t len,
+	size_t kernel_len,
+	size_t block_len,
+	size_t dst_stride,
+	size_t src_stride
+) {
+	const ArrayOpsKernels* kernels = array_ops_kernels();
+	size_t half_len = kernel_len / 2;
+
+	for(size_t i = 0; i < len; ++i, dst += dst_stride) {
+		// Taps whose source rows i - half_len + t are in [0, len)
+		size_t first = (i < half_len) ? half_len - i : 0;
+		size_t last = (len - 1 - i < kernel_len - 1 - half_len) ? half_len + (len - 1 - i) : kernel_len - 1;
+		const real_t* src_row = src + (i + first - half_len) * src_stride;
+
+		kernels->scaled_copy(dst, src_row, block_len, kernel[first]);
+		array_ops_block_convolution_taps(kernels, dst, src_row + src_stride, kernel, first + 1, last, block_len, src_stride);
+	}
+}
+
+
+void
+array_ops_block_convolution__mirror(
+	real_t* dst,
+	const real_t* src,
+	const real_t* kernel,
+	size_t len,
+	size_t kernel_len,
+	size_t block_len,
+	size_t dst_stride,
+	size_t src_stride
+) {
+	const ArrayOpsKernels* kernels = array_ops_kernels();
+	size_t half_len = kernel_len / 2;
+
+	for(size_t i = 0; i < len; ++i, dst += dst_stride) {
+		// Taps whose source rows i - half_len + t are in [0, len)
+		size_t first = (i < half_len) ? half_len - i : 0;
+		size_t last = (len - 1 - i < kernel_len - 1 - half_len) ? half_len + (len - 1 - i) : kernel_len - 1;
+		const real_t* src_row = src + (i + first - half_len) * src_stride;
+
+		kernels->scaled_copy(dst, src_row, block_len, kernel[first]);
+		array_ops_block_convolution_taps(kernels, dst, src_row + src_stride, kernel, first + 1, last, block_len, src_stride);
+
+		// Taps before the first row, mirrored on rows 1, 2, ...
+		src_row = src + src_stride;
+		for(size_t t = first; t != 0; --t, src_row += src_stride)
+			kernels->scaled_add(dst, src_row, block_len, kernel[t - 1]);
+
+		// Taps after the last row, mirrored on rows len - 2, len - 3, ...
+		if (last < kernel_len - 1) {
+			src_row = src + (len - 2) * src_stride;
+			for(size_t t = last + 1; t < kernel_len; ++t, src_row -= src_stride)
+				kernels->scaled_add(dst, src_row, block_len, kernel[t]);
+		}
+	}
+}
+
 void
 array_ops_box_filter(
 	real_t* dst,
@@ -768,3 +1010,135 @@ array_ops_box_filter(
 		*dst = acc / filter_size;
 	}
 }
+
+
+void
+array_ops_block_box_filter(
+	real_t* dst,
+	const real_t* src,
+	size_t len,
+	size_t filter_size,
+	size_t block_len,
+	size_t dst_stride,
+	size_t src_stride
+) {
+	assert(block_len <= ARRAY_OPS_BOX_FILTER_BLOCK_LEN);
+
+	size_t n = filter_size / 2;
+
+	// Left part
+	real_t acc[ARRAY_OPS_BOX_FILTER_BLOCK_LEN];
+	for(size_t j = 0; j < block_len; ++j)
+		acc[j] = (real_t)0;
+
+	for(size_t i = n; i != 0; --i, src += src_stride)
+		for(size_t j = 0; j < block_len; ++j)
+			acc[j] += src[j];
+
+	for(size_t i = n + 1; i != 0; --i, src += src_stride, dst += dst_stride)
+		for(size_t j = 0; j < block_len; ++j) {
+			acc[j] += src[j];
+			dst[j] = acc[j] / filter_size;
+		}
+
+	// Center part
+	const real_t* tail = src - filter_size * src_stride;
+	for(size_t i = len - filter_size; i != 0; --i, src += src_stride, tail += src_stride, dst += dst_stride)
+		for(size_t j = 0; j < block_len; ++j) {
+			acc[j] += src[j];
+			acc[j] -= tail[j];
+			dst[j] = acc[j] / filter_size;
+		}
+
+	// Right part
+	for(size_t i = n; i != 0; --i, tail += src_stride, dst += dst_stride)
+		for(size_t j = 0; j < block_len; ++j) {
+			acc[j] -= tail[j];
+			dst[j] = acc[j] / filter_size;
+		}
+}
+
+
+size_t
+array_ops_iterated_box_filter_buffer_len(
+	const size_t* filter_sizes,
+	size_t pass_count,
+	size_t block_len
+) {
+	// A row of zeros, then for each pass its sums, compensations, output row
+	// and ring of its filter_size last inputs
+	size_t ret = 1;
+	for(size_t i = 0; i < pass_count; ++i)
+		ret += filter_sizes[i] + 3;
+
+	return ret * block_len;
+}
+
+
+void
+array_ops_block_iterated_box_filter(
+	real_t* dst,
+	const real_t* src,
+	size_t len,
+	const size_t* filter_sizes,
+	size_t pass_count,
+	size_t block_len,
+	size_t dst_stride,
+	size_t src_stride,
+	real_t* buffer
+) {
+	assert(block_len <= ARRAY_OPS_BOX_FILTER_BLOCK_LEN);
+	assert(pass_count > 0);
+
+	const ArrayOpsKernels* kernels = array_ops_kernels();
+
+	array_ops_fill(
+		buffer,
+		array_ops_iterated_box_filter_buffer_len(filter_sizes, pass_count, block_len),
+		(real_t)0
+	);
+
+	const real_t* zeros = buffer;
+	real_t* pass_buffer = buffer + block_len;
+
+	// The pass i reads its input at index t - delay, and writes its output
+	// at index t - delay - filter_sizes[i] / 2
+	size_t delay = 0;
+	for(size_t i = 0; i < pass_count; ++i)
+		delay += filter_sizes[i] / 2;
+
+	for(size_t t = 0; t < len + delay; ++t) {
+		const real_t* head = (t < len) ? src + t * src_stride : zeros;
+		real_t* pass_ptr = pass_buffer;
+
+		size_t pass_delay = 0;
+		for(size_t i = 0; i < pass_count && pass_delay <= t; ++i) {
+			size_t filter_size = filter_sizes[i];
+			size_t input_index = t - pass_delay;
+
+			real_t* sum = pass_ptr;
+			real_t* comp = sum + block_len;
+			real_t* out = comp + block_len;
+			real_t* ring = out + block_len;
+			pass_ptr = ring + filter_size * block_len;
+
+			// The last pass writes its output to dst, once it is defined
+			size_t output_delay = pass_delay + filter_size / 2;
+			if ((i == pass_count - 1) && (output_delay <= t))
+				out = dst + (t - output_delay) * dst_stride;
+
+			kernels->box_filter_step(
+				out,
+				sum,
+				comp,
+				ring + (input_index % filter_size) * block_len,
+				(input_index < len) ? head : zeros,
+				block_len,
+				(real_t)filter_size
+			);
+
+			head = out;
+			pass_delay = output_delay;
+		}
+	}
+}
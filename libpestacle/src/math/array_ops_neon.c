@@ -0,0 +1,631 @@
+#include <math.h>
+#include <float.h>
+#include <SDL_cpuinfo.h>
+#include <pestacle/math/array_ops_backend.h>
+#include <pestacle/math/fast_math.h>
+
+#ifdef ARRAY_OPS_HAS_NEON_BACKEND
+
+#include <arm_neon.h>
+
+
+/******************************************************************************
+  NEON backend. Always available on AArch64, requires -mfpu=neon on 32 bits
+  ARM. The tails of the arrays are handled by the scalar backend.
+ *****************************************************************************/
+
+
+_Static_assert(sizeof(real_t) == sizeof(float), "the NEON backend processes single precision values");
+
+
+#define SCALAR_KERNELS array_ops_scalar_backend.kernels
+
+
+// --- Horizontal reductions ---------------------------------------------------
+
+static inline real_t
+neon_horizontal_sum(
+	float32x4_t v
+) {
+	#ifdef __aarch64__
+	return vaddvq_f32(v);
+	#else
+	float32x2_t u = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+	return vget_lane_f32(vpadd_f32(u, u), 0);
+	#endif
+}
+
+
+static inline real_t
+neon_horizontal_min(
+	float32x4_t v
+) {
+	#ifdef __aarch64__
+	return vminvq_f32(v);
+	#else
+	float32x2_t u = vmin_f32(vget_low_f32(v), vget_high_f32(v));
+	return vget_lane_f32(vpmin_f32(u, u), 0);
+	#endif
+}
+
+
+static inline real_t
+neon_horizontal_max(
+	float32x4_t v
+) {
+	#ifdef __aarch64__
+	return vmaxvq_f32(v);
+	#else
+	float32x2_t u = vmax_f32(vget_low_f32(v), vget_high_f32(v));
+	return vget_lane_f32(vpmax_f32(u, u), 0);
+	#endif
+}
+
+
+// --- Transcendental functions, see pestacle/math/fast_math.h ----------------
+
+static inline float32x4_t
+neon_floor(
+	float32x4_t v
+) {
+	#ifdef __aarch64__
+	return vrndmq_f32(v);
+	#else
+	// Only used on the clamped inputs of neon_exp, which fit in an int32_t
+	float32x4_t t = vcvtq_f32_s32(vcvtq_s32_f32(v));
+	float32x4_t one = vdupq_n_f32((real_t)1);
+	return vsubq_f32(t, vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(t, v), vreinterpretq_u32_f32(one))));
+	#endif
+}
+
+
+static inline float32x4_t
+neon_exp(
+	float32x4_t x
+) {
+	float32x4_t hi = vdupq_n_f32(FAST_MATH_EXP_HI);
+	float32x4_t lo = vdupq_n_f32(FAST_MATH_EXP_LO);
+	float32x4_t t = vbslq_f32(vcltq_f32(x, hi), x, hi);
+	t = vbslq_f32(vcgtq_f32(t, lo), t, lo);
+
+	float32x4_t n = neon_floor(vaddq_f32(vmulq_f32(t, vdupq_n_f32(FAST_MATH_LOG2E)), vdupq_n_f32((real_t).5)));
+	float32x4_t r = vsubq_f32(t, vmulq_f32(n, vdupq_n_f32(FAST_MATH_LN2_HI)));
+	r = vsubq_f32(r, vmulq_f32(n, vdupq_n_f32(FAST_MATH_LN2_LO)));
+
+	float32x4_t z = vmulq_f32(r, r);
+	float32x4_t p = vdupq_n_f32(FAST_MATH_EXP_P0);
+	p = vaddq_f32(vmulq_f32(p, r), vdupq_n_f32(FAST_MATH_EXP_P1));
+	p = vaddq_f32(vmulq_f32(p, r), vdupq_n_f32(FAST_MATH_EXP_P2));
+	p = vaddq_f32(vmulq_f32(p, r), vdupq_n_f32(FAST_MATH_EXP_P3));
+	p = vaddq_f32(vmulq_f32(p, r), vdupq_n_f32(FAST_MATH_EXP_P4));
+	p = vaddq_f32(vmulq_f32(p, r), vdupq_n_f32(FAST_MATH_EXP_P5));
+	p = vaddq_f32(vmulq_f32(p, z), r);
+	p = vaddq_f32(p, vdupq_n_f32((real_t)1));
+
+	int32x4_t bits = vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(127)), 23);
+	p = vmulq_f32(p, vreinterpretq_f32_s32(bits));
+
+	p = vbslq_f32(vcgtq_f32(x, hi), vdupq_n_f32(INFINITY), p);
+	p = vbslq_f32(vcltq_f32(x, lo), vdupq_n_f32((real_t)0), p);
+	p = vbslq_f32(vceqq_f32(x, x), p, x);
+
+	return p;
+}
+
+
+static inline float32x4_t
+neon_log(
+	float32x4_t x
+) {
+	float32x4_t one = vdupq_n_f32((real_t)1);
+	float32x4_t min = vdupq_n_f32(FLT_MIN);
+	float32x4_t t = vbslq_f32(vcgtq_f32(x, min), x, min);
+
+	uint32x4_t bits = vreinterpretq_u32_f32(t);
+	float32x4_t e = vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(126)));
+	bits = vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007fffff)), vdupq_n_u32(0x3f000000));
+	float32x4_t m = vreinterpretq_f32_u32(bits);
+
+	uint32x4_t is_low = vcltq_f32(m, vdupq_n_f32(FAST_MATH_SQRTHF));
+	e = vsubq_f32(e, vreinterpretq_f32_u32(vandq_u32(is_low, vreinterpretq_u32_f32(one))));
+	float32x4_t low_m = vreinterpretq_f32_u32(vandq_u32(is_low, vreinterpretq_u32_f32(m)));
+	m = vsubq_f32(m, one);
+	m = vaddq_f32(m, low_m);
+
+	float32x4_t z = vmulq_f32(m, m);
+	float32x4_t y = vdupq_n_f32(FAST_MATH_LOG_P0);
+	y = vaddq_f32(vmulq_f32(y, m), vdupq_n_f32(FAST_MATH_LOG_P1));
+	y = vaddq_f32(vmulq_f32(y, m), vdupq_n_f32(FAST_MATH_LOG_P2));
+	y = vaddq_f32(vmulq_f32(y, m), vdupq_n_f32(FAST_MATH_LOG_P3));
+	y = vaddq_f32(vmulq_f32(y, m), vdupq_n_f32(FAST_MATH_LOG_P4));
+	y = vaddq_f32(vmulq_f32(y, m), vdupq_n_f32(FAST_MATH_LOG_P5));
+	y = vaddq_f32(vmulq_f32(y, m), vdupq_n_f32(FAST_MATH_LOG_P6));
+	y = vaddq_f32(vmulq_f32(y, m), vdupq_n_f32(FAST_MATH_LOG_P7));
+	y = vaddq_f32(vmulq_f32(y, m), vdupq_n_f32(FAST_MATH_LOG_P8));
+	y = vmulq_f32(y, m);
+	y = vmulq_f32(y, z);
+	y = vaddq_f32(y, vmulq_f32(e, vdupq_n_f32(FAST_MATH_LN2_LO)));
+	y = vaddq_f32(y, vmulq_f32(z, vdupq_n_f32((real_t)-.5)));
+
+	float32x4_t ret = vaddq_f32(m, y);
+	ret = vaddq_f32(ret, vmulq_f32(e, vdupq_n_f32(FAST_MATH_LN2_HI)));
+
+	float32x4_t zero = vdupq_n_f32((real_t)0);
+	ret = vbslq_f32(vceqq_f32(x, vdupq_n_f32(INFINITY)), vdupq_n_f32(INFINITY), ret);
+	ret = vbslq_f32(vceqq_f32(x, zero), vdupq_n_f32(-INFINITY), ret);
+	ret = vbslq_f32(vcgeq_f32(x, zero), ret, vdupq_n_f32(NAN));
+
+	return ret;
+}
+
+
+// --- NEON backend -----------------------------------------------------------
+
+static bool
+neon_is_supported() {
+	return SDL_HasNEON();
+}
+
+
+static void
+neon_fill(
+	real_t* dst,
+	size_t len,
+	real_t value
+) {
+	float32x4_t v = vdupq_n_f32(value);
+	for( ; len >= 4; len -= 4, dst += 4)
+		vst1q_f32(dst, v);
+
+	SCALAR_KERNELS.fill(dst, len, value);
+}
+
+
+static void
+neon_copy(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		vst1q_f32(dst, vld1q_f32(src));
+
+	SCALAR_KERNELS.copy(dst, src, len);
+}
+
+
+static void
+neon_transpose(
+	real_t* dst,
+	const real_t* src,
+	size_t row_count,
+	size_t col_count,
+	size_t dst_stride,
+	size_t src_stride
+) {
+	// 4x4 blocks
+	size_t row_block_count = row_count - row_count % 4;
+	size_t col_block_count = col_count - col_count % 4;
+
+	for(size_t i = 0; i < row_block_count; i += 4) {
+		const real_t* src_ptr = src + i * src_stride;
+		real_t* dst_ptr = dst + i;
+
+		for(size_t j = 0; j < col_block_count; j += 4, src_ptr += 4, dst_ptr += 4 * dst_stride) {
+			float32x4x2_t t01 = vtrnq_f32(vld1q_f32(src_ptr), vld1q_f32(src_ptr + src_stride));
+			float32x4x2_t t23 = vtrnq_f32(vld1q_f32(src_ptr + 2 * src_stride), vld1q_f32(src_ptr + 3 * src_stride));
+
+			vst1q_f32(dst_ptr, vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0])));
+			vst1q_f32(dst_ptr + dst_stride, vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1])));
+			vst1q_f32(dst_ptr + 2 * dst_stride, vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0])));
+			vst1q_f32(dst_ptr + 3 * dst_stride, vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1])));
+		}
+	}
+
+	// Right and bottom edges
+	SCALAR_KERNELS.transpose(dst + col_block_count * dst_stride, src + col_block_count, row_count, col_count - col_block_count, dst_stride, src_stride);
+	SCALAR_KERNELS.transpose(dst + row_block_count, src + row_block_count * src_stride, row_count - row_block_count, col_block_count, dst_stride, src_stride);
+}
+
+
+static void
+neon_heaviside(
+	real_t* dst,
+	size_t len,
+	real_t threshold
+) {
+	float32x4_t t = vdupq_n_f32(threshold);
+	float32x4_t zero = vdupq_n_f32((real_t)0);
+	float32x4_t one = vdupq_n_f32((real_t)1);
+	for( ; len >= 4; len -= 4, dst += 4) {
+		float32x4_t x = vld1q_f32(dst);
+		vst1q_f32(dst, vbslq_f32(vcltq_f32(x, t), zero, one));
+	}
+
+	SCALAR_KERNELS.heaviside(dst, len, threshold);
+}
+
+
+static void
+neon_inc(
+	real_t* dst,
+	size_t len,
+	real_t shift
+) {
+	float32x4_t s = vdupq_n_f32(shift);
+	for( ; len >= 4; len -= 4, dst += 4)
+		vst1q_f32(dst, vaddq_f32(vld1q_f32(dst), s));
+
+	SCALAR_KERNELS.inc(dst, len, shift);
+}
+
+
+static void
+neon_scale(
+	real_t* dst,
+	size_t len,
+	real_t factor
+) {
+	float32x4_t k = vdupq_n_f32(factor);
+	for( ; len >= 4; len -= 4, dst += 4)
+		vst1q_f32(dst, vmulq_f32(vld1q_f32(dst), k));
+
+	SCALAR_KERNELS.scale(dst, len, factor);
+}
+
+
+static void
+neon_scaled_copy(
+	real_t* dst,
+	const real_t* src,
+	size_t len,
+	real_t factor
+) {
+	float32x4_t k = vdupq_n_f32(factor);
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		vst1q_f32(dst, vmulq_f32(k, vld1q_f32(src)));
+
+	SCALAR_KERNELS.scaled_copy(dst, src, len, factor);
+}
+
+
+static real_t
+neon_reduction_min(
+	const real_t* src,
+	size_t len
+) {
+	if (len < 4)
+		return SCALAR_KERNELS.reduction_min(src, len);
+
+	float32x4_t acc = vld1q_f32(src);
+	for(len -= 4, src += 4; len >= 4; len -= 4, src += 4)
+		acc = vminq_f32(acc, vld1q_f32(src));
+
+	real_t ret = neon_horizontal_min(acc);
+	if (len != 0)
+		ret = fminf(ret, SCALAR_KERNELS.reduction_min(src, len));
+
+	return ret;
+}
+
+
+static real_t
+neon_reduction_max(
+	const real_t* src,
+	size_t len
+) {
+	if (len < 4)
+		return SCALAR_KERNELS.reduction_max(src, len);
+
+	float32x4_t acc = vld1q_f32(src);
+	for(len -= 4, src += 4; len >= 4; len -= 4, src += 4)
+		acc = vmaxq_f32(acc, vld1q_f32(src));
+
+	real_t ret = neon_horizontal_max(acc);
+	if (len != 0)
+		ret = fmaxf(ret, SCALAR_KERNELS.reduction_max(src, len));
+
+	return ret;
+}
+
+
+static real_t
+neon_reduction_sum(
+	const real_t* src,
+	size_t len
+) {
+	if (len < 8)
+		return SCALAR_KERNELS.reduction_sum(src, len);
+
+	// Two accumulators, to hide the latency of the additions
+	float32x4_t acc0 = vld1q_f32(src);
+	float32x4_t acc1 = vld1q_f32(src + 4);
+	for(len -= 8, src += 8; len >= 8; len -= 8, src += 8) {
+		acc0 = vaddq_f32(acc0, vld1q_f32(src));
+		acc1 = vaddq_f32(acc1, vld1q_f32(src + 4));
+	}
+
+	real_t ret = neon_horizontal_sum(vaddq_f32(acc0, acc1));
+	for( ; len != 0; --len, ++src)
+		ret += (*src);
+
+	return ret;
+}
+
+
+static real_t
+neon_reduction_square_sum(
+	const real_t* src,
+	size_t len
+) {
+	if (len < 8)
+		return SCALAR_KERNELS.reduction_square_sum(src, len);
+
+	// Two accumulators, to hide the latency of the additions
+	float32x4_t acc0 = vmulq_f32(vld1q_f32(src), vld1q_f32(src));
+	float32x4_t acc1 = vmulq_f32(vld1q_f32(src + 4), vld1q_f32(src + 4));
+	for(len -= 8, src += 8; len >= 8; len -= 8, src += 8) {
+		acc0 = vaddq_f32(acc0, vmulq_f32(vld1q_f32(src), vld1q_f32(src)));
+		acc1 = vaddq_f32(acc1, vmulq_f32(vld1q_f32(src + 4), vld1q_f32(src + 4)));
+	}
+
+	real_t ret = neon_horizontal_sum(vaddq_f32(acc0, acc1));
+	for( ; len != 0; --len, ++src)
+		ret += (*src) * (*src);
+
+	return ret;
+}
+
+
+static void
+neon_add(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		vst1q_f32(dst, vaddq_f32(vld1q_f32(dst), vld1q_f32(src)));
+
+	SCALAR_KERNELS.add(dst, src, len);
+}
+
+
+static void
+neon_sub(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		vst1q_f32(dst, vsubq_f32(vld1q_f32(dst), vld1q_f32(src)));
+
+	SCALAR_KERNELS.sub(dst, src, len);
+}
+
+
+static void
+neon_scaled_add(
+	real_t* dst,
+	const real_t* src,
+	size_t len,
+	real_t factor
+) {
+	// Fused multiply-add is only guaranteed on AArch64
+	#ifdef __aarch64__
+	float32x4_t k = vdupq_n_f32(factor);
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		vst1q_f32(dst, vfmaq_f32(vld1q_f32(dst), k, vld1q_f32(src)));
+	#endif
+
+	SCALAR_KERNELS.scaled_add(dst, src, len, factor);
+}
+
+
+static void
+neon_mul(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		vst1q_f32(dst, vmulq_f32(vld1q_f32(dst), vld1q_f32(src)));
+
+	SCALAR_KERNELS.mul(dst, src, len);
+}
+
+
+static void
+neon_div(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	// No vector division before AArch64
+	#ifdef __aarch64__
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		vst1q_f32(dst, vdivq_f32(vld1q_f32(dst), vld1q_f32(src)));
+	#endif
+
+	SCALAR_KERNELS.div(dst, src, len);
+}
+
+
+static void
+neon_min(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		vst1q_f32(dst, vminq_f32(vld1q_f32(dst), vld1q_f32(src)));
+
+	SCALAR_KERNELS.min(dst, src, len);
+}
+
+
+static void
+neon_scaled_min(
+	real_t* dst,
+	const real_t* src,
+	size_t len,
+	real_t factor
+) {
+	float32x4_t k = vdupq_n_f32(factor);
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		vst1q_f32(dst, vmulq_f32(k, vminq_f32(vld1q_f32(dst), vld1q_f32(src))));
+
+	SCALAR_KERNELS.scaled_min(dst, src, len, factor);
+}
+
+
+static void
+neon_max(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		vst1q_f32(dst, vmaxq_f32(vld1q_f32(dst), vld1q_f32(src)));
+
+	SCALAR_KERNELS.max(dst, src, len);
+}
+
+
+static void
+neon_scaled_max(
+	real_t* dst,
+	const real_t* src,
+	size_t len,
+	real_t factor
+) {
+	float32x4_t k = vdupq_n_f32(factor);
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		vst1q_f32(dst, vmulq_f32(k, vmaxq_f32(vld1q_f32(dst), vld1q_f32(src))));
+
+	SCALAR_KERNELS.scaled_max(dst, src, len, factor);
+}
+
+
+static void
+neon_box_filter_step(
+	real_t* dst,
+	real_t* sum,
+	real_t* comp,
+	real_t* tail,
+	const real_t* head,
+	size_t len,
+	real_t filter_size
+) {
+	// Division is only available on AArch64
+	#ifdef __aarch64__
+	float32x4_t k = vdupq_n_f32(filter_size);
+	for( ; len >= 4; len -= 4, dst += 4, sum += 4, comp += 4, tail += 4, head += 4) {
+		float32x4_t h = vld1q_f32(head);
+		float32x4_t s = vld1q_f32(sum);
+		float32x4_t x = vsubq_f32(h, vld1q_f32(tail));
+		float32x4_t t = vaddq_f32(s, x);
+
+		// Compensate with the smallest of the two terms
+		uint32x4_t is_larger = vcgeq_f32(vabsq_f32(s), vabsq_f32(x));
+		float32x4_t a = vbslq_f32(is_larger, s, x);
+		float32x4_t b = vbslq_f32(is_larger, x, s);
+		float32x4_t c = vaddq_f32(vld1q_f32(comp), vaddq_f32(vsubq_f32(a, t), b));
+
+		vst1q_f32(sum, t);
+		vst1q_f32(comp, c);
+		vst1q_f32(tail, h);
+		vst1q_f32(dst, vdivq_f32(vaddq_f32(t, c), k));
+	}
+	#endif
+
+	SCALAR_KERNELS.box_filter_step(dst, sum, comp, tail, head, len, filter_size);
+}
+
+
+static void
+neon_square_root(
+	real_t* dst,
+	size_t len
+) {
+	#ifdef __aarch64__
+	for( ; len >= 4; len -= 4, dst += 4)
+		vst1q_f32(dst, vsqrtq_f32(vld1q_f32(dst)));
+	#endif
+
+	SCALAR_KERNELS.square_root(dst, len);
+}
+
+
+static void
+neon_fast_exp(
+	real_t* dst,
+	size_t len
+) {
+	for( ; len >= 4; len -= 4, dst += 4)
+		vst1q_f32(dst, neon_exp(vld1q_f32(dst)));
+
+	SCALAR_KERNELS.fast_exp(dst, len);
+}
+
+
+static void
+neon_fast_log(
+	real_t* dst,
+	size_t len
+) {
+	for( ; len >= 4; len -= 4, dst += 4)
+		vst1q_f32(dst, neon_log(vld1q_f32(dst)));
+
+	SCALAR_KERNELS.fast_log(dst, len);
+}
+
+
+static void
+neon_fast_pow(
+	real_t* dst,
+	size_t len,
+	real_t exponent
+) {
+	float32x4_t y = vdupq_n_f32(exponent);
+	for( ; len >= 4; len -= 4, dst += 4)
+		vst1q_f32(dst, neon_exp(vmulq_f32(y, neon_log(vld1q_f32(dst)))));
+
+	SCALAR_KERNELS.fast_pow(dst, len, exponent);
+}
+
+
+const ArrayOpsBackend
+array_ops_neon_backend = {
+	"neon",
+	neon_is_supported,
+	{
+		neon_fill,
+		neon_copy,
+		neon_transpose,
+		neon_heaviside,
+		neon_inc,
+		neon_scale,
+		neon_scaled_copy,
+		neon_reduction_min,
+		neon_reduction_max,
+		neon_reduction_sum,
+		neon_reduction_square_sum,
+		neon_add,
+		neon_sub,
+		neon_scaled_add,
+		neon_mul,
+		neon_div,
+		neon_min,
+		neon_scaled_min,
+		neon_max,
+		neon_scaled_max,
+		neon_box_filter_step,
+		neon_square_root,
+		neon_fast_exp,
+		neon_fast_log,
+		neon_fast_pow
+	}
+};
+
+
+#endif /* ARRAY_OPS_HAS_NEON_BACKEND */
@@ -0,0 +1,352 @@
+#include <tgmath.h>
+#include <pestacle/math/array_ops_backend.h>
+#include <pestacle/math/fast_math.h>
+
+
+static bool
+scalar_is_supported() {
+	return true;
+}
+
+
+static void
+scalar_fill(
+	real_t* dst,
+	size_t len,
+	real_t value
+) {
+	for( ; len != 0; --len, ++dst)
+		*dst = value;
+}
+
+
+static void
+scalar_copy(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len != 0; --len, ++dst, ++src)
+		*dst = *src;
+}
+
+
+static void
+scalar_transpose(
+	real_t* dst,
+	const real_t* src,
+	size_t row_count,
+	size_t col_count,
+	size_t dst_stride,
+	size_t src_stride
+) {
+	for(size_t i = 0; i < row_count; ++i, ++dst, src += src_stride) {
+		real_t* dst_ptr = dst;
+		for(size_t j = 0; j < col_count; ++j, dst_ptr += dst_stride)
+			*dst_ptr = src[j];
+	}
+}
+
+
+static void
+scalar_heaviside(
+	real_t* dst,
+	size_t len,
+	real_t threshold
+) {
+	for( ; len != 0; --len, ++dst) {
+		if (*dst < threshold)
+			*dst = (real_t)0;
+		else
+			*dst = (real_t)1;
+	}
+}
+
+
+static void
+scalar_inc(
+	real_t* dst,
+	size_t len,
+	real_t shift
+) {
+	for( ; len != 0; --len, ++dst)
+		*dst += shift;
+}
+
+
+static void
+scalar_scale(
+	real_t* dst,
+	size_t len,
+	real_t factor
+) {
+	for( ; len != 0; --len, ++dst)
+		*dst *= factor;
+}
+
+
+static void
+scalar_scaled_copy(
+	real_t* dst,
+	const real_t* src,
+	size_t len,
+	real_t factor
+) {
+	for( ; len != 0; --len, ++dst, ++src)
+		*dst = factor * (*src);
+}
+
+
+static real_t
+scalar_reduction_min(
+	const real_t* src,
+	size_t len
+) {
+	real_t ret = *src;
+	for(--len, ++src; len != 0; --len, ++src)
+		ret = fmin(ret, *src);
+
+	return ret;
+}
+
+
+static real_t
+scalar_reduction_max(
+	const real_t* src,
+	size_t len
+) {
+	real_t ret = *src;
+	for(--len, ++src; len != 0; --len, ++src)
+		ret = fmax(ret, *src);
+
+	return ret;
+}
+
+
+static real_t
+scalar_reduction_sum(
+	const real_t* src,
+	size_t len
+) {
+	real_t ret = (*src);
+	for(--len, ++src; len != 0; --len, ++src)
+		ret += (*src);
+
+	return ret;
+}
+
+
+static real_t
+scalar_reduction_square_sum(
+	const real_t* src,
+	size_t len
+) {
+	real_t ret = (*src) * (*src);
+	for(--len, ++src; len != 0; --len, ++src)
+		ret = fma(*src, *src, ret);
+
+	return ret;
+}
+
+
+static void
+scalar_add(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len != 0; --len, ++dst, ++src)
+		*dst += (*src);
+}
+
+
+static void
+scalar_sub(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len != 0; --len, ++dst, ++src)
+		*dst -= (*src);
+}
+
+
+static void
+scalar_scaled_add(
+	real_t* dst,
+	const real_t* src,
+	size_t len,
+	real_t factor
+) {
+	for( ; len != 0; --len, ++dst, ++src)
+		*dst = fma(factor, *src, *dst);
+}
+
+
+static void
+scalar_mul(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len != 0; --len, ++dst, ++src)
+		*dst *= (*src);
+}
+
+
+static void
+scalar_div(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len != 0; --len, ++dst, ++src)
+		*dst /= (*src);
+}
+
+
+static void
+scalar_min(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len != 0; --len, ++dst, ++src)
+		*dst = fmin(*dst, *src);
+}
+
+
+static void
+scalar_scaled_min(
+	real_t* dst,
+	const real_t* src,
+	size_t len,
+	real_t factor
+) {
+	for( ; len != 0; --len, ++dst, ++src)
+		*dst = factor * fmin(*dst, *src);
+}
+
+
+static void
+scalar_max(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len != 0; --len, ++dst, ++src)
+		*dst = fmax(*dst, *src);
+}
+
+
+static void
+scalar_scaled_max(
+	real_t* dst,
+	const real_t* src,
+	size_t len,
+	real_t factor
+) {
+	for( ; len != 0; --len, ++dst, ++src)
+		*dst = factor * fmax(*dst, *src);
+}
+
+
+static void
+scalar_box_filter_step(
+	real_t* dst,
+	real_t* sum,
+	real_t* comp,
+	real_t* tail,
+	const real_t* head,
+	size_t len,
+	real_t filter_size
+) {
+	for( ; len != 0; --len, ++dst, ++sum, ++comp, ++tail, ++head) {
+		real_t x = *head - *tail;
+		real_t t = *sum + x;
+
+		if (fabs(*sum) >= fabs(x))
+			*comp += (*sum - t) + x;
+		else
+			*comp += (x - t) + *sum;
+
+		*sum = t;
+		*tail = *head;
+		*dst = (*sum + *comp) / filter_size;
+	}
+}
+
+
+static void
+scalar_square_root(
+	real_t* dst,
+	size_t len
+) {
+	for( ; len != 0; --len, ++dst)
+		*dst = sqrt(*dst);
+}
+
+
+static void
+scalar_fast_exp(
+	real_t* dst,
+	size_t len
+) {
+	for( ; len != 0; --len, ++dst)
+		*dst = fast_exp(*dst);
+}
+
+
+static void
+scalar_fast_log(
+	real_t* dst,
+	size_t len
+) {
+	for( ; len != 0; --len, ++dst)
+		*dst = fast_log(*dst);
+}
+
+
+static void
+scalar_fast_pow(
+	real_t* dst,
+	size_t len,
+	real_t exponent
+) {
+	for( ; len != 0; --len, ++dst)
+		*dst = fast_pow(*dst, exponent);
+}
+
+
+const ArrayOpsBackend
+array_ops_scalar_backend = {
+	"scalar",
+	scalar_is_supported,
+	{
+		scalar_fill,
+		scalar_copy,
+		scalar_transpose,
+		scalar_heaviside,
+		scalar_inc,
+		scalar_scale,
+		scalar_scaled_copy,
+		scalar_reduction_min,
+		scalar_reduction_max,
+		scalar_reduction_sum,
+		scalar_reduction_square_sum,
+		scalar_add,
+		scalar_sub,
+		scalar_scaled_add,
+		scalar_mul,
+		scalar_div,
+		scalar_min,
+		scalar_scaled_min,
+		scalar_max,
+		scalar_scaled_max,
+		scalar_box_filter_step,
+		scalar_square_root,
+		scalar_fast_exp,
+		scalar_fast_log,
+		scalar_fast_pow
+	}
+};
@@ -0,0 +1,1205 @@
+#include <math.h>
+#include <float.h>
+#include <SDL_cpuinfo.h>
+#include <pestacle/math/array_ops_backend.h>
+#include <pestacle/math/fast_math.h>
+
+#ifdef ARRAY_OPS_HAS_X86_BACKENDS
+
+#include <immintrin.h>
+
+
+/******************************************************************************
+  SSE4.1 and AVX2 backends. The kernels are compiled with function level
+  target attributes, so that the rest of the library is built for the
+  baseline instruction set. The tails of the arrays are handled by the scalar
+  backend. The AVX2 kernels clear the upper halves of the registers before
+  running any SSE code, which the compiler does not do when not optimizing.
+  The AVX2 backend also uses the FMA instructions.
+ *****************************************************************************/
+
+
+_Static_assert(sizeof(real_t) == sizeof(float), "the x86 backends process single precision values");
+
+
+#define SSE41_TARGET __attribute__((target("sse4.1")))
+#define AVX2_TARGET __attribute__((target("avx2")))
+#define AVX2_FMA_TARGET __attribute__((target("avx2,fma")))
+
+#define SCALAR_KERNELS array_ops_scalar_backend.kernels
+
+
+// --- Horizontal reductions --------------------------------------------------
+
+SSE41_TARGET static inline real_t
+sse41_horizontal_sum(
+	__m128 v
+) {
+	v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+	v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+	return _mm_cvtss_f32(v);
+}
+
+
+SSE41_TARGET static inline real_t
+sse41_horizontal_min(
+	__m128 v
+) {
+	v = _mm_min_ps(v, _mm_movehl_ps(v, v));
+	v = _mm_min_ss(v, _mm_shuffle_ps(v, v, 1));
+	return _mm_cvtss_f32(v);
+}
+
+
+SSE41_TARGET static inline real_t
+sse41_horizontal_max(
+	__m128 v
+) {
+	v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+	v = _mm_max_ss(v, _mm_shuffle_ps(v, v, 1));
+	return _mm_cvtss_f32(v);
+}
+
+
+AVX2_TARGET static inline real_t
+avx2_horizontal_sum(
+	__m256 v
+) {
+	return sse41_horizontal_sum(_mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+}
+
+
+AVX2_TARGET static inline real_t
+avx2_horizontal_min(
+	__m256 v
+) {
+	return sse41_horizontal_min(_mm_min_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+}
+
+
+AVX2_TARGET static inline real_t
+avx2_horizontal_max(
+	__m256 v
+) {
+	return sse41_horizontal_max(_mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+}
+
+
+// --- Transcendental functions, see pestacle/math/fast_math.h ----------------
+
+SSE41_TARGET static inline __m128
+sse41_exp_ps(
+	__m128 x
+) {
+	__m128 t = _mm_min_ps(x, _mm_set1_ps(FAST_MATH_EXP_HI));
+	t = _mm_max_ps(t, _mm_set1_ps(FAST_MATH_EXP_LO));
+
+	__m128 n = _mm_floor_ps(_mm_add_ps(_mm_mul_ps(t, _mm_set1_ps(FAST_MATH_LOG2E)), _mm_set1_ps((real_t).5)));
+	__m128 r = _mm_sub_ps(t, _mm_mul_ps(n, _mm_set1_ps(FAST_MATH_LN2_HI)));
+	r = _mm_sub_ps(r, _mm_mul_ps(n, _mm_set1_ps(FAST_MATH_LN2_LO)));
+
+	__m128 z = _mm_mul_ps(r, r);
+	__m128 p = _mm_set1_ps(FAST_MATH_EXP_P0);
+	p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(FAST_MATH_EXP_P1));
+	p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(FAST_MATH_EXP_P2));
+	p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(FAST_MATH_EXP_P3));
+	p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(FAST_MATH_EXP_P4));
+	p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(FAST_MATH_EXP_P5));
+	p = _mm_add_ps(_mm_mul_ps(p, z), r);
+	p = _mm_add_ps(p, _mm_set1_ps((real_t)1));
+
+	__m128i bits = _mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(n), _mm_set1_epi32(127)), 23);
+	p = _mm_mul_ps(p, _mm_castsi128_ps(bits));
+
+	p = _mm_blendv_ps(p, _mm_set1_ps(INFINITY), _mm_cmpgt_ps(x, _mm_set1_ps(FAST_MATH_EXP_HI)));
+	p = _mm_blendv_ps(p, _mm_setzero_ps(), _mm_cmplt_ps(x, _mm_set1_ps(FAST_MATH_EXP_LO)));
+	p = _mm_blendv_ps(p, x, _mm_cmpunord_ps(x, x));
+
+	return p;
+}
+
+
+SSE41_TARGET static inline __m128
+sse41_log_ps(
+	__m128 x
+) {
+	__m128 one = _mm_set1_ps((real_t)1);
+	__m128 t = _mm_max_ps(x, _mm_set1_ps(FLT_MIN));
+
+	__m128i bits = _mm_castps_si128(t);
+	__m128 e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(126)));
+	bits = _mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f000000));
+	__m128 m = _mm_castsi128_ps(bits);
+
+	__m128 is_low = _mm_cmplt_ps(m, _mm_set1_ps(FAST_MATH_SQRTHF));
+	e = _mm_sub_ps(e, _mm_and_ps(is_low, one));
+	__m128 low_m = _mm_and_ps(is_low, m);
+	m = _mm_sub_ps(m, one);
+	m = _mm_add_ps(m, low_m);
+
+	__m128 z = _mm_mul_ps(m, m);
+	__m128 y = _mm_set1_ps(FAST_MATH_LOG_P0);
+	y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(FAST_MATH_LOG_P1));
+	y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(FAST_MATH_LOG_P2));
+	y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(FAST_MATH_LOG_P3));
+	y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(FAST_MATH_LOG_P4));
+	y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(FAST_MATH_LOG_P5));
+	y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(FAST_MATH_LOG_P6));
+	y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(FAST_MATH_LOG_P7));
+	y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(FAST_MATH_LOG_P8));
+	y = _mm_mul_ps(y, m);
+	y = _mm_mul_ps(y, z);
+	y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(FAST_MATH_LN2_LO)));
+	y = _mm_add_ps(y, _mm_mul_ps(z, _mm_set1_ps((real_t)-.5)));
+
+	__m128 ret = _mm_add_ps(m, y);
+	ret = _mm_add_ps(ret, _mm_mul_ps(e, _mm_set1_ps(FAST_MATH_LN2_HI)));
+
+	__m128 zero = _mm_setzero_ps();
+	ret = _mm_blendv_ps(ret, _mm_set1_ps(INFINITY), _mm_cmpeq_ps(x, _mm_set1_ps(INFINITY)));
+	ret = _mm_blendv_ps(ret, _mm_set1_ps(-INFINITY), _mm_cmpeq_ps(x, zero));
+	ret = _mm_blendv_ps(ret, _mm_set1_ps(NAN), _mm_cmpnge_ps(x, zero));
+
+	return ret;
+}
+
+
+AVX2_TARGET static inline __m256
+avx2_exp_ps(
+	__m256 x
+) {
+	__m256 t = _mm256_min_ps(x, _mm256_set1_ps(FAST_MATH_EXP_HI));
+	t = _mm256_max_ps(t, _mm256_set1_ps(FAST_MATH_EXP_LO));
+
+	__m256 n = _mm256_floor_ps(_mm256_add_ps(_mm256_mul_ps(t, _mm256_set1_ps(FAST_MATH_LOG2E)), _mm256_set1_ps((real_t).5)));
+	__m256 r = _mm256_sub_ps(t, _mm256_mul_ps(n, _mm256_set1_ps(FAST_MATH_LN2_HI)));
+	r = _mm256_sub_ps(r, _mm256_mul_ps(n, _mm256_set1_ps(FAST_MATH_LN2_LO)));
+
+	__m256 z = _mm256_mul_ps(r, r);
+	__m256 p = _mm256_set1_ps(FAST_MATH_EXP_P0);
+	p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(FAST_MATH_EXP_P1));
+	p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(FAST_MATH_EXP_P2));
+	p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(FAST_MATH_EXP_P3));
+	p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(FAST_MATH_EXP_P4));
+	p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(FAST_MATH_EXP_P5));
+	p = _mm256_add_ps(_mm256_mul_ps(p, z), r);
+	p = _mm256_add_ps(p, _mm256_set1_ps((real_t)1));
+
+	__m256i bits = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvttps_epi32(n), _mm256_set1_epi32(127)), 23);
+	p = _mm256_mul_ps(p, _mm256_castsi256_ps(bits));
+
+	p = _mm256_blendv_ps(p, _mm256_set1_ps(INFINITY), _mm256_cmp_ps(x, _mm256_set1_ps(FAST_MATH_EXP_HI), _CMP_GT_OQ));
+	p = _mm256_blendv_ps(p, _mm256_setzero_ps(), _mm256_cmp_ps(x, _mm256_set1_ps(FAST_MATH_EXP_LO), _CMP_LT_OQ));
+	p = _mm256_blendv_ps(p, x, _mm256_cmp_ps(x, x, _CMP_UNORD_Q));
+
+	return p;
+}
+
+
+AVX2_TARGET static inline __m256
+avx2_log_ps(
+	__m256 x
+) {
+	__m256 one = _mm256_set1_ps((real_t)1);
+	__m256 t = _mm256_max_ps(x, _mm256_set1_ps(FLT_MIN));
+
+	__m256i bits = _mm256_castps_si256(t);
+	__m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126)));
+	bits = _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)), _mm256_set1_epi32(0x3f000000));
+	__m256 m = _mm256_castsi256_ps(bits);
+
+	__m256 is_low = _mm256_cmp_ps(m, _mm256_set1_ps(FAST_MATH_SQRTHF), _CMP_LT_OQ);
+	e = _mm256_sub_ps(e, _mm256_and_ps(is_low, one));
+	__m256 low_m = _mm256_and_ps(is_low, m);
+	m = _mm256_sub_ps(m, one);
+	m = _mm256_add_ps(m, low_m);
+
+	__m256 z = _mm256_mul_ps(m, m);
+	__m256 y = _mm256_set1_ps(FAST_MATH_LOG_P0);
+	y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(FAST_MATH_LOG_P1));
+	y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(FAST_MATH_LOG_P2));
+	y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(FAST_MATH_LOG_P3));
+	y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(FAST_MATH_LOG_P4));
+	y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(FAST_MATH_LOG_P5));
+	y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(FAST_MATH_LOG_P6));
+	y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(FAST_MATH_LOG_P7));
+	y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(FAST_MATH_LOG_P8));
+	y = _mm256_mul_ps(y, m);
+	y = _mm256_mul_ps(y, z);
+	y = _mm256_add_ps(y, _mm256_mul_ps(e, _mm256_set1_ps(FAST_MATH_LN2_LO)));
+	y = _mm256_add_ps(y, _mm256_mul_ps(z, _mm256_set1_ps((real_t)-.5)));
+
+	__m256 ret = _mm256_add_ps(m, y);
+	ret = _mm256_add_ps(ret, _mm256_mul_ps(e, _mm256_set1_ps(FAST_MATH_LN2_HI)));
+
+	__m256 zero = _mm256_setzero_ps();
+	ret = _mm256_blendv_ps(ret, _mm256_set1_ps(INFINITY), _mm256_cmp_ps(x, _mm256_set1_ps(INFINITY), _CMP_EQ_OQ));
+	ret = _mm256_blendv_ps(ret, _mm256_set1_ps(-INFINITY), _mm256_cmp_ps(x, zero, _CMP_EQ_OQ));
+	ret = _mm256_blendv_ps(ret, _mm256_set1_ps(NAN), _mm256_cmp_ps(x, zero, _CMP_NGE_UQ));
+
+	return ret;
+}
+
+
+// --- SSE4.1 backend ---------------------------------------------------------
+
+static bool
+sse41_is_supported() {
+	return SDL_HasSSE41();
+}
+
+
+SSE41_TARGET static void
+sse41_fill(
+	real_t* dst,
+	size_t len,
+	real_t value
+) {
+	__m128 v = _mm_set1_ps(value);
+	for( ; len >= 4; len -= 4, dst += 4)
+		_mm_storeu_ps(dst, v);
+
+	SCALAR_KERNELS.fill(dst, len, value);
+}
+
+
+SSE41_TARGET static void
+sse41_copy(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		_mm_storeu_ps(dst, _mm_loadu_ps(src));
+
+	SCALAR_KERNELS.copy(dst, src, len);
+}
+
+
+SSE41_TARGET static void
+sse41_transpose(
+	real_t* dst,
+	const real_t* src,
+	size_t row_count,
+	size_t col_count,
+	size_t dst_stride,
+	size_t src_stride
+) {
+	// 4x4 blocks
+	size_t row_block_count = row_count - row_count % 4;
+	size_t col_block_count = col_count - col_count % 4;
+
+	for(size_t i = 0; i < row_block_count; i += 4) {
+		const real_t* src_ptr = src + i * src_stride;
+		real_t* dst_ptr = dst + i;
+
+		for(size_t j = 0; j < col_block_count; j += 4, src_ptr += 4, dst_ptr += 4 * dst_stride) {
+			__m128 r0 = _mm_loadu_ps(src_ptr);
+			__m128 r1 = _mm_loadu_ps(src_ptr + src_stride);
+			__m128 r2 = _mm_loadu_ps(src_ptr + 2 * src_stride);
+			__m128 r3 = _mm_loadu_ps(src_ptr + 3 * src_stride);
+
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+			_mm_storeu_ps(dst_ptr, r0);
+			_mm_storeu_ps(dst_ptr + dst_stride, r1);
+			_mm_storeu_ps(dst_ptr + 2 * dst_stride, r2);
+			_mm_storeu_ps(dst_ptr + 3 * dst_stride, r3);
+		}
+	}
+
+	// Right and bottom edges
+	SCALAR_KERNELS.transpose(dst + col_block_count * dst_stride, src + col_block_count, row_count, col_count - col_block_count, dst_stride, src_stride);
+	SCALAR_KERNELS.transpose(dst + row_block_count, src + row_block_count * src_stride, row_count - row_block_count, col_block_count, dst_stride, src_stride);
+}
+
+
+SSE41_TARGET static void
+sse41_heaviside(
+	real_t* dst,
+	size_t len,
+	real_t threshold
+) {
+	__m128 t = _mm_set1_ps(threshold);
+	__m128 zero = _mm_setzero_ps();
+	__m128 one = _mm_set1_ps((real_t)1);
+	for( ; len >= 4; len -= 4, dst += 4) {
+		__m128 x = _mm_loadu_ps(dst);
+		_mm_storeu_ps(dst, _mm_blendv_ps(one, zero, _mm_cmplt_ps(x, t)));
+	}
+
+	SCALAR_KERNELS.heaviside(dst, len, threshold);
+}
+
+
+SSE41_TARGET static void
+sse41_inc(
+	real_t* dst,
+	size_t len,
+	real_t shift
+) {
+	__m128 s = _mm_set1_ps(shift);
+	for( ; len >= 4; len -= 4, dst += 4)
+		_mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), s));
+
+	SCALAR_KERNELS.inc(dst, len, shift);
+}
+
+
+SSE41_TARGET static void
+sse41_scale(
+	real_t* dst,
+	size_t len,
+	real_t factor
+) {
+	__m128 k = _mm_set1_ps(factor);
+	for( ; len >= 4; len -= 4, dst += 4)
+		_mm_storeu_ps(dst, _mm_mul_ps(_mm_loadu_ps(dst), k));
+
+	SCALAR_KERNELS.scale(dst, len, factor);
+}
+
+
+SSE41_TARGET static void
+sse41_scaled_copy(
+	real_t* dst,
+	const real_t* src,
+	size_t len,
+	real_t factor
+) {
+	__m128 k = _mm_set1_ps(factor);
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		_mm_storeu_ps(dst, _mm_mul_ps(k, _mm_loadu_ps(src)));
+
+	SCALAR_KERNELS.scaled_copy(dst, src, len, factor);
+}
+
+
+SSE41_TARGET static real_t
+sse41_reduction_min(
+	const real_t* src,
+	size_t len
+) {
+	if (len < 4)
+		return SCALAR_KERNELS.reduction_min(src, len);
+
+	__m128 acc = _mm_loadu_ps(src);
+	for(len -= 4, src += 4; len >= 4; len -= 4, src += 4)
+		acc = _mm_min_ps(acc, _mm_loadu_ps(src));
+
+	real_t ret = sse41_horizontal_min(acc);
+	if (len != 0)
+		ret = fminf(ret, SCALAR_KERNELS.reduction_min(src, len));
+
+	return ret;
+}
+
+
+SSE41_TARGET static real_t
+sse41_reduction_max(
+	const real_t* src,
+	size_t len
+) {
+	if (len < 4)
+		return SCALAR_KERNELS.reduction_max(src, len);
+
+	__m128 acc = _mm_loadu_ps(src);
+	for(len -= 4, src += 4; len >= 4; len -= 4, src += 4)
+		acc = _mm_max_ps(acc, _mm_loadu_ps(src));
+
+	real_t ret = sse41_horizontal_max(acc);
+	if (len != 0)
+		ret = fmaxf(ret, SCALAR_KERNELS.reduction_max(src, len));
+
+	return ret;
+}
+
+
+SSE41_TARGET static real_t
+sse41_reduction_sum(
+	const real_t* src,
+	size_t len
+) {
+	if (len < 8)
+		return SCALAR_KERNELS.reduction_sum(src, len);
+
+	// Two accumulators, to hide the latency of the additions
+	__m128 acc0 = _mm_loadu_ps(src);
+	__m128 acc1 = _mm_loadu_ps(src + 4);
+	for(len -= 8, src += 8; len >= 8; len -= 8, src += 8) {
+		acc0 = _mm_add_ps(acc0, _mm_loadu_ps(src));
+		acc1 = _mm_add_ps(acc1, _mm_loadu_ps(src + 4));
+	}
+
+	real_t ret = sse41_horizontal_sum(_mm_add_ps(acc0, acc1));
+	for( ; len != 0; --len, ++src)
+		ret += (*src);
+
+	return ret;
+}
+
+
+SSE41_TARGET static real_t
+sse41_reduction_square_sum(
+	const real_t* src,
+	size_t len
+) {
+	if (len < 8)
+		return SCALAR_KERNELS.reduction_square_sum(src, len);
+
+	// Two accumulators, to hide the latency of the additions
+	__m128 acc0 = _mm_mul_ps(_mm_loadu_ps(src), _mm_loadu_ps(src));
+	__m128 acc1 = _mm_mul_ps(_mm_loadu_ps(src + 4), _mm_loadu_ps(src + 4));
+	for(len -= 8, src += 8; len >= 8; len -= 8, src += 8) {
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(src), _mm_loadu_ps(src)));
+		acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(src + 4), _mm_loadu_ps(src + 4)));
+	}
+
+	real_t ret = sse41_horizontal_sum(_mm_add_ps(acc0, acc1));
+	for( ; len != 0; --len, ++src)
+		ret += (*src) * (*src);
+
+	return ret;
+}
+
+
+SSE41_TARGET static void
+sse41_add(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		_mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_loadu_ps(src)));
+
+	SCALAR_KERNELS.add(dst, src, len);
+}
+
+
+SSE41_TARGET static void
+sse41_sub(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		_mm_storeu_ps(dst, _mm_sub_ps(_mm_loadu_ps(dst), _mm_loadu_ps(src)));
+
+	SCALAR_KERNELS.sub(dst, src, len);
+}
+
+
+static void
+sse41_scaled_add(
+	real_t* dst,
+	const real_t* src,
+	size_t len,
+	real_t factor
+) {
+	// No fused multiply-add before AVX2
+	SCALAR_KERNELS.scaled_add(dst, src, len, factor);
+}
+
+
+SSE41_TARGET static void
+sse41_mul(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		_mm_storeu_ps(dst, _mm_mul_ps(_mm_loadu_ps(dst), _mm_loadu_ps(src)));
+
+	SCALAR_KERNELS.mul(dst, src, len);
+}
+
+
+SSE41_TARGET static void
+sse41_div(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		_mm_storeu_ps(dst, _mm_div_ps(_mm_loadu_ps(dst), _mm_loadu_ps(src)));
+
+	SCALAR_KERNELS.div(dst, src, len);
+}
+
+
+SSE41_TARGET static void
+sse41_min(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		_mm_storeu_ps(dst, _mm_min_ps(_mm_loadu_ps(dst), _mm_loadu_ps(src)));
+
+	SCALAR_KERNELS.min(dst, src, len);
+}
+
+
+SSE41_TARGET static void
+sse41_scaled_min(
+	real_t* dst,
+	const real_t* src,
+	size_t len,
+	real_t factor
+) {
+	__m128 k = _mm_set1_ps(factor);
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		_mm_storeu_ps(dst, _mm_mul_ps(k, _mm_min_ps(_mm_loadu_ps(dst), _mm_loadu_ps(src))));
+
+	SCALAR_KERNELS.scaled_min(dst, src, len, factor);
+}
+
+
+SSE41_TARGET static void
+sse41_max(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		_mm_storeu_ps(dst, _mm_max_ps(_mm_loadu_ps(dst), _mm_loadu_ps(src)));
+
+	SCALAR_KERNELS.max(dst, src, len);
+}
+
+
+SSE41_TARGET static void
+sse41_scaled_max(
+	real_t* dst,
+	const real_t* src,
+	size_t len,
+	real_t factor
+) {
+	__m128 k = _mm_set1_ps(factor);
+	for( ; len >= 4; len -= 4, dst += 4, src += 4)
+		_mm_storeu_ps(dst, _mm_mul_ps(k, _mm_max_ps(_mm_loadu_ps(dst), _mm_loadu_ps(src))));
+
+	SCALAR_KERNELS.scaled_max(dst, src, len, factor);
+}
+
+
+SSE41_TARGET static void
+sse41_box_filter_step(
+	real_t* dst,
+	real_t* sum,
+	real_t* comp,
+	real_t* tail,
+	const real_t* head,
+	size_t len,
+	real_t filter_size
+) {
+	__m128 k = _mm_set1_ps(filter_size);
+	__m128 sign = _mm_set1_ps(-0.f);
+	for( ; len >= 4; len -= 4, dst += 4, sum += 4, comp += 4, tail += 4, head += 4) {
+		__m128 h = _mm_loadu_ps(head);
+		__m128 s = _mm_loadu_ps(sum);
+		__m128 x = _mm_sub_ps(h, _mm_loadu_ps(tail));
+		__m128 t = _mm_add_ps(s, x);
+
+		// Compensate with the smallest of the two terms
+		__m128 is_larger = _mm_cmpge_ps(_mm_andnot_ps(sign, s), _mm_andnot_ps(sign, x));
+		__m128 a = _mm_blendv_ps(x, s, is_larger);
+		__m128 b = _mm_blendv_ps(s, x, is_larger);
+		__m128 c = _mm_add_ps(_mm_loadu_ps(comp), _mm_add_ps(_mm_sub_ps(a, t), b));
+
+		_mm_storeu_ps(sum, t);
+		_mm_storeu_ps(comp, c);
+		_mm_storeu_ps(tail, h);
+		_mm_storeu_ps(dst, _mm_div_ps(_mm_add_ps(t, c), k));
+	}
+
+	SCALAR_KERNELS.box_filter_step(dst, sum, comp, tail, head, len, filter_size);
+}
+
+
+SSE41_TARGET static void
+sse41_square_root(
+	real_t* dst,
+	size_t len
+) {
+	for( ; len >= 4; len -= 4, dst += 4)
+		_mm_storeu_ps(dst, _mm_sqrt_ps(_mm_loadu_ps(dst)));
+
+	SCALAR_KERNELS.square_root(dst, len);
+}
+
+
+SSE41_TARGET static void
+sse41_fast_exp(
+	real_t* dst,
+	size_t len
+) {
+	for( ; len >= 4; len -= 4, dst += 4)
+		_mm_storeu_ps(dst, sse41_exp_ps(_mm_loadu_ps(dst)));
+
+	SCALAR_KERNELS.fast_exp(dst, len);
+}
+
+
+SSE41_TARGET static void
+sse41_fast_log(
+	real_t* dst,
+	size_t len
+) {
+	for( ; len >= 4; len -= 4, dst += 4)
+		_mm_storeu_ps(dst, sse41_log_ps(_mm_loadu_ps(dst)));
+
+	SCALAR_KERNELS.fast_log(dst, len);
+}
+
+
+SSE41_TARGET static void
+sse41_fast_pow(
+	real_t* dst,
+	size_t len,
+	real_t exponent
+) {
+	__m128 y = _mm_set1_ps(exponent);
+	for( ; len >= 4; len -= 4, dst += 4)
+		_mm_storeu_ps(dst, sse41_exp_ps(_mm_mul_ps(y, sse41_log_ps(_mm_loadu_ps(dst)))));
+
+	SCALAR_KERNELS.fast_pow(dst, len, exponent);
+}
+
+
+const ArrayOpsBackend
+array_ops_sse41_backend = {
+	"sse4.1",
+	sse41_is_supported,
+	{
+		sse41_fill,
+		sse41_copy,
+		sse41_transpose,
+		sse41_heaviside,
+		sse41_inc,
+		sse41_scale,
+		sse41_scaled_copy,
+		sse41_reduction_min,
+		sse41_reduction_max,
+		sse41_reduction_sum,
+		sse41_reduction_square_sum,
+		sse41_add,
+		sse41_sub,
+		sse41_scaled_add,
+		sse41_mul,
+		sse41_div,
+		sse41_min,
+		sse41_scaled_min,
+		sse41_max,
+		sse41_scaled_max,
+		sse41_box_filter_step,
+		sse41_square_root,
+		sse41_fast_exp,
+		sse41_fast_log,
+		sse41_fast_pow
+	}
+};
+
+// --- AVX2 backend -----------------------------------------------------------
+
+static bool
+avx2_is_supported() {
+	// The processors supporting AVX2 also support FMA, but the two are
+	// reported separately
+	return SDL_HasAVX2() && __builtin_cpu_supports("fma");
+}
+
+
+AVX2_TARGET static void
+avx2_fill(
+	real_t* dst,
+	size_t len,
+	real_t value
+) {
+	__m256 v = _mm256_set1_ps(value);
+	for( ; len >= 8; len -= 8, dst += 8)
+		_mm256_storeu_ps(dst, v);
+
+	_mm256_zeroupper();
+	SCALAR_KERNELS.fill(dst, len, value);
+}
+
+
+AVX2_TARGET static void
+avx2_copy(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len >= 8; len -= 8, dst += 8, src += 8)
+		_mm256_storeu_ps(dst, _mm256_loadu_ps(src));
+
+	_mm256_zeroupper();
+	SCALAR_KERNELS.copy(dst, src, len);
+}
+
+
+AVX2_TARGET static void
+avx2_transpose(
+	real_t* dst,
+	const real_t* src,
+	size_t row_count,
+	size_t col_count,
+	size_t dst_stride,
+	size_t src_stride
+) {
+	// 8x8 blocks
+	size_t row_block_count = row_count - row_count % 8;
+	size_t col_block_count = col_count - col_count % 8;
+
+	for(size_t i = 0; i < row_block_count; i += 8) {
+		const real_t* src_ptr = src + i * src_stride;
+		real_t* dst_ptr = dst + i;
+
+		for(size_t j = 0; j < col_block_count; j += 8, src_ptr += 8, dst_ptr += 8 * dst_stride) {
+			__m256 r[8], t[8];
+			for(size_t k = 0; k < 8; ++k)
+				r[k] = _mm256_loadu_ps(src_ptr + k * src_stride);
+
+			// Interleave the pairs of rows, then the pairs of pairs, then
+			// swap the 128 bits halves
+			for(size_t k = 0; k < 8; k += 2) {
+				t[k] = _mm256_unpacklo_ps(r[k], r[k + 1]);
+				t[k + 1] = _mm256_unpackhi_ps(r[k], r[k + 1]);
+			}
+
+			for(size_t k = 0; k < 8; k += 4) {
+				r[k] = _mm256_shuffle_ps(t[k], t[k + 2], _MM_SHUFFLE(1, 0, 1, 0));
+				r[k + 1] = _mm256_shuffle_ps(t[k], t[k + 2], _MM_SHUFFLE(3, 2, 3, 2));
+				r[k + 2] = _mm256_shuffle_ps(t[k + 1], t[k + 3], _MM_SHUFFLE(1, 0, 1, 0));
+				r[k + 3] = _mm256_shuffle_ps(t[k + 1], t[k + 3], _MM_SHUFFLE(3, 2, 3, 2));
+			}
+
+			for(size_t k = 0; k < 4; ++k) {
+				_mm256_storeu_ps(dst_ptr + k * dst_stride, _mm256_permute2f128_ps(r[k], r[k + 4], 0x20));
+				_mm256_storeu_ps(dst_ptr + (k + 4) * dst_stride, _mm256_permute2f128_ps(r[k], r[k + 4], 0x31));
+			}
+		}
+	}
+
+	_mm256_zeroupper();
+
+	// Right and bottom edges
+	SCALAR_KERNELS.transpose(dst + col_block_count * dst_stride, src + col_block_count, row_count, col_count - col_block_count, dst_stride, src_stride);
+	SCALAR_KERNELS.transpose(dst + row_block_count, src + row_block_count * src_stride, row_count - row_block_count, col_block_count, dst_stride, src_stride);
+}
+
+
+AVX2_TARGET static void
+avx2_heaviside(
+	real_t* dst,
+	size_t len,
+	real_t threshold
+) {
+	__m256 t = _mm256_set1_ps(threshold);
+	__m256 zero = _mm256_setzero_ps();
+	__m256 one = _mm256_set1_ps((real_t)1);
+	for( ; len >= 8; len -= 8, dst += 8) {
+		__m256 x = _mm256_loadu_ps(dst);
+		_mm256_storeu_ps(dst, _mm256_blendv_ps(one, zero, _mm256_cmp_ps(x, t, _CMP_LT_OQ)));
+	}
+
+	_mm256_zeroupper();
+	SCALAR_KERNELS.heaviside(dst, len, threshold);
+}
+
+
+AVX2_TARGET static void
+avx2_inc(
+	real_t* dst,
+	size_t len,
+	real_t shift
+) {
+	__m256 s = _mm256_set1_ps(shift);
+	for( ; len >= 8; len -= 8, dst += 8)
+		_mm256_storeu_ps(dst, _mm256_add_ps(_mm256_loadu_ps(dst), s));
+
+	_mm256_zeroupper();
+	SCALAR_KERNELS.inc(dst, len, shift);
+}
+
+
+AVX2_TARGET static void
+avx2_scale(
+	real_t* dst,
+	size_t len,
+	real_t factor
+) {
+	__m256 k = _mm256_set1_ps(factor);
+	for( ; len >= 8; len -= 8, dst += 8)
+		_mm256_storeu_ps(dst, _mm256_mul_ps(_mm256_loadu_ps(dst), k));
+
+	_mm256_zeroupper();
+	SCALAR_KERNELS.scale(dst, len, factor);
+}
+
+
+AVX2_TARGET static void
+avx2_scaled_copy(
+	real_t* dst,
+	const real_t* src,
+	size_t len,
+	real_t factor
+) {
+	__m256 k = _mm256_set1_ps(factor);
+	for( ; len >= 8; len -= 8, dst += 8, src += 8)
+		_mm256_storeu_ps(dst, _mm256_mul_ps(k, _mm256_loadu_ps(src)));
+
+	_mm256_zeroupper();
+	SCALAR_KERNELS.scaled_copy(dst, src, len, factor);
+}
+
+
+AVX2_TARGET static real_t
+avx2_reduction_min(
+	const real_t* src,
+	size_t len
+) {
+	if (len < 8)
+		return SCALAR_KERNELS.reduction_min(src, len);
+
+	__m256 acc = _mm256_loadu_ps(src);
+	for(len -= 8, src += 8; len >= 8; len -= 8, src += 8)
+		acc = _mm256_min_ps(acc, _mm256_loadu_ps(src));
+
+	real_t ret = avx2_horizontal_min(acc);
+	_mm256_zeroupper();
+	if (len != 0)
+		ret = fminf(ret, SCALAR_KERNELS.reduction_min(src, len));
+
+	return ret;
+}
+
+
+AVX2_TARGET static real_t
+avx2_reduction_max(
+	const real_t* src,
+	size_t len
+) {
+	if (len < 8)
+		return SCALAR_KERNELS.reduction_max(src, len);
+
+	__m256 acc = _mm256_loadu_ps(src);
+	for(len -= 8, src += 8; len >= 8; len -= 8, src += 8)
+		acc = _mm256_max_ps(acc, _mm256_loadu_ps(src));
+
+	real_t ret = avx2_horizontal_max(acc);
+	_mm256_zeroupper();
+	if (len != 0)
+		ret = fmaxf(ret, SCALAR_KERNELS.reduction_max(src, len));
+
+	return ret;
+}
+
+
+AVX2_TARGET static real_t
+avx2_reduction_sum(
+	const real_t* src,
+	size_t len
+) {
+	if (len < 16)
+		return SCALAR_KERNELS.reduction_sum(src, len);
+
+	// Two accumulators, to hide the latency of the additions
+	__m256 acc0 = _mm256_loadu_ps(src);
+	__m256 acc1 = _mm256_loadu_ps(src + 8);
+	for(len -= 16, src += 16; len >= 16; len -= 16, src += 16) {
+		acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(src));
+		acc1 = _mm256_add_ps(acc1, _mm256_loadu_ps(src + 8));
+	}
+
+	real_t ret = avx2_horizontal_sum(_mm256_add_ps(acc0, acc1));
+	_mm256_zeroupper();
+	for( ; len != 0; --len, ++src)
+		ret += (*src);
+
+	return ret;
+}
+
+
+AVX2_TARGET static real_t
+avx2_reduction_square_sum(
+	const real_t* src,
+	size_t len
+) {
+	if (len < 16)
+		return SCALAR_KERNELS.reduction_square_sum(src, len);
+
+	// Two accumulators, to hide the latency of the additions
+	__m256 acc0 = _mm256_mul_ps(_mm256_loadu_ps(src), _mm256_loadu_ps(src));
+	__m256 acc1 = _mm256_mul_ps(_mm256_loadu_ps(src + 8), _mm256_loadu_ps(src + 8));
+	for(len -= 16, src += 16; len >= 16; len -= 16, src += 16) {
+		acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(src), _mm256_loadu_ps(src)));
+		acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(src + 8), _mm256_loadu_ps(src + 8)));
+	}
+
+	real_t ret = avx2_horizontal_sum(_mm256_add_ps(acc0, acc1));
+	_mm256_zeroupper();
+	for( ; len != 0; --len, ++src)
+		ret += (*src) * (*src);
+
+	return ret;
+}
+
+
+AVX2_TARGET static void
+avx2_add(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len >= 8; len -= 8, dst += 8, src += 8)
+		_mm256_storeu_ps(dst, _mm256_add_ps(_mm256_loadu_ps(dst), _mm256_loadu_ps(src)));
+
+	_mm256_zeroupper();
+	SCALAR_KERNELS.add(dst, src, len);
+}
+
+
+AVX2_TARGET static void
+avx2_sub(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len >= 8; len -= 8, dst += 8, src += 8)
+		_mm256_storeu_ps(dst, _mm256_sub_ps(_mm256_loadu_ps(dst), _mm256_loadu_ps(src)));
+
+	_mm256_zeroupper();
+	SCALAR_KERNELS.sub(dst, src, len);
+}
+
+
+AVX2_FMA_TARGET static void
+avx2_scaled_add(
+	real_t* dst,
+	const real_t* src,
+	size_t len,
+	real_t factor
+) {
+	__m256 k = _mm256_set1_ps(factor);
+	for( ; len >= 8; len -= 8, dst += 8, src += 8)
+		_mm256_storeu_ps(dst, _mm256_fmadd_ps(k, _mm256_loadu_ps(src), _mm256_loadu_ps(dst)));
+
+	_mm256_zeroupper();
+	SCALAR_KERNELS.scaled_add(dst, src, len, factor);
+}
+
+
+AVX2_TARGET static void
+avx2_mul(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len >= 8; len -= 8, dst += 8, src += 8)
+		_mm256_storeu_ps(dst, _mm256_mul_ps(_mm256_loadu_ps(dst), _mm256_loadu_ps(src)));
+
+	_mm256_zeroupper();
+	SCALAR_KERNELS.mul(dst, src, len);
+}
+
+
+AVX2_TARGET static void
+avx2_div(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len >= 8; len -= 8, dst += 8, src += 8)
+		_mm256_storeu_ps(dst, _mm256_div_ps(_mm256_loadu_ps(dst), _mm256_loadu_ps(src)));
+
+	_mm256_zeroupper();
+	SCALAR_KERNELS.div(dst, src, len);
+}
+
+
+AVX2_TARGET static void
+avx2_min(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len >= 8; len -= 8, dst += 8, src += 8)
+		_mm256_storeu_ps(dst, _mm256_min_ps(_mm256_loadu_ps(dst), _mm256_loadu_ps(src)));
+
+	_mm256_zeroupper();
+	SCALAR_KERNELS.min(dst, src, len);
+}
+
+
+AVX2_TARGET static void
+avx2_scaled_min(
+	real_t* dst,
+	const real_t* src,
+	size_t len,
+	real_t factor
+) {
+	__m256 k = _mm256_set1_ps(factor);
+	for( ; len >= 8; len -= 8, dst += 8, src += 8)
+		_mm256_storeu_ps(dst, _mm256_mul_ps(k, _mm256_min_ps(_mm256_loadu_ps(dst), _mm256_loadu_ps(src))));
+
+	_mm256_zeroupper();
+	SCALAR_KERNELS.scaled_min(dst, src, len, factor);
+}
+
+
+AVX2_TARGET static void
+avx2_max(
+	real_t* dst,
+	const real_t* src,
+	size_t len
+) {
+	for( ; len >= 8; len -= 8, dst += 8, src += 8)
+		_mm256_storeu_ps(dst, _mm256_max_ps(_mm256_loadu_ps(dst), _mm256_loadu_ps(src)));
+
+	_mm256_zeroupper();
+	SCALAR_KERNELS.max(dst, src, len);
+}
+
+
+AVX2_TARGET static void
+avx2_scaled_max(
+	real_t* dst,
+	const real_t* src,
+	size_t len,
+	real_t factor
+) {
+	__m256 k = _mm256_set1_ps(factor);
+	for( ; len >= 8; len -= 8, dst += 8, src += 8)
+		_mm256_storeu_ps(dst, _mm256_mul_ps(k, _mm256_max_ps(_mm256_loadu_ps(dst), _mm256_loadu_ps(src))));
+
+	_mm256_zeroupper();
+	SCALAR_KERNELS.scaled_max(dst, src, len, factor);
+}
+
+
+AVX2_TARGET static void
+avx2_box_filter_step(
+	real_t* dst,
+	real_t* sum,
+	real_t* comp,
+	real_t* tail,
+	const real_t* head,
+	size_t len,
+	real_t filter_size
+) {
+	__m256 k = _mm256_set1_ps(filter_size);
+	__m256 sign = _mm256_set1_ps(-0.f);
+	for( ; len >= 8; len -= 8, dst += 8, sum += 8, comp += 8, tail += 8, head += 8) {
+		__m256 h = _mm256_loadu_ps(head);
+		__m256 s = _mm256_loadu_ps(sum);
+		__m256 x = _mm256_sub_ps(h, _mm256_loadu_ps(tail));
+		__m256 t = _mm256_add_ps(s, x);
+
+		// Compensate with the smallest of the two terms
+		__m256 is_larger = _mm256_cmp_ps(_mm256_andnot_ps(sign, s), _mm256_andnot_ps(sign, x), _CMP_GE_OQ);
+		__m256 a = _mm256_blendv_ps(x, s, is_larger);
+		__m256 b = _mm256_blendv_ps(s, x, is_larger);
+		__m256 c = _mm256_add_ps(_mm256_loadu_ps(comp), _mm256_add_ps(_mm256_sub_ps(a, t), b));
+
+		_mm256_storeu_ps(sum, t);
+		_mm256_storeu_ps(comp, c);
+		_mm256_storeu_ps(tail, h);
+		_mm256_storeu_ps(dst, _mm256_div_ps(_mm256_add_ps(t, c), k));
+	}
+
+	_mm256_zeroupper();
+	SCALAR_KERNELS.box_filter_step(dst, sum, comp, tail, head, len, filter_size);
+}
+
+
+AVX2_TARGET static void
+avx2_square_root(
+	real_t* dst,
+	size_t len
+) {
+	for( ; len >= 8; len -= 8, dst += 8)
+		_mm256_storeu_ps(dst, _mm256_sqrt_ps(_mm256_loadu_ps(dst)));
+
+	_mm256_zeroupper();
+	SCALAR_KERNELS.square_root(dst, len);
+}
+
+
+AVX2_TARGET static void
+avx2_fast_exp(
+	real_t* dst,
+	size_t len
+) {
+	for( ; len >= 8; len -= 8, dst += 8)
+		_mm256_storeu_ps(dst, avx2_exp_ps(_mm256_loadu_ps(dst)));
+
+	_mm256_zeroupper();
+	SCALAR_KERNELS.fast_exp(dst, len);
+}
+
+
+AVX2_TARGET static void
+avx2_fast_log(
+	real_t* dst,
+	size_t len
+) {
+	for( ; len >= 8; len -= 8, dst += 8)
+		_mm256_storeu_ps(dst, avx2_log_ps(_mm256_loadu_ps(dst)));
+
+	_mm256_zeroupper();
+	SCALAR_KERNELS.fast_log(dst, len);
+}
+
+
+AVX2_TARGET static void
+avx2_fast_pow(
+	real_t* dst,
+	size_t len,
+	real_t exponent
+) {
+	__m256 y = _mm256_set1_ps(exponent);
+	for( ; len >= 8; len -= 8, dst += 8)
+		_mm256_storeu_ps(dst, avx2_exp_ps(_mm256_mul_ps(y, avx2_log_ps(_mm256_loadu_ps(dst)))));
+
+	_mm256_zeroupper();
+	SCALAR_KERNELS.fast_pow(dst, len, exponent);
+}
+
+
+const ArrayOpsBackend
+array_ops_avx2_backend = {
+	"avx2",
+	avx2_is_supported,
+	{
+		avx2_fill,
+		avx2_copy,
+		avx2_transpose,
+		avx2_heaviside,
+		avx2_inc,
+		avx2_scale,
+		avx2_scaled_copy,
+		avx2_reduction_min,
+		avx2_reduction_max,
+		avx2_reduction_sum,
+		avx2_reduction_square_sum,
+		avx2_add,
+		avx2_sub,
+		avx2_scaled_add,
+		avx2_mul,
+		avx2_div,
+		avx2_min,
+		avx2_scaled_min,
+		avx2_max,
+		avx2_scaled_max,
+		avx2_box_filter_step,
+		avx2_square_root,
+		avx2_fast_exp,
+		avx2_fast_log,
+		avx2_fast_pow
+	}
+};
+
+
+#endif /* ARRAY_OPS_HAS_X86_BACKENDS */
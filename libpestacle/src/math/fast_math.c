@@ -0,0 +1,109 @@
+#include <math.h>
+#include <float.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pestacle/math/fast_math.h>
+
+
+/*
+ * The operations below are written in the order of the SIMD kernels, so that
+ * both give the same results.
+ */
+
+real_t
+fast_exp(real_t x) {
+	// Clamp the input, with the semantic of the SIMD min and max
+	real_t t = (x < FAST_MATH_EXP_HI) ? x : FAST_MATH_EXP_HI;
+	t = (t > FAST_MATH_EXP_LO) ? t : FAST_MATH_EXP_LO;
+
+	// Range reduction : x = n ln(2) + r, with |r| <= ln(2) / 2
+	real_t n = floorf(t * FAST_MATH_LOG2E + ((real_t).5));
+	real_t r = t - n * FAST_MATH_LN2_HI;
+	r = r - n * FAST_MATH_LN2_LO;
+
+	// exp(r) ~ 1 + r + r^2 P(r)
+	real_t z = r * r;
+	real_t p = FAST_MATH_EXP_P0;
+	p = p * r + FAST_MATH_EXP_P1;
+	p = p * r + FAST_MATH_EXP_P2;
+	p = p * r + FAST_MATH_EXP_P3;
+	p = p * r + FAST_MATH_EXP_P4;
+	p = p * r + FAST_MATH_EXP_P5;
+	p = p * z + r;
+	p = p + ((real_t)1);
+
+	// Multiply by 2^n, built from its exponent bits
+	uint32_t bits = ((uint32_t)((int32_t)n + 127)) << 23;
+	real_t scale;
+	memcpy(&scale, &bits, sizeof(scale));
+	p = p * scale;
+
+	// Out of range inputs
+	if (x > FAST_MATH_EXP_HI)
+		p = INFINITY;
+	if (x < FAST_MATH_EXP_LO)
+		p = (real_t)0;
+	if (x != x)
+		p = x;
+
+	return p;
+}
+
+
+real_t
+fast_log(real_t x) {
+	// x = m 2^e, with m in [1/2, 1)
+	real_t t = (x > FLT_MIN) ? x : FLT_MIN;
+
+	uint32_t bits;
+	memcpy(&bits, &t, sizeof(bits));
+	real_t e = (real_t)(((int32_t)(bits >> 23)) - 126);
+
+	bits = (bits & 0x007fffff) | 0x3f000000;
+	real_t m;
+	memcpy(&m, &bits, sizeof(m));
+
+	// Center the mantissa : x = (1 + m) 2^e, with m in [sqrt(1/2) - 1, sqrt(2) - 1)
+	bool is_low = m < FAST_MATH_SQRTHF;
+	e = e - (is_low ? ((real_t)1) : ((real_t)0));
+	real_t low_m = is_low ? m : ((real_t)0);
+	m = m - ((real_t)1);
+	m = m + low_m;
+
+	// log(1 + m) ~ m - m^2 / 2 + m^3 P(m)
+	real_t z = m * m;
+	real_t y = FAST_MATH_LOG_P0;
+	y = y * m + FAST_MATH_LOG_P1;
+	y = y * m + FAST_MATH_LOG_P2;
+	y = y * m + FAST_MATH_LOG_P3;
+	y = y * m + FAST_MATH_LOG_P4;
+	y = y * m + FAST_MATH_LOG_P5;
+	y = y * m + FAST_MATH_LOG_P6;
+	y = y * m + FAST_MATH_LOG_P7;
+	y = y * m + FAST_MATH_LOG_P8;
+	y = y * m;
+	y = y * z;
+	y = y + e * FAST_MATH_LN2_LO;
+	y = y + z * ((real_t)-.5);
+
+	// Add e ln(2)
+	real_t ret = m + y;
+	ret = ret + e * FAST_MATH_LN2_HI;
+
+	// Special values
+	if (x == INFINITY)
+		ret = INFINITY;
+	if (x == ((real_t)0))
+		ret = -INFINITY;
+	if (!(x >= ((real_t)0)))
+		ret = NAN;
+
+	return ret;
+}
+
+
+real_t
+fast_pow(real_t x, real_t y) {
+	return fast_exp(y * fast_log(x));
+}
@@ -0,0 +1,149 @@
+#include <tgmath.h>
+#include <assert.h>
+#include <pestacle/math/histogram.h>
+
+
+#define HISTOGRAM_HALF_SUB_BUCKET_COUNT (HISTOGRAM_SUB_BUCKET_COUNT / 2)
+
+
+static uint64_t
+Histogram_to_nanoseconds(
+	real_t x
+) {
+	if (x >= HISTOGRAM_MAX_DURATION)
+		return (((uint64_t)1) << HISTOGRAM_MAX_BITS) - 1;
+
+	return (uint64_t)(x * (real_t)1e9);
+}
+
+
+static size_t
+Histogram_bucket_index(
+	uint64_t x
+) {
+	// Values below the sub-bucket count have a bucket each
+	if (x < HISTOGRAM_SUB_BUCKET_COUNT)
+		return (size_t)x;
+
+	// Above, the bucket of x is selected by its leading bits
+	size_t shift = 0;
+	for(uint64_t y = x >> HISTOGRAM_SUB_BUCKET_BITS; y != 0; y >>= 1)
+		++shift;
+
+	return shift * HISTOGRAM_HALF_SUB_BUCKET_COUNT + (size_t)(x >> shift);
+}
+
+
+static uint64_t
+Histogram_bucket_upper_bound(
+	size_t index
+) {
+	if (index < HISTOGRAM_SUB_BUCKET_COUNT)
+		return (uint64_t)index;
+
+	size_t shift = index / HISTOGRAM_HALF_SUB_BUCKET_COUNT - 1;
+	uint64_t lower_bound = ((uint64_t)(index - shift * HISTOGRAM_HALF_SUB_BUCKET_COUNT)) << shift;
+
+	return lower_bound + (((uint64_t)1) << shift) - 1;
+}
+
+
+void
+Histogram_init(
+	Histogram* self
+) {
+	assert(self);
+
+	self->count = 0;
+	self->max = 0;
+	for(size_t i = 0; i < HISTOGRAM_BUCKET_COUNT; ++i)
+		self->bucket_counts[i] = 0;
+}
+
+
+void
+Histogram_accumulate(
+	Histogram* self,
+	real_t x
+) {
+	assert(self);
+	assert(x >= 0);
+	assert(!isnan(x));
+
+	uint64_t ns = Histogram_to_nanoseconds(x);
+
+	self->count += 1;
+	if (self->max < ns)
+		self->max = ns;
+	self->bucket_counts[Histogram_bucket_index(ns)] += 1;
+}
+
+
+size_t
+Histogram_count(
+	const Histogram* self
+) {
+	assert(self);
+
+	return (size_t)self->count;
+}
+
+
+real_t
+Histogram_max(
+	const Histogram* self
+) {
+	assert(self);
+
+	return ((real_t)self->max) * (real_t)1e-9;
+}
+
+
+real_t
+Histogram_percentile(
+	const Histogram* self,
+	real_t p
+) {
+	assert(self);
+	assert((p >= 0) && (p <= 1));
+
+	if (!self->count)
+		return (real_t)0;
+
+	// Rank of the requested duration, from 1 to count
+	uint64_t rank = (uint64_t)ceil(p * (real_t)self->count);
+	if (rank < 1)
+		rank = 1;
+	if (rank > self->count)
+		rank = self->count;
+
+	uint64_t count_sum = 0;
+	size_t index = 0;
+	for( ; index < HISTOGRAM_BUCKET_COUNT - 1; ++index) {
+		count_sum += self->bucket_counts[index];
+		if (count_sum >= rank)
+			break;
+	}
+
+	uint64_t ret = Histogram_bucket_upper_bound(index);
+	if (ret > self->max)
+		ret = self->max;
+
+	return ((real_t)ret) * (real_t)1e-9;
+}
+
+
+size_t
+Histogram_count_above(
+	const Histogram* self,
+	real_t x
+) {
+	assert(self);
+	assert(x >= 0);
+
+	uint64_t ret = 0;
+	for(size_t i = Histogram_bucket_index(Histogram_to_nanoseconds(x)) + 1; i < HISTOGRAM_BUCKET_COUNT; ++i)
+		ret += self->bucket_counts[i];
+
+	return (size_t)ret;
+}
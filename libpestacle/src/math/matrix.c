@@ -4,6 +4,137 @@
 #include <pestacle/math/matrix.h>
 
 
+// Minimum number of coefficients processed by a task of a parallel operation
+#define MATRIX_PARALLEL_GRAIN_SIZE 16384
+
+// Number of columns processed together by the column-wise operations
+#define MATRIX_COLWISE_BLOCK_LEN 128
+
+// Rows of the padded matrices are aligned on ARRAY_OPS_ALIGNMENT bytes
+#define MATRIX_ROW_ALIGNMENT (ARRAY_OPS_ALIGNMENT / sizeof(real_t))
+
+// Size of the square tiles of the transpose
+#define MATRIX_TRANSPOSE_TILE_LEN 32
+
+// Number of rows processed together by the row-wise iterated box filter
+#define MATRIX_ROWWISE_BLOCK_LEN 16
+
+
+typedef struct {
+	Matrix* self;
+	const Matrix* other;
+	const Vector* kernel;
+	size_t filter_size;
+	const size_t* filter_sizes;
+	size_t pass_count;
+	ThreadPool* thread_pool;
+	SDL_threadID thread_id; // Thread which submitted the job
+	real_t* scratch;        // One slot per worker
+	size_t scratch_len;     // Number of values of a slot
+} MatrixJobContext;
+
+
+/*
+ * The threads outside of the pool share its last worker, and several of them
+ * can run the tasks of a job, when waiting for their own jobs. Only the one
+ * which submitted the job uses the slot of that worker, the others allocate
+ * their own scratch for each task.
+ */
+
+static bool
+Matrix_job_needs_own_scratch(
+	const MatrixJobContext* job_context
+) {
+	ThreadPool* thread_pool = job_context->thread_pool;
+
+	return
+		(ThreadPool_worker_index(thread_pool) == ThreadPool_worker_count(thread_pool) - 1) &&
+		(SDL_ThreadID() != job_context->thread_id);
+}
+
+
+// Scratch of the thread running a task, released by Matrix_release_job_scratch
+static real_t*
+Matrix_acquire_job_scratch(
+	const MatrixJobContext* job_context
+) {
+	if (Matrix_job_needs_own_scratch(job_context))
+		return array_ops_allocate(job_context->scratch_len);
+
+	size_t index = ThreadPool_worker_index(job_context->thread_pool);
+	return job_context->scratch + index * job_context->scratch_len;
+}
+
+
+static void
+Matrix_release_job_scratch(
+	const MatrixJobContext* job_context,
+	real_t* scratch
+) {
+	if (Matrix_job_needs_own_scratch(job_context))
+		array_ops_free(scratch);
+}
+
+
+// Allocate one slot of len values per worker, keeping each slot aligned
+static void
+Matrix_allocate_job_scratch(
+	MatrixJobContext* job_context,
+	size_t len
+) {
+	job_context->thread_id = SDL_ThreadID();
+	job_context->scratch_len =
+		((len + MATRIX_ROW_ALIGNMENT - 1) / MATRIX_ROW_ALIGNMENT) * MATRIX_ROW_ALIGNMENT;
+
+	job_context->scratch =
+		array_ops_allocate(ThreadPool_worker_count(job_context->thread_pool) * job_context->scratch_len);
+}
+
+
+static size_t
+Matrix_parallel_grain(
+	size_t line_len
+) {
+	if (line_len >= MATRIX_PARALLEL_GRAIN_SIZE)
+		return 1;
+
+	return MATRIX_PARALLEL_GRAIN_SIZE / line_len;
+}
+
+
+static size_t
+Matrix_parallel_block_grain(
+	size_t line_len,
+	size_t block_len
+) {
+	// Whole blocks of lines
+	size_t grain = Matrix_parallel_grain(line_len);
+	return ((grain + block_len - 1) / block_len) * block_len;
+}
+
+
+/*
+ * Splits the coefficients of self, and of other if any, in lines processed by
+ * the array_ops routines : a single line if the rows are contiguous, one line
+ * per row otherwise
+ */
+
+static size_t
+Matrix_line_count(
+	const Matrix* self,
+	const Matrix* other,
+	size_t* line_len
+) {
+	if (Matrix_is_contiguous(self) && ((!other) || Matrix_is_contiguous(other))) {
+		*line_len = self->data_len;
+		return 1;
+	}
+
+	*line_len = self->col_count;
+	return self->row_count;
+}
+
+
 void
 Matrix_init(
 	Matrix* self,
@@ -14,11 +145,50 @@ Matrix_init(
 
 	self->row_count = row_count;
 	self->col_count = col_count;
+	self->row_stride = col_count;
 	self->data_len = row_count * col_count;
 	self->data = array_ops_allocate(self->data_len);
 }
 
 
+void
+Matrix_init_padded(
+	Matrix* self,
+	size_t row_count,
+	size_t col_count
+) {
+	assert(self);
+
+	self->row_count = row_count;
+	self->col_count = col_count;
+	self->row_stride = ((col_count + MATRIX_ROW_ALIGNMENT - 1) / MATRIX_ROW_ALIGNMENT) * MATRIX_ROW_ALIGNMENT;
+	self->data_len = row_count * col_count;
+	self->data = array_ops_allocate(row_count * self->row_stride);
+}
+
+
+void
+Matrix_init_view(
+	Matrix* self,
+	const Matrix* other,
+	size_t row,
+	size_t col,
+	size_t row_count,
+	size_t col_count
+) {
+	assert(self);
+	assert(other);
+	assert(row + row_count <= other->row_count);
+	assert(col + col_count <= other->col_count);
+
+	self->row_count = row_count;
+	self->col_count = col_count;
+	self->row_stride = other->row_stride;
+	self->data_len = row_count * col_count;
+	self->data = other->data + row * other->row_stride + col;
+}
+
+
 void
 Matrix_destroy(
 	Matrix* self
@@ -26,17 +196,28 @@ Matrix_destroy(
 	assert(self);
 	assert(self->data);
 	
-	free(self->data);
+	array_ops_free(self->data);
 
 	#ifdef DEBUG
 	self->row_count = 0;
 	self->col_count = 0;
+	self->row_stride = 0;
 	self->data_len = 0;
 	self->data = 0;
 	#endif
 }
 
 
+bool
+Matrix_is_contiguous(
+	const Matrix* self
+) {
+	assert(self);
+
+	return self->row_stride == self->col_count;
+}
+
+
 void
 Matrix_print(
 	const Matrix* self,
@@ -49,7 +230,7 @@ Matrix_print(
 	assert(format);
 
 	const real_t* src = self->data;
-	for(size_t i = self->row_count; i != 0; --i, src += self->col_count) {
+	for(size_t i = self->row_count; i != 0; --i, src += self->row_stride) {
 		if (i == self->row_count)
 			fputs("[", fp);
 		else
@@ -79,7 +260,7 @@ Matrix_set_coeff(
 	assert(row < self->row_count);
 	assert(col < self->col_count);
 
-	self->data[row * self->col_count + col] = value;
+	self->data[row * self->row_stride + col] = value;
 }
 
 
@@ -94,7 +275,7 @@ Matrix_get_coeff(
 	assert(row < self->row_count);
 	assert(col < self->col_count);
 
-	return self->data[row * self->col_count + col];
+	return self->data[row * self->row_stride + col];
 }
 
 
@@ -106,11 +287,10 @@ Matrix_random_uniform(
 	assert(self);
 	assert(rng);
 
-	array_ops_random_uniform(
-		self->data,
-		self->data_len,
-		rng
-	);
+	size_t line_len;
+	real_t* line = self->data;
+	for(size_t i = Matrix_line_count(self, 0, &line_len); i != 0; --i, line += self->row_stride)
+		array_ops_random_uniform(line, line_len, rng);
 }
 
 
@@ -122,11 +302,41 @@ Matrix_random_normal(
 	assert(self);
 	assert(rng);
 
-	array_ops_random_normal(
-		self->data,
-		self->data_len,
-		rng
-	);
+	size_t line_len;
+	real_t* line = self->data;
+	for(size_t i = Matrix_line_count(self, 0, &line_len); i != 0; --i, line += self->row_stride)
+		array_ops_random_normal(line, line_len, rng);
+}
+
+
+static void
+Matrix_transpose_job(
+	void* context,
+	size_t begin,
+	size_t end
+) {
+	const MatrixJobContext* job_context = (const MatrixJobContext*)context;
+	Matrix* self = job_context->self;
+	const Matrix* other = job_context->other;
+
+	// Transpose tile by tile, the rows [begin, end) of self being the columns
+	// [begin, end) of other
+	for(size_t i = begin; i < end; i += MATRIX_TRANSPOSE_TILE_LEN) {
+		size_t tile_col_count = (end - i < MATRIX_TRANSPOSE_TILE_LEN) ? end - i : MATRIX_TRANSPOSE_TILE_LEN;
+
+		for(size_t j = 0; j < self->col_count; j += MATRIX_TRANSPOSE_TILE_LEN) {
+			size_t tile_row_count = (self->col_count - j < MATRIX_TRANSPOSE_TILE_LEN) ? self->col_count - j : MATRIX_TRANSPOSE_TILE_LEN;
+
+			array_ops_transpose(
+				self->data + i * self->row_stride + j,
+				other->data + j * other->row_stride + i,
+				tile_row_count,
+				tile_col_count,
+				self->row_stride,
+				other->row_stride
+			);
+		}
+	}
 }
 
 
@@ -134,6 +344,16 @@ void
 Matrix_transpose(
 	Matrix* self,
 	const Matrix* other
+) {
+	Matrix_parallel_transpose(self, other, 0);
+}
+
+
+void
+Matrix_parallel_transpose(
+	Matrix* self,
+	const Matrix* other,
+	ThreadPool* thread_pool
 ) {
 	assert(self);
 	assert(self->data);
@@ -142,16 +362,16 @@ Matrix_transpose(
 	assert(self->row_count == other->col_count);
 	assert(self->col_count == other->row_count);
 
-	real_t* u_row_ptr = self->data;
-	const real_t* v_col_ptr = other->data;
-
-	for(size_t i = 0; i < self->row_count; ++i, u_row_ptr += self->col_count, v_col_ptr += 1) {
-		real_t* u_ptr = u_row_ptr;
-		const real_t* v_ptr = v_col_ptr;
+	MatrixJobContext job_context = { self, other, 0, 0, 0, 0, 0, 0, 0, 0 };
 
-		for(size_t j = 0; j < self->col_count; ++j, ++u_ptr, v_ptr += self->row_count)
-			*u_ptr = *v_ptr;
-	}
+	ThreadPool_parallel_for(
+		thread_pool,
+		Matrix_transpose_job,
+		&job_context,
+		0,
+		self->row_count,
+		Matrix_parallel_block_grain(self->col_count, MATRIX_TRANSPOSE_TILE_LEN)
+	);
 }
 
 
@@ -163,11 +383,10 @@ Matrix_fill(
 	assert(self);
 	assert(self->data);
 
-	array_ops_fill(
-		self->data,
-		self->data_len,
-		value
-	);
+	size_t line_len;
+	real_t* line = self->data;
+	for(size_t i = Matrix_line_count(self, 0, &line_len); i != 0; --i, line += self->row_stride)
+		array_ops_fill(line, line_len, value);
 }
 
 
@@ -183,11 +402,11 @@ Matrix_copy(
 	assert(self->row_count == other->row_count);
 	assert(self->col_count == other->col_count);
 
-	array_ops_copy(
-		self->data,
-		other->data,
-		self->data_len
-	);
+	size_t line_len;
+	real_t* line = self->data;
+	const real_t* other_line = other->data;
+	for(size_t i = Matrix_line_count(self, other, &line_len); i != 0; --i, line += self->row_stride, other_line += other->row_stride)
+		array_ops_copy(line, other_line, line_len);
 }
 
 
@@ -197,10 +416,10 @@ Matrix_abs(
 ) {
 	assert(self);
 
-	array_ops_abs(
-		self->data,
-		self->data_len
-	);
+	size_t line_len;
+	real_t* line = self->data;
+	for(size_t i = Matrix_line_count(self, 0, &line_len); i != 0; --i, line += self->row_stride)
+		array_ops_abs(line, line_len);
 }
 
 
@@ -210,10 +429,10 @@ Matrix_square(
 ) {
 	assert(self);
 
-	array_ops_square(
-		self->data,
-		self->data_len
-	);
+	size_t line_len;
+	real_t* line = self->data;
+	for(size_t i = Matrix_line_count(self, 0, &line_len); i != 0; --i, line += self->row_stride)
+		array_ops_square(line, line_len);
 }
 
 
@@ -223,10 +442,10 @@ Matrix_sqrt(
 ) {
 	assert(self);
 
-	array_ops_sqrt(
-		self->data,
-		self->data_len
-	);
+	size_t line_len;
+	real_t* line = self->data;
+	for(size_t i = Matrix_line_count(self, 0, &line_len); i != 0; --i, line += self->row_stride)
+		array_ops_sqrt(line, line_len);
 }
 
 
@@ -236,10 +455,10 @@ Matrix_exp(
 ) {
 	assert(self);
 
-	array_ops_exp(
-		self->data,
-		self->data_len
-	);
+	size_t line_len;
+	real_t* line = self->data;
+	for(size_t i = Matrix_line_count(self, 0, &line_len); i != 0; --i, line += self->row_stride)
+		array_ops_exp(line, line_len);
 }
 
 
@@ -249,10 +468,10 @@ Matrix_log(
 ) {
 	assert(self);
 
-	array_ops_log(
-		self->data,
-		self->data_len
-	);
+	size_t line_len;
+	real_t* line = self->data;
+	for(size_t i = Matrix_line_count(self, 0, &line_len); i != 0; --i, line += self->row_stride)
+		array_ops_log(line, line_len);
 }
 
 
@@ -263,25 +482,116 @@ Matrix_heaviside(
 ) {
 	assert(self);
 
-	array_ops_heaviside(
-		self->data,
-		self->data_len,
-		threshold
+	size_t line_len;
+	real_t* line = self->data;
+	for(size_t i = Matrix_line_count(self, 0, &line_len); i != 0; --i, line += self->row_stride)
+		array_ops_heaviside(line, line_len, threshold);
+}
+
+
+typedef struct {
+	Matrix* self;
+	const ArrayOp* ops;
+	size_t op_count;
+} MatrixRunJobContext;
+
+
+static void
+Matrix_run_job(
+	void* context,
+	size_t begin,
+	size_t end
+) {
+	const MatrixRunJobContext* job_context = (const MatrixRunJobContext*)context;
+
+	array_ops_run(
+		job_context->self->data + begin,
+		end - begin,
+		job_context->ops,
+		job_context->op_count
 	);
 }
 
 
+static void
+Matrix_run_rows_job(
+	void* context,
+	size_t begin,
+	size_t end
+) {
+	const MatrixRunJobContext* job_context = (const MatrixRunJobContext*)context;
+	Matrix* self = job_context->self;
+
+	real_t* row = self->data + begin * self->row_stride;
+	for(size_t i = begin; i < end; ++i, row += self->row_stride)
+		array_ops_run(
+			row,
+			self->col_count,
+			job_context->ops,
+			job_context->op_count
+		);
+}
+
+
+void
+Matrix_run(
+	Matrix* self,
+	const ArrayOp* ops,
+	size_t op_count
+) {
+	Matrix_parallel_run(self, ops, op_count, 0);
+}
+
+
+void
+Matrix_parallel_run(
+	Matrix* self,
+	const ArrayOp* ops,
+	size_t op_count,
+	ThreadPool* thread_pool
+) {
+	assert(self);
+	assert(self->data);
+	assert(ops || (op_count == 0));
+
+	MatrixRunJobContext job_context = { self, ops, op_count };
+
+	if (Matrix_is_contiguous(self))
+		ThreadPool_parallel_for(
+			thread_pool,
+			Matrix_run_job,
+			&job_context,
+			0,
+			self->data_len,
+			MATRIX_PARALLEL_GRAIN_SIZE
+		);
+	else
+		ThreadPool_parallel_for(
+			thread_pool,
+			Matrix_run_rows_job,
+			&job_context,
+			0,
+			self->row_count,
+			Matrix_parallel_grain(self->col_count)
+		);
+}
+
+
 real_t
 Matrix_reduction_min(
 	const Matrix* self
 ) {
 	assert(self);
 
-	return
-		array_ops_reduction_min(
-			self->data,
-			self->data_len
-		);
+	size_t line_len;
+	size_t line_count = Matrix_line_count(self, 0, &line_len);
+
+	const real_t* line = self->data;
+	real_t ret = array_ops_reduction_min(line, line_len);
+	for(--line_count, line += self->row_stride; line_count != 0; --line_count, line += self->row_stride)
+		ret = fmin(ret, array_ops_reduction_min(line, line_len));
+
+	return ret;
 }
 
 
@@ -291,11 +601,15 @@ Matrix_reduction_max(
 ) {
 	assert(self);
 
-	return
-		array_ops_reduction_max(
-			self->data,
-			self->data_len
-		);
+	size_t line_len;
+	size_t line_count = Matrix_line_count(self, 0, &line_len);
+
+	const real_t* line = self->data;
+	real_t ret = array_ops_reduction_max(line, line_len);
+	for(--line_count, line += self->row_stride; line_count != 0; --line_count, line += self->row_stride)
+		ret = fmax(ret, array_ops_reduction_max(line, line_len));
+
+	return ret;
 }
 
 
@@ -305,11 +619,15 @@ Matrix_reduction_sum(
 ) {
 	assert(self);
 
-	return
-		array_ops_reduction_sum(
-			self->data,
-			self->data_len
-		);
+	size_t line_len;
+	size_t line_count = Matrix_line_count(self, 0, &line_len);
+
+	const real_t* line = self->data;
+	real_t ret = array_ops_reduction_sum(line, line_len);
+	for(--line_count, line += self->row_stride; line_count != 0; --line_count, line += self->row_stride)
+		ret += array_ops_reduction_sum(line, line_len);
+
+	return ret;
 }
 
 
@@ -320,12 +638,28 @@ Matrix_reduction_mean(
 ) {
 	assert(self);
 
-	return
-		array_ops_reduction_mean(
-			self->data,
-			self->data_len,
-			out_std
-		);
+	size_t line_len;
+	size_t line_count = Matrix_line_count(self, 0, &line_len);
+	if (line_count == 1)
+		return array_ops_reduction_mean(self->data, line_len, out_std);
+
+	// Combine the means and variances of the rows, as in the parallel
+	// algorithm of Chan et al.
+	real_t ret = (real_t)0;
+	real_t m2 = (real_t)0;
+
+	const real_t* line = self->data;
+	for(size_t i = 0; i < line_count; ++i, line += self->row_stride) {
+		real_t line_std = (real_t)0;
+		real_t delta = array_ops_reduction_mean(line, line_len, out_std ? &line_std : 0) - ret;
+		ret += delta / (i + 1);
+		m2 += line_len * (line_std * line_std + ((delta * delta) * i) / (i + 1));
+	}
+
+	if (out_std)
+		*out_std = sqrt(m2 / self->data_len);
+
+	return ret;
 }
 
 
@@ -340,13 +674,36 @@ Matrix_reduction_average(
 	assert(self->col_count == weight->col_count);
 	assert(self->row_count == weight->row_count);
 
-	return
-		array_ops_reduction_average(
-			self->data,
-			weight->data,
-			self->data_len,
-			out_std
-		);
+	size_t line_len;
+	size_t line_count = Matrix_line_count(self, weight, &line_len);
+	if (line_count == 1)
+		return array_ops_reduction_average(self->data, weight->data, line_len, out_std);
+
+	// Combine the weighted means and variances of the rows with non-zero
+	// weights
+	real_t ret = (real_t)0;
+	real_t w_sum = (real_t)0;
+	real_t S = (real_t)0;
+
+	const real_t* line = self->data;
+	const real_t* weight_line = weight->data;
+	for( ; line_count != 0; --line_count, line += self->row_stride, weight_line += weight->row_stride) {
+		real_t line_w_sum = array_ops_reduction_sum(weight_line, line_len);
+		if (line_w_sum == 0)
+			continue;
+
+		real_t line_std = (real_t)0;
+		real_t delta = array_ops_reduction_average(line, weight_line, line_len, out_std ? &line_std : 0) - ret;
+		real_t new_w_sum = w_sum + line_w_sum;
+		ret += (delta * line_w_sum) / new_w_sum;
+		S += line_w_sum * (line_std * line_std) + ((delta * delta) * w_sum * line_w_sum) / new_w_sum;
+		w_sum = new_w_sum;
+	}
+
+	if (out_std)
+		*out_std = sqrt(S / w_sum);
+
+	return ret;
 }
 
 
@@ -356,11 +713,15 @@ Matrix_reduction_square_sum(
 ) {
 	assert(self);
 
-	return
-		array_ops_reduction_square_sum(
-			self->data,
-			self->data_len
-		);
+	size_t line_len;
+	size_t line_count = Matrix_line_count(self, 0, &line_len);
+
+	const real_t* line = self->data;
+	real_t ret = array_ops_reduction_square_sum(line, line_len);
+	for(--line_count, line += self->row_stride; line_count != 0; --line_count, line += self->row_stride)
+		ret += array_ops_reduction_square_sum(line, line_len);
+
+	return ret;
 }
 
 
@@ -370,11 +731,18 @@ Matrix_reduction_logsumexp(
 ) {
 	assert(self);
 
-	return
-		array_ops_reduction_logsumexp(
-			self->data,
-			self->data_len
-		);
+	size_t line_len;
+	size_t line_count = Matrix_line_count(self, 0, &line_len);
+
+	const real_t* line = self->data;
+	real_t ret = array_ops_reduction_logsumexp(line, line_len);
+	for(--line_count, line += self->row_stride; line_count != 0; --line_count, line += self->row_stride) {
+		real_t x = array_ops_reduction_logsumexp(line, line_len);
+		real_t max_val = fmax(ret, x);
+		ret = log(exp(ret - max_val) + exp(x - max_val)) + max_val;
+	}
+
+	return ret;
 }
 
 
@@ -386,11 +754,10 @@ Matrix_inc(
 	assert(self);
 	assert(self->data);
 
-	array_ops_inc(
-		self->data,
-		self->data_len,
-		value
-	);
+	size_t line_len;
+	real_t* line = self->data;
+	for(size_t i = Matrix_line_count(self, 0, &line_len); i != 0; --i, line += self->row_stride)
+		array_ops_inc(line, line_len, value);
 }
 
 
@@ -402,11 +769,10 @@ Matrix_scale(
 	assert(self);
 	assert(self->data);
 
-	array_ops_scale(
-		self->data,
-		self->data_len,
-		value
-	);
+	size_t line_len;
+	real_t* line = self->data;
+	for(size_t i = Matrix_line_count(self, 0, &line_len); i != 0; --i, line += self->row_stride)
+		array_ops_scale(line, line_len, value);
 }
 
 
@@ -422,11 +788,11 @@ Matrix_add(
 	assert(self->row_count == other->row_count);
 	assert(self->col_count == other->col_count);
 
-	array_ops_add(
-		self->data,
-		other->data,
-		self->data_len
-	);
+	size_t line_len;
+	real_t* line = self->data;
+	const real_t* other_line = other->data;
+	for(size_t i = Matrix_line_count(self, other, &line_len); i != 0; --i, line += self->row_stride, other_line += other->row_stride)
+		array_ops_add(line, other_line, line_len);
 }
 
 
@@ -435,18 +801,18 @@ Matrix_sub(
 	Matrix* self,
 	const Matrix* other
 ) {
-	assert(self );
+	assert(self);
 	assert(self->data);
 	assert(other);
 	assert(other->data);
 	assert(self->row_count == other->row_count);
 	assert(self->col_count == other->col_count);
 
-	array_ops_sub(
-		self->data,
-		other->data,
-		self->data_len
-	);
+	size_t line_len;
+	real_t* line = self->data;
+	const real_t* other_line = other->data;
+	for(size_t i = Matrix_line_count(self, other, &line_len); i != 0; --i, line += self->row_stride, other_line += other->row_stride)
+		array_ops_sub(line, other_line, line_len);
 }
 
 
@@ -463,12 +829,11 @@ Matrix_scaled_add(
 	assert(self->row_count == other->row_count);
 	assert(self->col_count == other->col_count);
 
-	array_ops_scaled_add(
-		self->data,
-		other->data,
-		self->data_len,
-		value
-	);
+	size_t line_len;
+	real_t* line = self->data;
+	const real_t* other_line = other->data;
+	for(size_t i = Matrix_line_count(self, other, &line_len); i != 0; --i, line += self->row_stride, other_line += other->row_stride)
+		array_ops_scaled_add(line, other_line, line_len, value);
 }
 
 
@@ -484,11 +849,11 @@ Matrix_mul(
 	assert(self->row_count == other->row_count);
 	assert(self->col_count == other->col_count);
 
-	array_ops_mul(
-		self->data,
-		other->data,
-		self->data_len
-	);
+	size_t line_len;
+	real_t* line = self->data;
+	const real_t* other_line = other->data;
+	for(size_t i = Matrix_line_count(self, other, &line_len); i != 0; --i, line += self->row_stride, other_line += other->row_stride)
+		array_ops_mul(line, other_line, line_len);
 }
 
 
@@ -504,11 +869,11 @@ Matrix_div(
 	assert(self->row_count == other->row_count);
 	assert(self->col_count == other->col_count);
 
-	array_ops_div(
-		self->data,
-		other->data,
-		self->data_len
-	);
+	size_t line_len;
+	real_t* line = self->data;
+	const real_t* other_line = other->data;
+	for(size_t i = Matrix_line_count(self, other, &line_len); i != 0; --i, line += self->row_stride, other_line += other->row_stride)
+		array_ops_div(line, other_line, line_len);
 }
 
 
@@ -524,11 +889,11 @@ Matrix_min(
 	assert(self->row_count == other->row_count);
 	assert(self->col_count == other->col_count);
 
-	array_ops_min(
-		self->data,
-		other->data,
-		self->data_len
-	);
+	size_t line_len;
+	real_t* line = self->data;
+	const real_t* other_line = other->data;
+	for(size_t i = Matrix_line_count(self, other, &line_len); i != 0; --i, line += self->row_stride, other_line += other->row_stride)
+		array_ops_min(line, other_line, line_len);
 }
 
 
@@ -545,12 +910,11 @@ Matrix_scaled_min(
 	assert(self->row_count == other->row_count);
 	assert(self->col_count == other->col_count);
 
-	array_ops_scaled_min(
-		self->data,
-		other->data,
-		self->data_len,
-		value
-	);
+	size_t line_len;
+	real_t* line = self->data;
+	const real_t* other_line = other->data;
+	for(size_t i = Matrix_line_count(self, other, &line_len); i != 0; --i, line += self->row_stride, other_line += other->row_stride)
+		array_ops_scaled_min(line, other_line, line_len, value);
 }
 
 
@@ -566,11 +930,11 @@ Matrix_max(
 	assert(self->row_count == other->row_count);
 	assert(self->col_count == other->col_count);
 
-	array_ops_max(
-		self->data,
-		other->data,
-		self->data_len
-	);
+	size_t line_len;
+	real_t* line = self->data;
+	const real_t* other_line = other->data;
+	for(size_t i = Matrix_line_count(self, other, &line_len); i != 0; --i, line += self->row_stride, other_line += other->row_stride)
+		array_ops_max(line, other_line, line_len);
 }
 
 
@@ -587,12 +951,11 @@ Matrix_scaled_max(
 	assert(self->row_count == other->row_count);
 	assert(self->col_count == other->col_count);
 
-	array_ops_scaled_max(
-		self->data,
-		other->data,
-		self->data_len,
-		value
-	);
+	size_t line_len;
+	real_t* line = self->data;
+	const real_t* other_line = other->data;
+	for(size_t i = Matrix_line_count(self, other, &line_len); i != 0; --i, line += self->row_stride, other_line += other->row_stride)
+		array_ops_scaled_max(line, other_line, line_len, value);
 }
 
 
@@ -611,9 +974,9 @@ Matrix_resample_nearest(
 
 	real_t* dst_row = self->data;
 	
-	for(size_t i = 0; i < self->row_count; ++i, dst_row += self->col_count) {
+	for(size_t i = 0; i < self->row_count; ++i, dst_row += self->row_stride) {
 		size_t u = (size_t)floorf(row_scaling_factor * (i + ((real_t).5)));
-		const real_t* src_row = other->data + u * other->col_count;
+		const real_t* src_row = other->data + u * other->row_stride;
 		
 		for(size_t j = 0; j < self->col_count; ++j) {
 			size_t v = (size_t)floorf(col_scaling_factor * (j + ((real_t).5)));
@@ -624,11 +987,45 @@ Matrix_resample_nearest(
 }
 
 
+static void
+Matrix_rowwise_convolution__zero_job(
+	void* context,
+	size_t begin,
+	size_t end
+) {
+	const MatrixJobContext* job_context = (const MatrixJobContext*)context;
+	Matrix* self = job_context->self;
+	const Matrix* other = job_context->other;
+
+	const real_t* src = other->data + begin * other->row_stride;
+	real_t* dst = self->data + begin * self->row_stride;
+	for(size_t i = begin; i < end; ++i, src += other->row_stride, dst += self->row_stride)
+		array_ops_convolution__zero(
+			dst,
+			src,
+			job_context->kernel->data,
+			other->col_count,
+			job_context->kernel->len
+		);
+}
+
+
 void
 Matrix_rowwise_convolution__zero(
 	Matrix* self,
 	const Matrix* other,
 	const Vector* kernel
+) {
+	Matrix_parallel_rowwise_convolution__zero(self, other, kernel, 0);
+}
+
+
+void
+Matrix_parallel_rowwise_convolution__zero(
+	Matrix* self,
+	const Matrix* other,
+	const Vector* kernel,
+	ThreadPool* thread_pool
 ) {
 	assert(self);
 	assert(self->data);
@@ -639,15 +1036,41 @@ Matrix_rowwise_convolution__zero(
 	assert(self->row_count == other->row_count);
 	assert(self->col_count == other->col_count);
 
-	const real_t* src = other->data;
-	real_t* dst = self->data;
-	for(size_t i = other->row_count; i != 0; --i, src += other->col_count, dst += other->col_count)
-		array_ops_convolution__zero(
-			dst,
-			src,
-			kernel->data,
-			other->col_count,
-			kernel->len
+	MatrixJobContext job_context = { self, other, kernel, 0, 0, 0, 0, 0, 0, 0 };
+
+	ThreadPool_parallel_for(
+		thread_pool,
+		Matrix_rowwise_convolution__zero_job,
+		&job_context,
+		0,
+		self->row_count,
+		Matrix_parallel_grain(self->col_count)
+	);
+}
+
+
+static void
+Matrix_colwise_convolution__zero_job(
+	void* context,
+	size_t begin,
+	size_t end
+) {
+	const MatrixJobContext* job_context = (const MatrixJobContext*)context;
+	Matrix* self = job_context->self;
+	const Matrix* other = job_context->other;
+
+	// Process the columns by blocks, so that the rows of a block used by the
+	// kernel stay in cache
+	for(size_t j = begin; j < end; j += MATRIX_COLWISE_BLOCK_LEN)
+		array_ops_block_convolution__zero(
+			self->data + j,
+			other->data + j,
+			job_context->kernel->data,
+			other->row_count,
+			job_context->kernel->len,
+			(end - j < MATRIX_COLWISE_BLOCK_LEN) ? end - j : MATRIX_COLWISE_BLOCK_LEN,
+			self->row_stride,
+			other->row_stride
 		);
 }
 
@@ -657,6 +1080,17 @@ Matrix_colwise_convolution__zero(
 	Matrix* self,
 	const Matrix* other,
 	const Vector* kernel
+) {
+	Matrix_parallel_colwise_convolution__zero(self, other, kernel, 0);
+}
+
+
+void
+Matrix_parallel_colwise_convolution__zero(
+	Matrix* self,
+	const Matrix* other,
+	const Vector* kernel,
+	ThreadPool* thread_pool
 ) {
 	assert(self);
 	assert(self->data);
@@ -667,17 +1101,38 @@ Matrix_colwise_convolution__zero(
 	assert(self->row_count == other->row_count);
 	assert(self->col_count == other->col_count);
 
-	const real_t* src = other->data;
-	real_t* dst = self->data;
-	for(size_t i = other->col_count; i != 0; --i, ++src, ++dst)
-		array_ops_strided_convolution__zero(
+	MatrixJobContext job_context = { self, other, kernel, 0, 0, 0, 0, 0, 0, 0 };
+
+	ThreadPool_parallel_for(
+		thread_pool,
+		Matrix_colwise_convolution__zero_job,
+		&job_context,
+		0,
+		self->col_count,
+		Matrix_parallel_block_grain(self->row_count, MATRIX_COLWISE_BLOCK_LEN)
+	);
+}
+
+
+static void
+Matrix_rowwise_convolution__mirror_job(
+	void* context,
+	size_t begin,
+	size_t end
+) {
+	const MatrixJobContext* job_context = (const MatrixJobContext*)context;
+	Matrix* self = job_context->self;
+	const Matrix* other = job_context->other;
+
+	const real_t* src = other->data + begin * other->row_stride;
+	real_t* dst = self->data + begin * self->row_stride;
+	for(size_t i = begin; i < end; ++i, src += other->row_stride, dst += self->row_stride)
+		array_ops_convolution__mirror(
 			dst,
 			src,
-			kernel->data,
-			other->row_count,
-			kernel->len,
+			job_context->kernel->data,
 			other->col_count,
-			other->col_count
+			job_context->kernel->len
 		);
 }
 
@@ -687,6 +1142,17 @@ Matrix_rowwise_convolution__mirror(
 	Matrix* self,
 	const Matrix* other,
 	const Vector* kernel
+) {
+	Matrix_parallel_rowwise_convolution__mirror(self, other, kernel, 0);
+}
+
+
+void
+Matrix_parallel_rowwise_convolution__mirror(
+	Matrix* self,
+	const Matrix* other,
+	const Vector* kernel,
+	ThreadPool* thread_pool
 ) {
 	assert(self);
 	assert(self->data);
@@ -697,15 +1163,41 @@ Matrix_rowwise_convolution__mirror(
 	assert(self->row_count == other->row_count);
 	assert(self->col_count == other->col_count);
 
-	const real_t* src = other->data;
-	real_t* dst = self->data;
-	for(size_t i = other->row_count; i != 0; --i, src += other->col_count, dst += other->col_count)
-		array_ops_convolution__mirror(
-			dst,
-			src,
-			kernel->data,
-			other->col_count,
-			kernel->len
+	MatrixJobContext job_context = { self, other, kernel, 0, 0, 0, 0, 0, 0, 0 };
+
+	ThreadPool_parallel_for(
+		thread_pool,
+		Matrix_rowwise_convolution__mirror_job,
+		&job_context,
+		0,
+		self->row_count,
+		Matrix_parallel_grain(self->col_count)
+	);
+}
+
+
+static void
+Matrix_colwise_convolution__mirror_job(
+	void* context,
+	size_t begin,
+	size_t end
+) {
+	const MatrixJobContext* job_context = (const MatrixJobContext*)context;
+	Matrix* self = job_context->self;
+	const Matrix* other = job_context->other;
+
+	// Process the columns by blocks, so that the rows of a block used by the
+	// kernel stay in cache
+	for(size_t j = begin; j < end; j += MATRIX_COLWISE_BLOCK_LEN)
+		array_ops_block_convolution__mirror(
+			self->data + j,
+			other->data + j,
+			job_context->kernel->data,
+			other->row_count,
+			job_context->kernel->len,
+			(end - j < MATRIX_COLWISE_BLOCK_LEN) ? end - j : MATRIX_COLWISE_BLOCK_LEN,
+			self->row_stride,
+			other->row_stride
 		);
 }
 
@@ -715,6 +1207,17 @@ Matrix_colwise_convolution__mirror(
 	Matrix* self,
 	const Matrix* other,
 	const Vector* kernel
+) {
+	Matrix_parallel_colwise_convolution__mirror(self, other, kernel, 0);
+}
+
+
+void
+Matrix_parallel_colwise_convolution__mirror(
+	Matrix* self,
+	const Matrix* other,
+	const Vector* kernel,
+	ThreadPool* thread_pool
 ) {
 	assert(self);
 	assert(self->data);
@@ -725,17 +1228,37 @@ Matrix_colwise_convolution__mirror(
 	assert(self->row_count == other->row_count);
 	assert(self->col_count == other->col_count);
 
-	const real_t* src = other->data;
-	real_t* dst = self->data;
-	for(size_t i = other->col_count; i != 0; --i, ++src, ++dst)
-		array_ops_strided_convolution__mirror(
+	MatrixJobContext job_context = { self, other, kernel, 0, 0, 0, 0, 0, 0, 0 };
+
+	ThreadPool_parallel_for(
+		thread_pool,
+		Matrix_colwise_convolution__mirror_job,
+		&job_context,
+		0,
+		self->col_count,
+		Matrix_parallel_block_grain(self->row_count, MATRIX_COLWISE_BLOCK_LEN)
+	);
+}
+
+
+static void
+Matrix_rowwise_box_filter_job(
+	void* context,
+	size_t begin,
+	size_t end
+) {
+	const MatrixJobContext* job_context = (const MatrixJobContext*)context;
+	Matrix* self = job_context->self;
+	const Matrix* other = job_context->other;
+
+	const real_t* src = other->data + begin * other->row_stride;
+	real_t* dst = self->data + begin * self->row_stride;
+	for(size_t i = begin; i < end; ++i, src += other->row_stride, dst += self->row_stride)
+		array_ops_box_filter(
 			dst,
 			src,
-			kernel->data,
-			other->row_count,
-			kernel->len,
 			other->col_count,
-			other->col_count
+			job_context->filter_size
 		);
 }
 
@@ -745,6 +1268,17 @@ Matrix_rowwise_box_filter(
 	Matrix* self,
 	const Matrix* other,
 	size_t filter_size
+) {
+	Matrix_parallel_rowwise_box_filter(self, other, filter_size, 0);
+}
+
+
+void
+Matrix_parallel_rowwise_box_filter(
+	Matrix* self,
+	const Matrix* other,
+	size_t filter_size,
+	ThreadPool* thread_pool
 ) {
 	assert(self);
 	assert(self->data);
@@ -754,13 +1288,256 @@ Matrix_rowwise_box_filter(
 	assert(self->row_count == other->row_count);
 	assert(self->col_count == other->col_count);
 
-	const real_t* src = other->data;
-	real_t* dst = self->data;
-	for(size_t i = other->row_count; i != 0; --i, src += other->col_count, dst += other->col_count)
-		array_ops_box_filter(
-			dst,
-			src,
-			other->col_count,
-			filter_size
+	MatrixJobContext job_context = { self, other, 0, filter_size, 0, 0, 0, 0, 0, 0 };
+
+	ThreadPool_parallel_for(
+		thread_pool,
+		Matrix_rowwise_box_filter_job,
+		&job_context,
+		0,
+		self->row_count,
+		Matrix_parallel_grain(self->col_count)
+	);
+}
+
+
+static void
+Matrix_colwise_box_filter_job(
+	void* context,
+	size_t begin,
+	size_t end
+) {
+	const MatrixJobContext* job_context = (const MatrixJobContext*)context;
+	Matrix* self = job_context->self;
+	const Matrix* other = job_context->other;
+
+	for(size_t j = begin; j < end; j += MATRIX_COLWISE_BLOCK_LEN)
+		array_ops_block_box_filter(
+			self->data + j,
+			other->data + j,
+			other->row_count,
+			job_context->filter_size,
+			(end - j < MATRIX_COLWISE_BLOCK_LEN) ? end - j : MATRIX_COLWISE_BLOCK_LEN,
+			self->row_stride,
+			other->row_stride
+		);
+}
+
+
+void
+Matrix_colwise_box_filter(
+	Matrix* self,
+	const Matrix* other,
+	size_t filter_size
+) {
+	Matrix_parallel_colwise_box_filter(self, other, filter_size, 0);
+}
+
+
+void
+Matrix_parallel_colwise_box_filter(
+	Matrix* self,
+	const Matrix* other,
+	size_t filter_size,
+	ThreadPool* thread_pool
+) {
+	assert(self);
+	assert(self->data);
+	assert(other);
+	assert(other->data);
+	assert(filter_size % 2 == 1);
+	assert(self->row_count == other->row_count);
+	assert(self->col_count == other->col_count);
+
+	MatrixJobContext job_context = { self, other, 0, filter_size, 0, 0, 0, 0, 0, 0 };
+
+	ThreadPool_parallel_for(
+		thread_pool,
+		Matrix_colwise_box_filter_job,
+		&job_context,
+		0,
+		self->col_count,
+		Matrix_parallel_block_grain(self->row_count, MATRIX_COLWISE_BLOCK_LEN)
+	);
+}
+
+
+static void
+Matrix_rowwise_iterated_box_filter_job(
+	void* context,
+	size_t begin,
+	size_t end
+) {
+	const MatrixJobContext* job_context = (const MatrixJobContext*)context;
+	Matrix* self = job_context->self;
+	const Matrix* other = job_context->other;
+	size_t col_count = other->col_count;
+
+	// The blocks of rows are transposed, so that each row is a lane
+	real_t* rows = Matrix_acquire_job_scratch(job_context);
+	real_t* filtered_rows = rows + col_count * MATRIX_ROWWISE_BLOCK_LEN;
+	real_t* buffer = filtered_rows + col_count * MATRIX_ROWWISE_BLOCK_LEN;
+
+	for(size_t i = begin; i < end; i += MATRIX_ROWWISE_BLOCK_LEN) {
+		size_t block_len = (end - i < MATRIX_ROWWISE_BLOCK_LEN) ? end - i : MATRIX_ROWWISE_BLOCK_LEN;
+
+		array_ops_transpose(
+			rows,
+			other->data + i * other->row_stride,
+			block_len,
+			col_count,
+			block_len,
+			other->row_stride
+		);
+
+		array_ops_block_iterated_box_filter(
+			filtered_rows,
+			rows,
+			col_count,
+			job_context->filter_sizes,
+			job_context->pass_count,
+			block_len,
+			block_len,
+			block_len,
+			buffer
+		);
+
+		array_ops_transpose(
+			self->data + i * self->row_stride,
+			filtered_rows,
+			col_count,
+			block_len,
+			self->row_stride,
+			block_len
+		);
+	}
+
+	Matrix_release_job_scratch(job_context, rows);
+}
+
+
+void
+Matrix_rowwise_iterated_box_filter(
+	Matrix* self,
+	const Matrix* other,
+	const size_t* filter_sizes,
+	size_t pass_count
+) {
+	Matrix_parallel_rowwise_iterated_box_filter(self, other, filter_sizes, pass_count, 0);
+}
+
+
+void
+Matrix_parallel_rowwise_iterated_box_filter(
+	Matrix* self,
+	const Matrix* other,
+	const size_t* filter_sizes,
+	size_t pass_count,
+	ThreadPool* thread_pool
+) {
+	assert(self);
+	assert(self->data);
+	assert(other);
+	assert(other->data);
+	assert(filter_sizes);
+	assert(self != other);
+	assert(self->row_count == other->row_count);
+	assert(self->col_count == other->col_count);
+
+	MatrixJobContext job_context = { self, other, 0, 0, filter_sizes, pass_count, thread_pool, 0, 0, 0 };
+
+	// Transposed blocks of rows, filtered blocks, and the filter buffer
+	Matrix_allocate_job_scratch(
+		&job_context,
+		2 * self->col_count * MATRIX_ROWWISE_BLOCK_LEN +
+		array_ops_iterated_box_filter_buffer_len(filter_sizes, pass_count, MATRIX_ROWWISE_BLOCK_LEN)
+	);
+
+	ThreadPool_parallel_for(
+		thread_pool,
+		Matrix_rowwise_iterated_box_filter_job,
+		&job_context,
+		0,
+		self->row_count,
+		Matrix_parallel_block_grain(self->col_count, MATRIX_ROWWISE_BLOCK_LEN)
+	);
+
+	array_ops_free(job_context.scratch);
+}
+
+
+static void
+Matrix_colwise_iterated_box_filter_job(
+	void* context,
+	size_t begin,
+	size_t end
+) {
+	const MatrixJobContext* job_context = (const MatrixJobContext*)context;
+	Matrix* self = job_context->self;
+	const Matrix* other = job_context->other;
+
+	real_t* buffer = Matrix_acquire_job_scratch(job_context);
+
+	for(size_t j = begin; j < end; j += MATRIX_COLWISE_BLOCK_LEN)
+		array_ops_block_iterated_box_filter(
+			self->data + j,
+			other->data + j,
+			other->row_count,
+			job_context->filter_sizes,
+			job_context->pass_count,
+			(end - j < MATRIX_COLWISE_BLOCK_LEN) ? end - j : MATRIX_COLWISE_BLOCK_LEN,
+			self->row_stride,
+			other->row_stride,
+			buffer
 		);
+
+	Matrix_release_job_scratch(job_context, buffer);
+}
+
+
+void
+Matrix_colwise_iterated_box_filter(
+	Matrix* self,
+	const Matrix* other,
+	const size_t* filter_sizes,
+	size_t pass_count
+) {
+	Matrix_parallel_colwise_iterated_box_filter(self, other, filter_sizes, pass_count, 0);
+}
+
+
+void
+Matrix_parallel_colwise_iterated_box_filter(
+	Matrix* self,
+	const Matrix* other,
+	const size_t* filter_sizes,
+	size_t pass_count,
+	ThreadPool* thread_pool
+) {
+	assert(self);
+	assert(self->data);
+	assert(other);
+	assert(other->data);
+	assert(filter_sizes);
+	assert(self != other);
+	assert(self->row_count == other->row_count);
+	assert(self->col_count == other->col_count);
+
+	MatrixJobContext job_context = { self, other, 0, 0, filter_sizes, pass_count, thread_pool, 0, 0, 0 };
+
+	Matrix_allocate_job_scratch(
+		&job_context,
+		array_ops_iterated_box_filter_buffer_len(filter_sizes, pass_count, MATRIX_COLWISE_BLOCK_LEN)
+	);
+
+	ThreadPool_parallel_for(
+		thread_pool,
+		Matrix_colwise_iterated_box_filter_job,
+		&job_context,
+		0,
+		self->col_count,
+		Matrix_parallel_block_grain(self->row_count, MATRIX_COLWISE_BLOCK_LEN)
+	);
+
+	array_ops_free(job_context.scratch);
 }
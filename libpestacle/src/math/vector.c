@@ -23,7 +23,7 @@ Vector_destroy(
 	assert(self);
 	assert(self->data);
 
-	free(self->data);
+	array_ops_free(self->data);
 
 	#ifdef DEBUG
 	self->len = 0;
@@ -1,4 +1,7 @@
 #include <stdlib.h>
+#if defined(__MINGW32__)
+#include <malloc.h>
+#endif
 #include <pestacle/memory.h>
 #include <pestacle/errors.h>
 
@@ -21,3 +24,29 @@ checked_calloc(size_t nmemb, size_t size) {
 
 	return ret;
 }
+
+
+void*
+checked_aligned_malloc(size_t size, size_t alignment) {
+	#if defined(__MINGW32__)
+	void* ret = _aligned_malloc(size, alignment);
+	#else
+	// The size has to be a non-zero multiple of the alignment
+	size_t aligned_size = ((size + alignment - 1) / alignment) * alignment;
+	void* ret = aligned_alloc(alignment, aligned_size ? aligned_size : alignment);
+	#endif
+	if (!ret)
+		handle_out_of_memory_error();
+
+	return ret;
+}
+
+
+void
+aligned_free(void* ptr) {
+	#if defined(__MINGW32__)
+	_aligned_free(ptr);
+	#else
+	free(ptr);
+	#endif
+}
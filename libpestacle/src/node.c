@@ -1,3 +1,4 @@
+#include <string.h>
 #include <assert.h>
 #include <pestacle/node.h>
 #include <pestacle/scope.h>
@@ -27,7 +28,7 @@ NodeDelegate_has_inputs(
 }
 
 
-static size_t
+size_t
 NodeDelegate_input_count(
 	const NodeDelegate* self
 ) {
@@ -61,6 +62,20 @@ Node_new(
 	ret->delegate = delegate;
 	ret->delegate_scope = delegate_scope;
 	ret->out_descriptor.type = DataType__invalid;
+	ret->version = 0;
+	ret->requests_output_buffer = false;
+	ret->output_buffer.row_count = 0;
+	ret->output_buffer.col_count = 0;
+	ret->output_buffer.row_stride = 0;
+	ret->output_buffer.data_len = 0;
+	ret->output_buffer.data = 0;
+	ret->is_in_place = false;
+	ret->is_view = false;
+	ret->element_wise_ops = 0;
+	ret->element_wise_op_count = 0;
+	ret->fusion_head = 0;
+	ret->thread_pool = 0;
+	ret->latched_output = 0;
 
 	// Setup inputs array
 	if (NodeDelegate_has_inputs(delegate)) {
@@ -70,17 +85,22 @@ Node_new(
 
 		ret->inputs = (Node**)checked_malloc(input_count * sizeof(Node*));
 
+		ret->input_versions = (Uint64*)checked_malloc(input_count * sizeof(Uint64));
+
 		DataDescriptor* in_descriptor_ptr = ret->in_descriptors;
 		Node** input_ptr = ret->inputs;
+		Uint64* input_version_ptr = ret->input_versions;
 		const NodeInputDefinition* input_def = ret->delegate->input_defs;
-		for( ; !NodeInputDefinition_is_last(input_def); ++in_descriptor_ptr, ++input_ptr, ++input_def) {
+		for( ; !NodeInputDefinition_is_last(input_def); ++in_descriptor_ptr, ++input_ptr, ++input_version_ptr, ++input_def) {
 			in_descriptor_ptr->type = DataType__invalid;
 			*input_ptr = 0;
+			*input_version_ptr = ~((Uint64)0); // Never seen, forces a first update
 		}
 	}
 	else {
 		ret->in_descriptors = 0;
 		ret->inputs = 0;
+		ret->input_versions = 0;
 	}
 
 	// Setup parameters array
@@ -104,6 +124,10 @@ Node_destroy(
 	// Deallocate the name
 	free(self->name);
 
+	// Deallocate the element-wise operations
+	if (self->element_wise_ops)
+		free(self->element_wise_ops);
+
 	// Deallocate input array
 	if (NodeDelegate_has_inputs(self->delegate)) {
 		#ifdef DEBUG
@@ -115,6 +139,7 @@ Node_destroy(
 	
 		free(self->in_descriptors);
 		free(self->inputs);
+		free(self->input_versions);
 	}
 
 	// Deallocate parameters
@@ -131,6 +156,7 @@ Node_destroy(
 	self->out_descriptor.type = DataType__invalid;
 	self->in_descriptors = 0;
 	self->inputs = 0;
+	self->input_versions = 0;
 	self->parameters = 0;
 	#endif
 }
@@ -238,11 +264,64 @@ Node_update(
 	assert(self);
 	assert(self->delegate);
 
+	// A fused node is updated by the head of its chain
+	if (self->fusion_head)
+		return;
+
 	if (self->delegate->methods.update)
 		self->delegate->methods.update(self);
 }
 
 
+bool
+Node_is_outdated(
+	const Node* self
+) {
+	assert(self);
+	assert(self->delegate);
+
+	if (!self->delegate->methods.update)
+		return false;
+
+	if (!(self->delegate->flags & NodeDelegateFlag__stateless))
+		return true;
+
+	if (!NodeDelegate_has_inputs(self->delegate))
+		return self->version == 0;
+
+	// Check if an input changed since the last update
+	Node** input_ptr = self->inputs;
+	const Uint64* input_version_ptr = self->input_versions;
+	const NodeInputDefinition* input_def = self->delegate->input_defs;
+	for( ; !NodeInputDefinition_is_last(input_def); ++input_ptr, ++input_version_ptr, ++input_def)
+		if ((*input_ptr) && ((*input_ptr)->version != *input_version_ptr))
+			return true;
+
+	return false;
+}
+
+
+void
+Node_mark_updated(
+	Node* self
+) {
+	assert(self);
+	assert(self->delegate);
+
+	self->version += 1;
+
+	// Remember the versions of the inputs used for that update
+	if (NodeDelegate_has_inputs(self->delegate)) {
+		Node** input_ptr = self->inputs;
+		Uint64* input_version_ptr = self->input_versions;
+		const NodeInputDefinition* input_def = self->delegate->input_defs;
+		for( ; !NodeInputDefinition_is_last(input_def); ++input_ptr, ++input_version_ptr, ++input_def)
+			if (*input_ptr)
+				*input_version_ptr = (*input_ptr)->version;
+	}
+}
+
+
 NodeOutput
 Node_output(
 	Node* self
@@ -251,5 +330,110 @@ Node_output(
 	assert(self->delegate);
 	assert(self->delegate->methods.output);
 
+	if (self->latched_output)
+		return *(self->latched_output);
+
 	return self->delegate->methods.output(self);
 }
+
+
+void
+Node_request_output_buffer(
+	Node* self
+) {
+	assert(self);
+	assert(self->out_descriptor.type == DataType__matrix);
+
+	self->requests_output_buffer = true;
+	self->output_buffer.row_count = self->out_descriptor.matrix.height;
+	self->output_buffer.col_count = self->out_descriptor.matrix.width;
+	self->output_buffer.row_stride = self->output_buffer.col_count;
+	self->output_buffer.data_len =
+		self->output_buffer.row_count * self->output_buffer.col_count;
+	self->output_buffer.data = 0;
+}
+
+
+void
+Node_request_output_view(
+	Node* self
+) {
+	assert(self);
+	assert(self->out_descriptor.type == DataType__matrix);
+	assert(NodeDelegate_has_inputs(self->delegate));
+
+	self->is_view = true;
+	self->output_buffer.row_count = self->out_descriptor.matrix.height;
+	self->output_buffer.col_count = self->out_descriptor.matrix.width;
+	self->output_buffer.row_stride = self->output_buffer.col_count;
+	self->output_buffer.data_len =
+		self->output_buffer.row_count * self->output_buffer.col_count;
+	self->output_buffer.data = 0;
+}
+
+
+void
+Node_set_element_wise_ops(
+	Node* self,
+	const ArrayOp* ops,
+	size_t op_count
+) {
+	assert(self);
+	assert(ops);
+	assert(self->requests_output_buffer);
+
+	if (self->element_wise_ops)
+		free(self->element_wise_ops);
+
+	self->element_wise_ops = (ArrayOp*)checked_malloc(op_count * sizeof(ArrayOp));
+	memcpy(self->element_wise_ops, ops, op_count * sizeof(ArrayOp));
+	self->element_wise_op_count = op_count;
+}
+
+
+void
+Node_run_element_wise_ops(
+	Node* self
+) {
+	assert(self);
+
+	Matrix_parallel_run(
+		&(self->output_buffer),
+		self->element_wise_ops,
+		self->element_wise_op_count,
+		self->thread_pool
+	);
+}
+
+
+void
+Node_fuse_element_wise_ops(
+	Node* self,
+	Node* other
+) {
+	assert(self);
+	assert(other);
+	assert(!self->fusion_head);
+	assert(!other->fusion_head);
+
+	size_t op_count = self->element_wise_op_count + other->element_wise_op_count;
+
+	ArrayOp* ops = (ArrayOp*)checked_malloc(op_count * sizeof(ArrayOp));
+
+	memcpy(
+		ops,
+		self->element_wise_ops,
+		self->element_wise_op_count * sizeof(ArrayOp)
+	);
+
+	memcpy(
+		ops + self->element_wise_op_count,
+		other->element_wise_ops,
+		other->element_wise_op_count * sizeof(ArrayOp)
+	);
+
+	free(self->element_wise_ops);
+	self->element_wise_ops = ops;
+	self->element_wise_op_count = op_count;
+	other->fusion_head = self;
+}
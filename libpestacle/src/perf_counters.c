@@ -0,0 +1,252 @@
+#if defined(__linux__)
+#define _GNU_SOURCE // For syscall
+#endif
+
+#include <errno.h>
+#include <string.h>
+#include <assert.h>
+#include <SDL_log.h>
+#include <pestacle/perf_counters.h>
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+
+#if defined(__linux__)
+
+static const uint64_t
+perf_counter_configs[PerfCounter__count] = {
+	PERF_COUNT_HW_CPU_CYCLES,
+	PERF_COUNT_HW_INSTRUCTIONS,
+	PERF_COUNT_HW_CACHE_MISSES,
+	PERF_COUNT_HW_BRANCH_MISSES
+};
+
+
+static int
+perf_event_open(
+	struct perf_event_attr* attr,
+	int group_fd
+) {
+	// Count the calling thread, on any CPU, in user space only, so that the
+	// default perf_event_paranoid setting allows it
+	return (int)syscall(__NR_perf_event_open, attr, 0, -1, group_fd, 0);
+}
+
+#endif
+
+
+static void
+PerfCounterGroup_init(
+	PerfCounterGroup* self
+) {
+	self->thread_id = SDL_ThreadID();
+	self->leader_fd = -1;
+	self->value_count = 0;
+
+	for(size_t i = 0; i < PerfCounter__count; ++i)
+		self->fds[i] = -1;
+
+	#if defined(__linux__)
+	for(size_t i = 0; i < PerfCounter__count; ++i) {
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = perf_counter_configs[i];
+		attr.read_format =
+			PERF_FORMAT_GROUP |
+			PERF_FORMAT_TOTAL_TIME_ENABLED |
+			PERF_FORMAT_TOTAL_TIME_RUNNING;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+
+		int fd = perf_event_open(&attr, self->leader_fd);
+		if (fd < 0)
+			continue;
+
+		if (self->leader_fd < 0)
+			self->leader_fd = fd;
+
+		self->fds[i] = fd;
+		self->value_indices[i] = self->value_count;
+		self->value_count += 1;
+	}
+	#endif
+}
+
+
+static void
+PerfCounterGroup_destroy(
+	PerfCounterGroup* self
+) {
+	#if defined(__linux__)
+	// Close the leader last
+	for(size_t i = PerfCounter__count; i != 0; --i)
+		if (self->fds[i - 1] >= 0)
+			close(self->fds[i - 1]);
+	#else
+	(void)self;
+	#endif
+}
+
+
+// Add the counts of a group to values
+static void
+PerfCounterGroup_read(
+	const PerfCounterGroup* self,
+	PerfCounterValues* values
+) {
+	#if defined(__linux__)
+	if (self->leader_fd < 0)
+		return;
+
+	// The group is read at once, as its number of counters, the times it was
+	// enabled and running, followed by the value of each counter
+	uint64_t buffer[PerfCounter__count + 3];
+	size_t buffer_len = (self->value_count + 3) * sizeof(uint64_t);
+	if (read(self->leader_fd, buffer, buffer_len) != (ssize_t)buffer_len)
+		return;
+
+	uint64_t time_enabled = buffer[1];
+	uint64_t time_running = buffer[2];
+	values->time_enabled += time_enabled;
+	values->time_running += time_running;
+
+	// Nothing was counted if the group never had the hardware
+	if (time_running == 0)
+		return;
+
+	// Extrapolate the counts of a group which shared the hardware
+	for(size_t i = 0; i < PerfCounter__count; ++i) {
+		if (self->fds[i] < 0)
+			continue;
+
+		uint64_t value = buffer[3 + self->value_indices[i]];
+		if (time_running < time_enabled)
+			value = (uint64_t)(((double)value) * time_enabled / time_running);
+
+		values->values[i] += value;
+	}
+	#else
+	(void)self;
+	(void)values;
+	#endif
+}
+
+
+bool
+PerfCounters_init(
+	PerfCounters* self
+) {
+	assert(self);
+
+	self->lock = 0;
+	SDL_AtomicSet(&(self->group_count), 1);
+
+	PerfCounterGroup* group = self->groups;
+	PerfCounterGroup_init(group);
+
+	for(size_t i = 0; i < PerfCounter__count; ++i)
+		self->is_available[i] = group->fds[i] >= 0;
+
+	#if defined(__linux__)
+	if (group->leader_fd < 0) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to open the performance counters: %s%s",
+			strerror(errno),
+			((errno == EACCES) || (errno == EPERM)) ? " (see /proc/sys/kernel/perf_event_paranoid)" : ""
+		);
+		return false;
+	}
+
+	return true;
+	#else
+	SDL_LogError(
+		SDL_LOG_CATEGORY_SYSTEM,
+		"Performance counters are only supported on Linux"
+	);
+	return false;
+	#endif
+}
+
+
+void
+PerfCounters_destroy(
+	PerfCounters* self
+) {
+	assert(self);
+
+	size_t group_count = (size_t)SDL_AtomicGet(&(self->group_count));
+	for(size_t i = 0; i < group_count; ++i)
+		PerfCounterGroup_destroy(self->groups + i);
+
+	#ifdef DEBUG
+	SDL_AtomicSet(&(self->group_count), 0);
+	#endif
+}
+
+
+bool
+PerfCounters_is_available(
+	const PerfCounters* self,
+	enum PerfCounter counter
+) {
+	assert(self);
+	assert(counter < PerfCounter__count);
+
+	return self->is_available[counter];
+}
+
+
+void
+PerfCounters_add_thread(
+	PerfCounters* self
+) {
+	assert(self);
+
+	SDL_threadID thread_id = SDL_ThreadID();
+
+	// Look for the group of the calling thread. Groups are only appended,
+	// once fully initialized, thus the lookup does not need the lock.
+	size_t group_count = (size_t)SDL_AtomicGet(&(self->group_count));
+	for(size_t i = 0; i < group_count; ++i)
+		if (self->groups[i].thread_id == thread_id)
+			return;
+
+	// Open the group of the calling thread
+	SDL_AtomicLock(&(self->lock));
+
+	group_count = (size_t)SDL_AtomicGet(&(self->group_count));
+	if (group_count < PERF_COUNTERS_MAX_THREAD_COUNT) {
+		PerfCounterGroup_init(self->groups + group_count);
+		SDL_AtomicSet(&(self->group_count), (int)(group_count + 1));
+	}
+
+	SDL_AtomicUnlock(&(self->lock));
+}
+
+
+void
+PerfCounters_read(
+	PerfCounters* self,
+	PerfCounterValues* values
+) {
+	assert(self);
+	assert(values);
+
+	PerfCounters_add_thread(self);
+
+	for(size_t i = 0; i < PerfCounter__count; ++i)
+		values->values[i] = 0;
+	values->time_enabled = 0;
+	values->time_running = 0;
+
+	size_t group_count = (size_t)SDL_AtomicGet(&(self->group_count));
+	for(size_t i = 0; i < group_count; ++i)
+		PerfCounterGroup_read(self->groups + i, values);
+}
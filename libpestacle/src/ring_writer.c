@@ -0,0 +1,245 @@
+#include <assert.h>
+#include <SDL_log.h>
+#include <pestacle/memory.h>
+#include <pestacle/ring_writer.h>
+
+
+// --- Implementation ---------------------------------------------------------
+
+static int
+RingWriter_writer_main(
+	void* data
+) {
+	RingWriter* self = (RingWriter*)data;
+
+	while(true) {
+		// Wait for a slot to write
+		SDL_SemWait(self->ready_slots);
+
+		if (self->is_last[self->read_slot])
+			break;
+
+		// Write the slot
+		if (self->write(self->caller, self->slots + self->read_slot * self->slot_size))
+			SDL_AtomicIncRef(&(self->written_count));
+		else
+			SDL_AtomicIncRef(&(self->failed_count));
+
+		// Hand the slot back to the pushing thread
+		self->read_slot = (self->read_slot + 1) % self->slot_count;
+		SDL_SemPost(self->free_slots);
+	}
+
+	return 0;
+}
+
+
+bool
+RingWriter_init(
+	RingWriter* self,
+	void* slots,
+	size_t slot_count,
+	size_t slot_size,
+	RingWriterPolicy policy,
+	RingWriter__copy copy,
+	RingWriter__write write,
+	void* caller,
+	const char* thread_name
+) {
+	assert(self);
+	assert(slots);
+	assert(slot_count > 0);
+	assert(copy);
+	assert(write);
+
+	// Initialize members
+	self->policy = policy;
+	self->copy = copy;
+	self->write = write;
+	self->caller = caller;
+	self->slots = (uint8_t*)slots;
+	self->slot_count = slot_count;
+	self->slot_size = slot_size;
+	self->is_last = (bool*)checked_calloc(slot_count, sizeof(bool));
+	self->write_slot = 0;
+	self->read_slot = 0;
+	self->free_slots = 0;
+	self->ready_slots = 0;
+	self->thread = 0;
+
+	SDL_AtomicSet(&(self->queued_count), 0);
+	SDL_AtomicSet(&(self->written_count), 0);
+	SDL_AtomicSet(&(self->failed_count), 0);
+	SDL_AtomicSet(&(self->dropped_count), 0);
+
+	// Create the writer thread
+	self->free_slots = SDL_CreateSemaphore((Uint32)slot_count);
+	self->ready_slots = SDL_CreateSemaphore(0);
+	if ((!self->free_slots) || (!self->ready_slots)) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to create writer semaphores: %s",
+			SDL_GetError()
+		);
+		goto failure;
+	}
+
+	self->thread =
+		SDL_CreateThread(
+			RingWriter_writer_main,
+			thread_name,
+			self
+		);
+
+	if (!self->thread) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to create writer thread: %s",
+			SDL_GetError()
+		);
+		goto failure;
+	}
+
+	// Job done
+	return true;
+
+failure:
+	RingWriter_destroy(self);
+	return false;
+}
+
+
+void
+RingWriter_destroy(
+	RingWriter* self
+) {
+	assert(self);
+
+	// Queue a stop request behind the pending slots, and wait for it
+	if (self->thread) {
+		SDL_SemWait(self->free_slots);
+		self->is_last[self->write_slot] = true;
+		SDL_SemPost(self->ready_slots);
+		SDL_WaitThread(self->thread, 0);
+	}
+
+	if (self->ready_slots)
+		SDL_DestroySemaphore(self->ready_slots);
+
+	if (self->free_slots)
+		SDL_DestroySemaphore(self->free_slots);
+
+	free(self->is_last);
+
+	#ifdef DEBUG
+	self->slots = 0;
+	self->is_last = 0;
+	self->free_slots = 0;
+	self->ready_slots = 0;
+	self->thread = 0;
+	#endif
+}
+
+
+bool
+RingWriter_push(
+	RingWriter* self,
+	const void* item
+) {
+	assert(self);
+
+	// Wait for a free slot, or drop the item
+	switch(self->policy) {
+		case RingWriterPolicy__block:
+			SDL_SemWait(self->free_slots);
+			break;
+
+		case RingWriterPolicy__drop:
+			if (SDL_SemTryWait(self->free_slots)) {
+				SDL_AtomicIncRef(&(self->dropped_count));
+				return false;
+			}
+			break;
+	}
+
+	// Copy the item to the slot
+	self->copy(self->caller, self->slots + self->write_slot * self->slot_size, item);
+
+	// Hand the slot to the writer thread
+	self->write_slot = (self->write_slot + 1) % self->slot_count;
+	SDL_AtomicIncRef(&(self->queued_count));
+	SDL_SemPost(self->ready_slots);
+
+	// Job done
+	return true;
+}
+
+
+void
+RingWriter_wait(
+	RingWriter* self
+) {
+	assert(self);
+
+	// All the slots are free once the writer thread is idle
+	for(size_t i = 0; i < self->slot_count; ++i)
+		SDL_SemWait(self->free_slots);
+
+	for(size_t i = 0; i < self->slot_count; ++i)
+		SDL_SemPost(self->free_slots);
+}
+
+
+size_t
+RingWriter_queued_count(
+	RingWriter* self
+) {
+	assert(self);
+
+	return (size_t)SDL_AtomicGet(&(self->queued_count));
+}
+
+
+size_t
+RingWriter_pending_count(
+	RingWriter* self
+) {
+	assert(self);
+
+	// Read the counts of written slots first, as they only grow
+	size_t done_count =
+		(size_t)SDL_AtomicGet(&(self->written_count)) +
+		(size_t)SDL_AtomicGet(&(self->failed_count));
+
+	return RingWriter_queued_count(self) - done_count;
+}
+
+
+size_t
+RingWriter_written_count(
+	RingWriter* self
+) {
+	assert(self);
+
+	return (size_t)SDL_AtomicGet(&(self->written_count));
+}
+
+
+size_t
+RingWriter_failed_count(
+	RingWriter* self
+) {
+	assert(self);
+
+	return (size_t)SDL_AtomicGet(&(self->failed_count));
+}
+
+
+size_t
+RingWriter_dropped_count(
+	RingWriter* self
+) {
+	assert(self);
+
+	return (size_t)SDL_AtomicGet(&(self->dropped_count));
+}
@@ -0,0 +1,430 @@
+#include <assert.h>
+#include <SDL_log.h>
+#include <pestacle/memory.h>
+#include <pestacle/thread_pool.h>
+
+
+// Worker associated to the running thread, 0 outside of the pools
+static _Thread_local ThreadPoolWorker* current_worker = 0;
+
+
+// --- ThreadPoolDeque --------------------------------------------------------
+
+static void
+ThreadPoolDeque_init(
+	ThreadPoolDeque* self
+) {
+	self->lock = 0;
+	self->top = 0;
+	self->bottom = 0;
+}
+
+
+static bool
+ThreadPoolDeque_push(
+	ThreadPoolDeque* self,
+	const ThreadPoolTask* task
+) {
+	bool ret = false;
+
+	SDL_AtomicLock(&(self->lock));
+	if (self->bottom - self->top < THREAD_POOL_DEQUE_CAPACITY) {
+		self->tasks[self->bottom % THREAD_POOL_DEQUE_CAPACITY] = *task;
+		self->bottom += 1;
+		ret = true;
+	}
+	SDL_AtomicUnlock(&(self->lock));
+
+	return ret;
+}
+
+
+static bool
+ThreadPoolDeque_pop(
+	ThreadPoolDeque* self,
+	ThreadPoolTask* task
+) {
+	bool ret = false;
+
+	SDL_AtomicLock(&(self->lock));
+	if (self->bottom != self->top) {
+		self->bottom -= 1;
+		*task = self->tasks[self->bottom % THREAD_POOL_DEQUE_CAPACITY];
+		ret = true;
+	}
+	SDL_AtomicUnlock(&(self->lock));
+
+	return ret;
+}
+
+
+static bool
+ThreadPoolDeque_steal(
+	ThreadPoolDeque* self,
+	ThreadPoolTask* task
+) {
+	bool ret = false;
+
+	SDL_AtomicLock(&(self->lock));
+	if (self->bottom != self->top) {
+		*task = self->tasks[self->top % THREAD_POOL_DEQUE_CAPACITY];
+		self->top += 1;
+		ret = true;
+	}
+	SDL_AtomicUnlock(&(self->lock));
+
+	return ret;
+}
+
+
+// --- ThreadPool -------------------------------------------------------------
+
+static ThreadPoolWorker*
+ThreadPool_get_worker(
+	ThreadPool* self
+) {
+	if (current_worker && (current_worker->pool == self))
+		return current_worker;
+
+	return self->workers + self->thread_count;
+}
+
+
+static void
+ThreadPool_wake_up(
+	ThreadPool* self,
+	bool all
+) {
+	if (SDL_AtomicGet(&(self->sleeping_thread_count)) > 0) {
+		SDL_LockMutex(self->mutex);
+		if (all)
+			SDL_CondBroadcast(self->wake_up);
+		else
+			SDL_CondSignal(self->wake_up);
+		SDL_UnlockMutex(self->mutex);
+	}
+}
+
+
+static bool
+ThreadPool_push_task(
+	ThreadPool* self,
+	ThreadPoolWorker* worker,
+	const ThreadPoolTask* task
+) {
+	if (!ThreadPoolDeque_push(&(worker->deque), task))
+		return false;
+
+	SDL_AtomicAdd(&(self->queued_task_count), 1);
+	ThreadPool_wake_up(self, false);
+	return true;
+}
+
+
+static bool
+ThreadPool_find_task(
+	ThreadPool* self,
+	ThreadPoolWorker* worker,
+	ThreadPoolTask* task
+) {
+	if (SDL_AtomicGet(&(self->queued_task_count)) == 0)
+		return false;
+
+	// Newest task of our own deque first
+	bool found = ThreadPoolDeque_pop(&(worker->deque), task);
+
+	// Otherwise, steal the oldest task from an other deque
+	for(size_t i = 1; (!found) && (i < self->worker_count); ++i) {
+		ThreadPoolWorker* victim =
+			self->workers + ((worker->index + i) % self->worker_count);
+
+		found = ThreadPoolDeque_steal(&(victim->deque), task);
+	}
+
+	if (found)
+		SDL_AtomicAdd(&(self->queued_task_count), -1);
+
+	return found;
+}
+
+
+static void
+ThreadPool_run_task(
+	ThreadPool* self,
+	ThreadPoolWorker* worker,
+	ThreadPoolTask* task
+) {
+	ThreadPoolTaskGroup* group = task->group;
+
+	// Split the range, leaving the right halves to other threads
+	while(task->end - task->begin > group->grain) {
+		ThreadPoolTask right_task = {
+			group,
+			task->begin + (task->end - task->begin) / 2,
+			task->end
+		};
+
+		if (!ThreadPool_push_task(self, worker, &right_task))
+			break;
+
+		task->end = right_task.begin;
+	}
+
+	// Process the remaining range
+	group->job(group->context, task->begin, task->end);
+
+	// Notify the waiting threads if the group is completed
+	int count = (int)(task->end - task->begin);
+	if (SDL_AtomicAdd(&(group->pending_count), -count) == count)
+		ThreadPool_wake_up(self, true);
+}
+
+
+static int
+ThreadPool_worker_main(
+	void* data
+) {
+	ThreadPoolWorker* worker = (ThreadPoolWorker*)data;
+	ThreadPool* self = worker->pool;
+
+	current_worker = worker;
+
+	while(!SDL_AtomicGet(&(self->quit))) {
+		ThreadPoolTask task;
+		if (ThreadPool_find_task(self, worker, &task)) {
+			ThreadPool_run_task(self, worker, &task);
+			continue;
+		}
+
+		// Sleep until new tasks are queued
+		SDL_LockMutex(self->mutex);
+		SDL_AtomicAdd(&(self->sleeping_thread_count), 1);
+		while((SDL_AtomicGet(&(self->queued_task_count)) == 0) && (!SDL_AtomicGet(&(self->quit))))
+			SDL_CondWait(self->wake_up, self->mutex);
+		SDL_AtomicAdd(&(self->sleeping_thread_count), -1);
+		SDL_UnlockMutex(self->mutex);
+	}
+
+	current_worker = 0;
+	return 0;
+}
+
+
+bool
+ThreadPool_init(
+	ThreadPool* self,
+	size_t thread_count
+) {
+	assert(self);
+
+	// Initialize members
+	self->thread_count = 0;
+	self->threads = 0;
+	SDL_AtomicSet(&(self->queued_task_count), 0);
+	SDL_AtomicSet(&(self->sleeping_thread_count), 0);
+	SDL_AtomicSet(&(self->quit), 0);
+
+	// Setup the workers
+	self->worker_count = thread_count + 1;
+	self->workers =
+		(ThreadPoolWorker*)checked_malloc(self->worker_count * sizeof(ThreadPoolWorker));
+
+	for(size_t i = 0; i < self->worker_count; ++i) {
+		self->workers[i].pool = self;
+		self->workers[i].index = i;
+		ThreadPoolDeque_init(&(self->workers[i].deque));
+	}
+
+	// Create synchronization primitives
+	self->mutex = SDL_CreateMutex();
+	self->wake_up = SDL_CreateCond();
+
+	if ((!self->mutex) || (!self->wake_up)) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to create thread pool synchronization primitives: %s",
+			SDL_GetError()
+		);
+		goto failure;
+	}
+
+	// Create the worker threads
+	if (thread_count > 0)
+		self->threads = (SDL_Thread**)checked_malloc(thread_count * sizeof(SDL_Thread*));
+
+	for( ; self->thread_count < thread_count; ++self->thread_count) {
+		SDL_Thread* thread =
+			SDL_CreateThread(
+				ThreadPool_worker_main,
+				"pestacle-worker",
+				self->workers + self->thread_count
+			);
+
+		if (!thread) {
+			SDL_LogError(
+				SDL_LOG_CATEGORY_SYSTEM,
+				"Unable to create worker thread: %s",
+				SDL_GetError()
+			);
+			goto failure;
+		}
+
+		self->threads[self->thread_count] = thread;
+	}
+
+	// Job done
+	return true;
+
+failure:
+	ThreadPool_destroy(self);
+	return false;
+}
+
+
+void
+ThreadPool_destroy(
+	ThreadPool* self
+) {
+	assert(self);
+
+	// Stop the worker threads
+	SDL_AtomicSet(&(self->quit), 1);
+	if (self->mutex && self->wake_up) {
+		SDL_LockMutex(self->mutex);
+		SDL_CondBroadcast(self->wake_up);
+		SDL_UnlockMutex(self->mutex);
+	}
+
+	for(size_t i = 0; i < self->thread_count; ++i)
+		SDL_WaitThread(self->threads[i], 0);
+
+	if (self->threads)
+		free(self->threads);
+
+	free(self->workers);
+
+	// Release the synchronization primitives
+	if (self->wake_up)
+		SDL_DestroyCond(self->wake_up);
+
+	if (self->mutex)
+		SDL_DestroyMutex(self->mutex);
+
+	#ifdef DEBUG
+	self->thread_count = 0;
+	self->threads = 0;
+	self->worker_count = 0;
+	self->workers = 0;
+	self->mutex = 0;
+	self->wake_up = 0;
+	#endif
+}
+
+
+void
+ThreadPool_submit(
+	ThreadPool* self,
+	ThreadPoolTaskGroup* group,
+	ThreadPoolJob job,
+	void* context,
+	size_t begin,
+	size_t end,
+	size_t grain
+) {
+	assert(group);
+	assert(job);
+	assert(begin <= end);
+
+	group->job = job;
+	group->context = context;
+	group->grain = (grain > 0) ? grain : 1;
+	SDL_AtomicSet(&(group->pending_count), (int)(end - begin));
+
+	if (begin == end)
+		return;
+
+	// Without a pool, run the job right away
+	if (!self) {
+		job(context, begin, end);
+		SDL_AtomicSet(&(group->pending_count), 0);
+		return;
+	}
+
+	// Queue the task, or run it if the deque is full
+	ThreadPoolWorker* worker = ThreadPool_get_worker(self);
+	ThreadPoolTask task = { group, begin, end };
+
+	if (!ThreadPool_push_task(self, worker, &task))
+		ThreadPool_run_task(self, worker, &task);
+}
+
+
+void
+ThreadPool_wait(
+	ThreadPool* self,
+	ThreadPoolTaskGroup* group
+) {
+	assert(group);
+
+	if (!self) {
+		assert(SDL_AtomicGet(&(group->pending_count)) == 0);
+		return;
+	}
+
+	ThreadPoolWorker* worker = ThreadPool_get_worker(self);
+
+	while(SDL_AtomicGet(&(group->pending_count)) > 0) {
+		// Help the other threads
+		ThreadPoolTask task;
+		if (ThreadPool_find_task(self, worker, &task)) {
+			ThreadPool_run_task(self, worker, &task);
+			continue;
+		}
+
+		// Sleep until new tasks are queued or the group is completed
+		SDL_LockMutex(self->mutex);
+		SDL_AtomicAdd(&(self->sleeping_thread_count), 1);
+		while((SDL_AtomicGet(&(self->queued_task_count)) == 0) && (SDL_AtomicGet(&(group->pending_count)) > 0))
+			SDL_CondWait(self->wake_up, self->mutex);
+		SDL_AtomicAdd(&(self->sleeping_thread_count), -1);
+		SDL_UnlockMutex(self->mutex);
+	}
+}
+
+
+void
+ThreadPool_parallel_for(
+	ThreadPool* self,
+	ThreadPoolJob job,
+	void* context,
+	size_t begin,
+	size_t end,
+	size_t grain
+) {
+	ThreadPoolTaskGroup group;
+
+	ThreadPool_submit(self, &group, job, context, begin, end, grain);
+	ThreadPool_wait(self, &group);
+}
+
+
+size_t
+ThreadPool_worker_count(
+	const ThreadPool* self
+) {
+	if (!self)
+		return 1;
+
+	return self->worker_count;
+}
+
+
+size_t
+ThreadPool_worker_index(
+	ThreadPool* self
+) {
+	if (!self)
+		return 0;
+
+	return ThreadPool_get_worker(self)->index;
+}
@@ -0,0 +1,177 @@
+#include <errno.h>
+#include <string.h>
+#include <assert.h>
+#include <SDL_log.h>
+#include <SDL_timer.h>
+#include <pestacle/memory.h>
+#include <pestacle/trace.h>
+
+
+void
+Trace_init(
+	Trace* self,
+	size_t capacity
+) {
+	assert(self);
+	assert(capacity > 0);
+
+	self->capacity = 1;
+	while(self->capacity < capacity)
+		self->capacity *= 2;
+
+	SDL_AtomicSet(&(self->event_count), 0);
+	self->events = (TraceEvent*)checked_malloc(self->capacity * sizeof(TraceEvent));
+	self->start_time = SDL_GetPerformanceCounter();
+	self->main_thread_id = SDL_ThreadID();
+}
+
+
+void
+Trace_destroy(
+	Trace* self
+) {
+	assert(self);
+
+	free(self->events);
+
+	#ifdef DEBUG
+	self->capacity = 0;
+	self->events = 0;
+	#endif
+}
+
+
+void
+Trace_record(
+	Trace* self,
+	const char* name,
+	Uint64 start_time,
+	Uint64 end_time
+) {
+	assert(self);
+	assert(name);
+
+	// The count wraps around as an unsigned value, a multiple of the capacity
+	unsigned int index = (unsigned int)SDL_AtomicAdd(&(self->event_count), 1);
+
+	TraceEvent* event = self->events + (index & (self->capacity - 1));
+	event->name = name;
+	event->thread_id = SDL_ThreadID();
+	event->start_time = start_time;
+	event->end_time = end_time;
+}
+
+
+static void
+Trace_print_string(
+	const char* str,
+	FILE* fp
+) {
+	fputc('"', fp);
+	for( ; *str; ++str) {
+		if ((*str == '"') || (*str == '\\'))
+			fputc('\\', fp);
+
+		if ((unsigned char)(*str) < 0x20)
+			fprintf(fp, "\\u%04x", (unsigned int)(*str));
+		else
+			fputc(*str, fp);
+	}
+	fputc('"', fp);
+}
+
+
+bool
+Trace_save(
+	const Trace* self,
+	const char* path
+) {
+	assert(self);
+	assert(path);
+
+	FILE* fp = fopen(path, "w");
+	if (!fp) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to open file '%s': %s",
+			path,
+			strerror(errno)
+		);
+		return false;
+	}
+
+	// Oldest event still in the ring buffer
+	size_t event_count = (size_t)(unsigned int)SDL_AtomicGet((SDL_atomic_t*)&(self->event_count));
+	size_t first = 0;
+	if (event_count > self->capacity) {
+		first = event_count - self->capacity;
+		SDL_Log("trace: %zu oldest event(s) overwritten", first);
+	}
+
+	// Assign a track to each thread, the main thread first
+	size_t thread_count = 1;
+	SDL_threadID* thread_ids = (SDL_threadID*)checked_malloc((event_count - first + 1) * sizeof(SDL_threadID));
+	thread_ids[0] = self->main_thread_id;
+
+	for(size_t i = first; i < event_count; ++i) {
+		SDL_threadID thread_id = self->events[i & (self->capacity - 1)].thread_id;
+
+		size_t j = 0;
+		while((j < thread_count) && (thread_ids[j] != thread_id))
+			++j;
+
+		if (j == thread_count)
+			thread_ids[thread_count++] = thread_id;
+	}
+
+	// Write the events, the times being in microseconds
+	double tick_period = 1e6 / (double)SDL_GetPerformanceFrequency();
+
+	fprintf(fp, "{\"traceEvents\":[\n");
+	fprintf(fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"pestacle\"}}");
+
+	for(size_t i = 0; i < thread_count; ++i) {
+		fprintf(fp, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":", i);
+		if (i == 0)
+			fprintf(fp, "\"main\"");
+		else
+			fprintf(fp, "\"worker %zu\"", i);
+		fprintf(fp, "}}");
+	}
+
+	for(size_t i = first; i < event_count; ++i) {
+		const TraceEvent* event = self->events + (i & (self->capacity - 1));
+
+		size_t track = 0;
+		while(thread_ids[track] != event->thread_id)
+			++track;
+
+		fprintf(fp, ",\n{\"name\":");
+		Trace_print_string(event->name, fp);
+		fprintf(
+			fp,
+			",\"ph\":\"X\",\"pid\":1,\"tid\":%zu,\"ts\":%.3f,\"dur\":%.3f}",
+			track,
+			tick_period * (double)(event->start_time - self->start_time),
+			tick_period * (double)(event->end_time - event->start_time)
+		);
+	}
+
+	fprintf(fp, "\n]}\n");
+
+	free(thread_ids);
+
+	// Job done
+	bool ret = !ferror(fp);
+	if (fclose(fp) || (!ret)) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to write file '%s': %s",
+			path,
+			strerror(errno)
+		);
+		return false;
+	}
+
+	return true;
+}
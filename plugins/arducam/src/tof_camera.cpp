@@ -57,6 +57,7 @@ arducam_tof_camera_node_delegate = {
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__none
 };
 
 
@@ -67,6 +67,7 @@ ffmpeg_load_node_delegate = {
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__none
 };
 
 
@@ -0,0 +1,120 @@
+#ifndef PESTACLE_PLUGIN_MATRIX_IO_ASYNC_WRITER_H
+#define PESTACLE_PLUGIN_MATRIX_IO_ASYNC_WRITER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/******************************************************************************
+  Writes matrices from a dedicated thread. The render thread copies a matrix
+  into a free slot of a ring of preallocated matrices (see RingWriter), and
+  the writer thread hands the queued matrices, in order, to a write callback.
+  When all the slots are pending, a frame is either waited for or dropped.
+ *****************************************************************************/
+
+
+#include <stdbool.h>
+#include <pestacle/ring_writer.h>
+#include <pestacle/math/matrix.h>
+
+
+/*
+ * Write a matrix, the index counting all the pushed frames, dropped or not.
+ * Called from the writer thread, returns false on failure.
+ */
+
+typedef bool (*AsyncWriter__write)(
+	void* caller,
+	const Matrix* matrix,
+	size_t index
+);
+
+
+typedef struct {
+	Matrix matrix;
+	size_t index;
+} AsyncWriterSlot;
+
+
+typedef struct {
+	AsyncWriter__write write;
+	void* caller;
+
+	size_t slot_count;
+	AsyncWriterSlot* slots;
+	size_t push_count;
+
+	RingWriter ring;
+} AsyncWriter;
+
+
+/*
+ * Initialize a writer for row_count x col_count matrices, with slot_count
+ * slots, and start its writer thread.
+ *
+ * Returns false if the writer thread could not be started
+ */
+
+extern bool
+AsyncWriter_init(
+	AsyncWriter* self,
+	size_t row_count,
+	size_t col_count,
+	size_t slot_count,
+	RingWriterPolicy policy,
+	AsyncWriter__write write,
+	void* caller
+);
+
+
+/*
+ * Wait until the queued matrices are written, then stop the writer thread
+ */
+
+extern void
+AsyncWriter_destroy(
+	AsyncWriter* self
+);
+
+
+/*
+ * Queue a copy of a matrix, or drop it if no slot is free and the policy
+ * allows it. Returns false if the matrix was dropped.
+ */
+
+extern bool
+AsyncWriter_push(
+	AsyncWriter* self,
+	const Matrix* matrix
+);
+
+
+/*
+ * Number of matrices queued so far, a running total rather than the current
+ * depth of the queue
+ */
+
+extern size_t
+AsyncWriter_queued_count(
+	AsyncWriter* self
+);
+
+
+extern size_t
+AsyncWriter_written_count(
+	AsyncWriter* self
+);
+
+
+extern size_t
+AsyncWriter_dropped_count(
+	AsyncWriter* self
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PESTACLE_PLUGIN_MATRIX_IO_ASYNC_WRITER_H */
@@ -0,0 +1,20 @@
+#ifndef PESTACLE_PLUGIN_MATRIX_IO_LOAD_H
+#define PESTACLE_PLUGIN_MATRIX_IO_LOAD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include <pestacle/node.h>
+
+
+extern const NodeDelegate
+matrix_io_load_node_delegate;
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PESTACLE_PLUGIN_MATRIX_IO_LOAD_H */
@@ -0,0 +1,56 @@
+#ifndef PESTACLE_PLUGIN_MATRIX_IO_MAPPED_FILE_H
+#define PESTACLE_PLUGIN_MATRIX_IO_MAPPED_FILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+typedef struct {
+	const uint8_t* data;
+	size_t size;
+	void* handle;   // Mapping handle, on platforms requiring one
+} MappedFile;
+
+
+/*
+ * Map a whole file in memory, read only. Returns false if the file could not
+ * be opened or mapped.
+ */
+
+extern bool
+MappedFile_open(
+	MappedFile* self,
+	const char* path
+);
+
+
+extern void
+MappedFile_close(
+	MappedFile* self
+);
+
+
+/*
+ * Hint that the bytes from offset to offset + len will be read soon, and
+ * start reading them from the disk in the background, where supported
+ */
+
+extern void
+MappedFile_prefetch(
+	MappedFile* self,
+	size_t offset,
+	size_t len
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PESTACLE_PLUGIN_MATRIX_IO_MAPPED_FILE_H */
@@ -0,0 +1,88 @@
+#ifndef PESTACLE_PLUGIN_MATRIX_IO_NPY_H
+#define PESTACLE_PLUGIN_MATRIX_IO_NPY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include <float.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pestacle/math/matrix.h>
+
+
+// Defined when a real_t is an IEEE 754 float32, the .npy payload type
+#if (FLT_RADIX == 2) && (FLT_MANT_DIG == 24) && (FLT_MAX_EXP == 128)
+#define NPY_FLOAT32_IS_IEEE
+#endif
+
+// Defined when the coefficients of a matrix are the .npy payload as they are
+#if defined(NPY_FLOAT32_IS_IEEE) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define NPY_FLOAT32_IS_NATIVE
+#endif
+
+
+/*
+ * Size of the smallest header describing an array of little-endian float32
+ * with the given shape, a multiple of 64 bytes
+ */
+
+extern size_t
+npy_header_size(
+	const size_t* shape,
+	size_t dim_count
+);
+
+
+/*
+ * Write a header of exactly size bytes to dst, padded with spaces. Returns
+ * false if size is not a multiple of 64 or is too small for the shape.
+ */
+
+extern bool
+npy_format_header(
+	char* dst,
+	size_t size,
+	const size_t* shape,
+	size_t dim_count
+);
+
+
+/*
+ * Parse the header at the start of the size bytes of data, for an array of
+ * little-endian float32 in C order, with at most max_dim_count dimensions.
+ * Sets the shape, the dimension count and the offset of the array in data.
+ * Returns false if the header is invalid or describes another array type.
+ */
+
+extern bool
+npy_parse_header(
+	const uint8_t* data,
+	size_t size,
+	size_t* shape,
+	size_t max_dim_count,
+	size_t* dim_count,
+	size_t* data_offset
+);
+
+
+/*
+ * Encode count values to dst as little-endian float32 : a copy on the hosts
+ * where NPY_FLOAT32_IS_NATIVE is defined, a byte swap on the other IEEE 754
+ * hosts, and an encoding of each value otherwise
+ */
+
+extern void
+npy_encode_float32(
+	void* dst,
+	const real_t* src,
+	size_t count
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PESTACLE_PLUGIN_MATRIX_IO_NPY_H */
@@ -0,0 +1,89 @@
+#ifndef PESTACLE_PLUGIN_MATRIX_IO_NPY_STREAM_H
+#define PESTACLE_PLUGIN_MATRIX_IO_NPY_STREAM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/******************************************************************************
+  Recording of a sequence of matrices to a single growing .npy file, of shape
+  (frame count, row count, col count). The header is reserved when opening
+  the file, and rewritten with the final frame count when closing it. The
+  frames are encoded into a large aligned buffer, written at once when full,
+  optionally bypassing the page cache.
+ *****************************************************************************/
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pestacle/math/matrix.h>
+
+
+// Header size and alignment of the writes, as required for direct I/O
+#define NPY_STREAM_BLOCK_SIZE 4096
+
+#define NPY_STREAM_BUFFER_SIZE (1024 * NPY_STREAM_BLOCK_SIZE)
+
+
+typedef struct {
+	int fd;
+	char* path;
+	size_t row_count;
+	size_t col_count;
+	size_t frame_count;           // Frames entirely written to the file
+	size_t pending_frame_count;   // Frames entirely in the buffer, not yet written
+	bool is_direct;
+	bool has_failed;
+
+	uint8_t* buffer;    // NPY_STREAM_BUFFER_SIZE bytes
+	size_t buffer_len;
+} NpyStream;
+
+
+/*
+ * Create the file at path, for row_count x col_count matrices. With
+ * direct_io, the writes bypass the page cache where the platform allows it.
+ *
+ * Returns false if the file could not be created
+ */
+
+extern bool
+NpyStream_open(
+	NpyStream* self,
+	const char* path,
+	size_t row_count,
+	size_t col_count,
+	bool direct_io
+);
+
+
+/*
+ * Write the pending frames and the final header, then close the file. After
+ * a write failure, the header only counts the frames written before it.
+ *
+ * Returns false on write failure
+ */
+
+extern bool
+NpyStream_close(
+	NpyStream* self
+);
+
+
+/*
+ * Append a frame. Returns false on write failure.
+ */
+
+extern bool
+NpyStream_write(
+	NpyStream* self,
+	const Matrix* matrix
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PESTACLE_PLUGIN_MATRIX_IO_NPY_STREAM_H */
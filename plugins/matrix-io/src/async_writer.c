@@ -0,0 +1,159 @@
+#include <assert.h>
+#include <pestacle/memory.h>
+
+#include "async_writer.h"
+
+
+// --- Implementation ---------------------------------------------------------
+
+typedef struct {
+	const Matrix* matrix;
+	size_t index;
+} AsyncWriterItem;
+
+
+static void
+AsyncWriter_copy_slot(
+	void* caller,
+	void* slot,
+	const void* item
+) {
+	(void)caller;
+
+	AsyncWriterSlot* dst = (AsyncWriterSlot*)slot;
+	const AsyncWriterItem* src = (const AsyncWriterItem*)item;
+
+	Matrix_copy(&(dst->matrix), src->matrix);
+	dst->index = src->index;
+}
+
+
+static bool
+AsyncWriter_write_slot(
+	void* caller,
+	void* slot
+) {
+	AsyncWriter* self = (AsyncWriter*)caller;
+	const AsyncWriterSlot* src = (const AsyncWriterSlot*)slot;
+
+	return self->write(self->caller, &(src->matrix), src->index);
+}
+
+
+static void
+AsyncWriter_free_slots(
+	AsyncWriter* self
+) {
+	for(size_t i = 0; i < self->slot_count; ++i)
+		Matrix_destroy(&(self->slots[i].matrix));
+
+	free(self->slots);
+}
+
+
+bool
+AsyncWriter_init(
+	AsyncWriter* self,
+	size_t row_count,
+	size_t col_count,
+	size_t slot_count,
+	RingWriterPolicy policy,
+	AsyncWriter__write write,
+	void* caller
+) {
+	assert(self);
+	assert(slot_count > 0);
+	assert(write);
+
+	// Initialize members
+	self->write = write;
+	self->caller = caller;
+	self->slot_count = slot_count;
+	self->push_count = 0;
+
+	// Allocate the slots
+	self->slots = (AsyncWriterSlot*)checked_malloc(slot_count * sizeof(AsyncWriterSlot));
+	for(size_t i = 0; i < slot_count; ++i) {
+		Matrix_init(&(self->slots[i].matrix), row_count, col_count);
+		self->slots[i].index = 0;
+	}
+
+	// Start the writer thread
+	if (!RingWriter_init(
+		&(self->ring),
+		self->slots,
+		slot_count,
+		sizeof(AsyncWriterSlot),
+		policy,
+		AsyncWriter_copy_slot,
+		AsyncWriter_write_slot,
+		self,
+		"pestacle-matrix-io"
+	)) {
+		AsyncWriter_free_slots(self);
+		return false;
+	}
+
+	// Job done
+	return true;
+}
+
+
+void
+AsyncWriter_destroy(
+	AsyncWriter* self
+) {
+	assert(self);
+
+	RingWriter_destroy(&(self->ring));
+	AsyncWriter_free_slots(self);
+
+	#ifdef DEBUG
+	self->slots = 0;
+	#endif
+}
+
+
+bool
+AsyncWriter_push(
+	AsyncWriter* self,
+	const Matrix* matrix
+) {
+	assert(self);
+	assert(matrix);
+
+	AsyncWriterItem item = { matrix, self->push_count };
+	self->push_count += 1;
+
+	return RingWriter_push(&(self->ring), &item);
+}
+
+
+size_t
+AsyncWriter_queued_count(
+	AsyncWriter* self
+) {
+	assert(self);
+
+	return RingWriter_queued_count(&(self->ring));
+}
+
+
+size_t
+AsyncWriter_written_count(
+	AsyncWriter* self
+) {
+	assert(self);
+
+	return RingWriter_written_count(&(self->ring));
+}
+
+
+size_t
+AsyncWriter_dropped_count(
+	AsyncWriter* self
+) {
+	assert(self);
+
+	return RingWriter_dropped_count(&(self->ring));
+}
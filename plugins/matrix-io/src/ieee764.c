@@ -11,17 +11,34 @@ ieee764_float32_encode(
 ) {
 	assert(self);
 
-	int exponent;
-	float mantissa = frexpf(value, &exponent);
+	// Zero has a null exponent, which frexpf does not provide
+	if (value == 0) {
+		self->ieee764.sign = signbit(value) ? 1 : 0;
+		self->ieee764.exponent = 0;
+		self->ieee764.mantissa = 0;
+		return;
+	}
 
-	if (value > 0) {
-		self->ieee764.sign = 0;
-		self->ieee764.mantissa = ((uint32_t)(mantissa * 0x1000000)) & 0x7fffff;
+	// Infinities and NaNs have the highest exponent
+	if (!isfinite(value)) {
+		self->ieee764.sign = signbit(value) ? 1 : 0;
+		self->ieee764.exponent = 0xff;
+		self->ieee764.mantissa = isnan(value) ? 0x400000 : 0;
+		return;
 	}
-	else {
-		self->ieee764.sign = 1;
-		self->ieee764.mantissa = ((uint32_t)(-mantissa * 0x1000000)) & 0x7fffff;
+
+	int exponent;
+	float mantissa = fabsf(frexpf(value, &exponent));
+
+	self->ieee764.sign = (value < 0) ? 1 : 0;
+
+	// Denormals have a null exponent, and no implicit leading bit
+	if (exponent + 126 <= 0) {
+		self->ieee764.exponent = 0;
+		self->ieee764.mantissa = (uint32_t)ldexpf(fabsf(value), 149);
+		return;
 	}
 
 	self->ieee764.exponent = exponent + 126;
+	self->ieee764.mantissa = ((uint32_t)(mantissa * 0x1000000)) & 0x7fffff;
 }
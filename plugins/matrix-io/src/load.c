@@ -0,0 +1,293 @@
+#include <pestacle/memory.h>
+#include <SDL_log.h>
+
+#include "npy.h"
+#include "mapped_file.h"
+#include "load.h"
+
+
+// --- Interface --------------------------------------------------------------
+
+static bool
+node_setup(
+	Node* self
+);
+
+
+static void
+node_destroy(
+	Node* self
+);
+
+
+static void
+node_update(
+	Node* self
+);
+
+
+static NodeOutput
+node_output(
+	const Node* self
+);
+
+
+static const NodeInputDefinition
+node_inputs[] = {
+	NODE_INPUT_DEFINITION_END
+};
+
+
+#define PATH_PARAMETER 0
+#define LOOP_PARAMETER 1
+
+static const ParameterDefinition
+node_parameters[] = {
+	{
+		ParameterType__string,
+		"path",
+		{ .string_value = "" }
+	},
+	{
+		ParameterType__bool,
+		"loop",
+		{ .bool_value = true }
+	},
+	PARAMETER_DEFINITION_END
+};
+
+
+const NodeDelegate
+matrix_io_load_node_delegate = {
+	"load",
+	node_inputs,
+	node_parameters,
+	{
+		node_setup,
+		node_destroy,
+		node_update,
+		node_output
+	},
+	NodeDelegateFlag__none
+};
+
+
+// --- Implementation ---------------------------------------------------------
+
+// Number of frames read ahead of the current one
+#define PREFETCH_FRAME_COUNT 8
+
+
+typedef struct {
+	MappedFile file;
+	size_t frame_count;
+	size_t frame_index;   // Index of the next frame
+	bool loop;
+	Matrix frames;        // All the frames stacked, in the mapped file
+	Matrix frame;         // View on the current frame
+} LoadData;
+
+
+static void
+LoadData_prefetch(
+	LoadData* self,
+	size_t frame_index
+) {
+	if (frame_index >= self->frame_count) {
+		if (!self->loop)
+			return;
+
+		frame_index %= self->frame_count;
+	}
+
+	size_t frame_len = self->frame.row_count * self->frame.col_count * sizeof(real_t);
+	size_t offset = ((const uint8_t*)self->frames.data) - self->file.data;
+
+	MappedFile_prefetch(&(self->file), offset + frame_index * frame_len, frame_len);
+}
+
+
+static bool
+LoadData_init(
+	LoadData* self,
+	const char* path,
+	bool loop
+) {
+	// Frames are used as stored, which requires the host to use their format
+	#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+	SDL_LogError(
+		SDL_LOG_CATEGORY_SYSTEM,
+		"matrix-io.load requires a little-endian host"
+	);
+	return false;
+	#endif
+
+	// Map the file
+	if (!MappedFile_open(&(self->file), path))
+		return false;
+
+	// Read the shape, (row count, col count) or (frame count, row count, col count)
+	size_t shape[3];
+	size_t dim_count;
+	size_t data_offset;
+	if (!npy_parse_header(self->file.data, self->file.size, shape, 3, &dim_count, &data_offset)) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"'%s' is not a .npy file of float32 matrices",
+			path
+		);
+		goto failure;
+	}
+
+	if ((dim_count < 2) || (data_offset % sizeof(real_t) != 0)) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"'%s' is not a .npy file of float32 matrices",
+			path
+		);
+		goto failure;
+	}
+
+	// The shape comes from the file, reject the ones overflowing a size_t
+	size_t row_count = shape[dim_count - 2];
+	size_t col_count = shape[dim_count - 1];
+	if ((row_count == 0) || (col_count == 0) || (col_count > SIZE_MAX / sizeof(real_t) / row_count)) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"'%s' has an invalid shape",
+			path
+		);
+		goto failure;
+	}
+
+	size_t frame_len = row_count * col_count * sizeof(real_t);
+	size_t stored_frame_count = (self->file.size - data_offset) / frame_len;
+
+	self->frame_count = (dim_count == 3) ? shape[0] : 1;
+
+	// A recording which was not closed keeps a frame count of 0
+	if ((dim_count == 3) && (self->frame_count == 0)) {
+		SDL_Log("'%s' was not closed, reading %zu frame(s)", path, stored_frame_count);
+		self->frame_count = stored_frame_count;
+	}
+
+	// As stored_frame_count * frame_len fits in the file, so do the frames
+	if ((self->frame_count == 0) || (self->frame_count > stored_frame_count)) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"'%s' is truncated or holds no frame",
+			path
+		);
+		goto failure;
+	}
+
+	// Setup the frames, stored without padding
+	self->frames.row_count = self->frame_count * row_count;
+	self->frames.col_count = col_count;
+	self->frames.row_stride = col_count;
+	self->frames.data_len = self->frames.row_count * col_count;
+	self->frames.data = (real_t*)(self->file.data + data_offset);
+
+	Matrix_init_view(&(self->frame), &(self->frames), 0, 0, row_count, col_count);
+	self->frame_index = 0;
+	self->loop = loop;
+
+	// Start reading the first frames
+	for(size_t i = 0; i < PREFETCH_FRAME_COUNT; ++i)
+		LoadData_prefetch(self, i);
+
+	// Job done
+	return true;
+
+failure:
+	MappedFile_close(&(self->file));
+	return false;
+}
+
+
+static void
+LoadData_destroy(
+	LoadData* self
+) {
+	MappedFile_close(&(self->file));
+}
+
+
+static void
+LoadData_next_frame(
+	LoadData* self
+) {
+	// Point to the next frame, then read one more frame ahead
+	size_t row_count = self->frame.row_count;
+	Matrix_init_view(&(self->frame), &(self->frames), self->frame_index * row_count, 0, row_count, self->frame.col_count);
+
+	LoadData_prefetch(self, self->frame_index + PREFETCH_FRAME_COUNT);
+
+	// Loop, or stay on the last frame
+	self->frame_index += 1;
+	if (self->frame_index == self->frame_count)
+		self->frame_index = self->loop ? 0 : self->frame_count - 1;
+}
+
+
+static bool
+node_setup(
+	Node* self
+) {
+	const char* path = self->parameters[PATH_PARAMETER].string_value;
+	bool loop = self->parameters[LOOP_PARAMETER].bool_value;
+
+	// Allocate data
+	LoadData* data = (LoadData*)checked_malloc(sizeof(LoadData));
+	if (!data)
+		return false;
+
+	// Initialise data
+	if (!LoadData_init(data, path, loop)) {
+		free(data);
+		return false;
+	}
+
+	// Setup output descriptor
+	DataDescriptor_set_as_matrix(
+		&(self->out_descriptor),
+		data->frame.col_count,
+		data->frame.row_count
+	);
+
+	// Job done
+	self->data = data;
+	return true;
+}
+
+
+static void
+node_destroy(
+	Node* self
+) {
+	LoadData* data = (LoadData*)self->data;
+	if (data) {
+		LoadData_destroy(data);
+		free(data);
+	}
+}
+
+
+static void
+node_update(
+	Node* self
+) {
+	LoadData* data = (LoadData*)self->data;
+	LoadData_next_frame(data);
+}
+
+
+static NodeOutput
+node_output(
+	const Node* self
+) {
+	const LoadData* data = (const LoadData*)self->data;
+
+	NodeOutput ret = { .matrix = &(data->frame) };
+	return ret;
+}
@@ -0,0 +1,207 @@
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <string.h>
+#include <assert.h>
+#include <SDL_log.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "mapped_file.h"
+
+
+// --- Implementation ---------------------------------------------------------
+
+#if defined(_WIN32)
+
+bool
+MappedFile_open(
+	MappedFile* self,
+	const char* path
+) {
+	assert(self);
+	assert(path);
+
+	self->data = 0;
+	self->size = 0;
+	self->handle = 0;
+
+	// Open the file
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0);
+	if (file == INVALID_HANDLE_VALUE) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to open file '%s': error %lu",
+			path,
+			GetLastError()
+		);
+		return false;
+	}
+
+	// Map the file
+	LARGE_INTEGER size;
+	if (GetFileSizeEx(file, &size) && (size.QuadPart > 0)) {
+		self->size = (size_t)size.QuadPart;
+		self->handle = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+		if (self->handle)
+			self->data = (const uint8_t*)MapViewOfFile(self->handle, FILE_MAP_READ, 0, 0, 0);
+	}
+
+	CloseHandle(file);
+
+	if (!self->data) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to map file '%s': error %lu",
+			path,
+			GetLastError()
+		);
+		MappedFile_close(self);
+		return false;
+	}
+
+	// Job done
+	return true;
+}
+
+
+void
+MappedFile_close(
+	MappedFile* self
+) {
+	assert(self);
+
+	if (self->data)
+		UnmapViewOfFile(self->data);
+
+	if (self->handle)
+		CloseHandle((HANDLE)self->handle);
+
+	#ifdef DEBUG
+	self->data = 0;
+	self->handle = 0;
+	#endif
+}
+
+
+void
+MappedFile_prefetch(
+	MappedFile* self,
+	size_t offset,
+	size_t len
+) {
+	assert(self);
+	assert(offset + len <= self->size);
+
+	#if _WIN32_WINNT >= 0x0602
+	WIN32_MEMORY_RANGE_ENTRY range = { (PVOID)(self->data + offset), len };
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+	#else
+	(void)offset;
+	(void)len;
+	#endif
+}
+
+#else
+
+bool
+MappedFile_open(
+	MappedFile* self,
+	const char* path
+) {
+	assert(self);
+	assert(path);
+
+	self->data = 0;
+	self->size = 0;
+	self->handle = 0;
+
+	// Open the file
+	int fd = open(path, O_RDONLY);
+	if (fd == -1) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to open file '%s': %s",
+			path,
+			strerror(errno)
+		);
+		return false;
+	}
+
+	// Map the file, the mapping remains valid once the file is closed
+	struct stat file_stat;
+	if ((fstat(fd, &file_stat) == -1) || (file_stat.st_size == 0)) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to map empty file '%s'",
+			path
+		);
+		close(fd);
+		return false;
+	}
+
+	self->size = (size_t)file_stat.st_size;
+	void* data = mmap(0, self->size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (data == MAP_FAILED) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to map file '%s': %s",
+			path,
+			strerror(errno)
+		);
+		return false;
+	}
+
+	self->data = (const uint8_t*)data;
+
+	// The file is expected to be read from start to end
+	madvise(data, self->size, MADV_SEQUENTIAL);
+
+	// Job done
+	return true;
+}
+
+
+void
+MappedFile_close(
+	MappedFile* self
+) {
+	assert(self);
+
+	if (self->data)
+		munmap((void*)self->data, self->size);
+
+	#ifdef DEBUG
+	self->data = 0;
+	#endif
+}
+
+
+void
+MappedFile_prefetch(
+	MappedFile* self,
+	size_t offset,
+	size_t len
+) {
+	assert(self);
+	assert(offset + len <= self->size);
+
+	// madvise requires an address aligned on a page
+	size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+	size_t start = offset - (offset % page_size);
+
+	madvise((void*)(self->data + start), len + (offset - start), MADV_WILLNEED);
+}
+
+#endif
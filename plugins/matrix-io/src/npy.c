@@ -0,0 +1,269 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pestacle/memory.h>
+
+#include "ieee764.h"
+#include "npy.h"
+
+
+// --- Implementation ---------------------------------------------------------
+
+static const char
+npy_header_signature[] = {
+	'\x93', 'N', 'U', 'M', 'P', 'Y', '\x01', '\x00'
+};
+
+static const char
+npy_byte_order = '<';
+
+static const char*
+npy_dtype = "f4";
+
+static const bool
+npy_fortran_order = false;
+
+
+#define NPY_PREAMBLE_SIZE (sizeof(npy_header_signature) + 2)
+#define NPY_MAX_DICT_SIZE 256
+
+
+#if (!defined(NPY_FLOAT32_IS_NATIVE)) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+static uint32_t
+uint32t_reverse_bytes(
+	uint32_t x
+) {
+  return
+      ((x >> 24) & 0x000000fful) |
+      ((x >>  8) & 0x0000ff00ul) |
+      ((x <<  8) & 0x00ff0000ul) |
+      ((x << 24) & 0xff000000ul);
+}
+#endif
+
+
+// Write the header dictionary to dst, returns its length
+static size_t
+npy_format_dict(
+	char* dst,
+	const size_t* shape,
+	size_t dim_count
+) {
+	assert(dim_count > 0);
+
+	int len = snprintf(
+		dst,
+		NPY_MAX_DICT_SIZE,
+		"{'descr': '%c%s', 'fortran_order': %s, 'shape': (",
+		npy_byte_order,
+		npy_dtype,
+		npy_fortran_order ? "True" : "False"
+	);
+
+	for(size_t i = 0; i < dim_count; ++i)
+		len += snprintf(
+			dst + len,
+			NPY_MAX_DICT_SIZE - len,
+			(i + 1 < dim_count) ? "%zu, " : ((dim_count == 1) ? "%zu,), }" : "%zu), }"),
+			shape[i]
+		);
+
+	assert(len < NPY_MAX_DICT_SIZE);
+
+	return (size_t)len;
+}
+
+
+size_t
+npy_header_size(
+	const size_t* shape,
+	size_t dim_count
+) {
+	assert(shape);
+
+	char dict[NPY_MAX_DICT_SIZE];
+	size_t size = NPY_PREAMBLE_SIZE + npy_format_dict(dict, shape, dim_count) + 1;
+
+	// Pad header size to a multiple of 64
+	if (size % 64 != 0)
+		size += 64 - (size % 64);
+
+	return size;
+}
+
+
+bool
+npy_format_header(
+	char* dst,
+	size_t size,
+	const size_t* shape,
+	size_t dim_count
+) {
+	assert(dst);
+	assert(shape);
+
+	if ((size % 64 != 0) || (size < npy_header_size(shape, dim_count)) || (size - NPY_PREAMBLE_SIZE > 0xffff))
+		return false;
+
+	// Fill the header with ' ' char
+	memset(dst, ' ', size);
+
+	// Copy the signature, then the header size
+	memcpy(dst, npy_header_signature, sizeof(npy_header_signature));
+	dst[sizeof(npy_header_signature) + 0] = (char)((size - NPY_PREAMBLE_SIZE) % 256);
+	dst[sizeof(npy_header_signature) + 1] = (char)((size - NPY_PREAMBLE_SIZE) / 256);
+
+	// Write metadata, without the trailing '0' left by snprintf
+	char dict[NPY_MAX_DICT_SIZE];
+	size_t dict_len = npy_format_dict(dict, shape, dim_count);
+	memcpy(dst + NPY_PREAMBLE_SIZE, dict, dict_len);
+
+	// Final character of the header is a line return
+	dst[size - 1] = '\n';
+
+	// Job done
+	return true;
+}
+
+
+// Returns the value of a key of the header dictionary, 0 if not found
+static const char*
+npy_find_value(
+	const char* dict,
+	const char* key
+) {
+	const char* ret = strstr(dict, key);
+	if (!ret)
+		return 0;
+
+	ret += strlen(key);
+	while(*ret == ' ')
+		++ret;
+
+	if (*ret != ':')
+		return 0;
+
+	for(++ret; *ret == ' '; ++ret);
+
+	return ret;
+}
+
+
+bool
+npy_parse_header(
+	const uint8_t* data,
+	size_t size,
+	size_t* shape,
+	size_t max_dim_count,
+	size_t* dim_count,
+	size_t* data_offset
+) {
+	assert(data);
+	assert(shape);
+	assert(dim_count);
+	assert(data_offset);
+
+	// Check the signature, then read the header size as of the version
+	if ((size < NPY_PREAMBLE_SIZE) || memcmp(data, npy_header_signature, 6))
+		return false;
+
+	size_t preamble_size = NPY_PREAMBLE_SIZE;
+	size_t dict_len = ((size_t)data[8]) | (((size_t)data[9]) << 8);
+	if (data[6] != 1) {
+		preamble_size += 2;
+		if (size < preamble_size)
+			return false;
+
+		dict_len |= (((size_t)data[10]) << 16) | (((size_t)data[11]) << 24);
+	}
+
+	if (size < preamble_size + dict_len)
+		return false;
+
+	*data_offset = preamble_size + dict_len;
+
+	// Copy the dictionary to a null terminated string
+	char* dict = (char*)checked_malloc(dict_len + 1);
+	memcpy(dict, data + preamble_size, dict_len);
+	dict[dict_len] = '\0';
+
+	bool ret = false;
+
+	// Check the array type
+	char descr[8];
+	snprintf(descr, sizeof(descr), "'%c%s'", npy_byte_order, npy_dtype);
+
+	const char* value = npy_find_value(dict, "'descr'");
+	if ((!value) || strncmp(value, descr, strlen(descr)))
+		goto termination;
+
+	value = npy_find_value(dict, "'fortran_order'");
+	if ((!value) || strncmp(value, "False", 5))
+		goto termination;
+
+	// Read the shape
+	value = npy_find_value(dict, "'shape'");
+	if ((!value) || (*value != '('))
+		goto termination;
+
+	*dim_count = 0;
+	for(++value; ; ) {
+		while((*value == ' ') || (*value == ','))
+			++value;
+
+		if (*value == ')')
+			break;
+
+		if ((*value < '0') || (*value > '9') || (*dim_count == max_dim_count))
+			goto termination;
+
+		char* end;
+		shape[*dim_count] = (size_t)strtoull(value, &end, 10);
+		*dim_count += 1;
+		value = end;
+	}
+
+	ret = true;
+
+termination:
+	free(dict);
+	return ret;
+}
+
+
+void
+npy_encode_float32(
+	void* dst,
+	const real_t* src,
+	size_t count
+) {
+	assert(dst);
+	assert(src);
+
+	#if defined(NPY_FLOAT32_IS_NATIVE)
+	memcpy(dst, src, count * sizeof(real_t));
+	#elif defined(NPY_FLOAT32_IS_IEEE) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+	// A loop the compiler vectorizes into byte shuffles
+	uint32_t* dst_ptr = (uint32_t*)dst;
+	for(; count != 0; --count, ++src, ++dst_ptr) {
+		uint32_t value;
+		memcpy(&value, src, sizeof(uint32_t));
+		*dst_ptr = uint32t_reverse_bytes(value);
+	}
+	#else
+	uint32_t* dst_ptr = (uint32_t*)dst;
+	for(; count != 0; --count, ++src, ++dst_ptr) {
+		union ieee764_float32 value;
+		ieee764_float32_encode(&value, *src);
+
+		#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+		*dst_ptr = value.uint32;
+		#elif __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		*dst_ptr = uint32t_reverse_bytes(value.uint32);
+		#else
+			#error Unsupported byte order
+		#endif
+	}
+	#endif
+}
@@ -0,0 +1,257 @@
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+#include <SDL_log.h>
+#include <pestacle/memory.h>
+#include <pestacle/strings.h>
+
+#include "npy.h"
+#include "npy_stream.h"
+
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+
+// --- Implementation ---------------------------------------------------------
+
+// Enable or disable the page cache bypass, returns false if not supported
+static bool
+NpyStream_set_direct(
+	NpyStream* self,
+	bool is_direct
+) {
+	#if defined(O_DIRECT)
+	int flags = fcntl(self->fd, F_GETFL);
+	if (flags == -1)
+		return false;
+
+	flags = is_direct ? (flags | O_DIRECT) : (flags & ~O_DIRECT);
+	if (fcntl(self->fd, F_SETFL, flags) == -1)
+		return false;
+	#elif defined(F_NOCACHE)
+	if (fcntl(self->fd, F_NOCACHE, is_direct ? 1 : 0) == -1)
+		return false;
+	#else
+	if (is_direct)
+		return false;
+	#endif
+
+	self->is_direct = is_direct;
+	return true;
+}
+
+
+static bool
+NpyStream_write_all(
+	NpyStream* self,
+	const uint8_t* data,
+	size_t len
+) {
+	while(len > 0) {
+		ssize_t ret = write(self->fd, data, len);
+
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+
+			// The file system might not support direct I/O
+			if ((errno == EINVAL) && self->is_direct && NpyStream_set_direct(self, false)) {
+				SDL_Log("direct I/O not supported for '%s', writing through the page cache", self->path);
+				continue;
+			}
+
+			SDL_LogError(
+				SDL_LOG_CATEGORY_SYSTEM,
+				"Unable to write to file '%s': %s",
+				self->path,
+				strerror(errno)
+			);
+			return false;
+		}
+
+		data += ret;
+		len -= (size_t)ret;
+	}
+
+	return true;
+}
+
+
+static bool
+NpyStream_flush(
+	NpyStream* self
+) {
+	if (self->buffer_len != 0) {
+		// Direct I/O only writes whole blocks, the last one goes through the cache
+		if (self->is_direct && (self->buffer_len % NPY_STREAM_BLOCK_SIZE != 0))
+			NpyStream_set_direct(self, false);
+
+		bool ret = NpyStream_write_all(self, self->buffer, self->buffer_len);
+		self->buffer_len = 0;
+
+		if (!ret)
+			return false;
+	}
+
+	// The frames which ended in the buffer are now in the file
+	self->frame_count += self->pending_frame_count;
+	self->pending_frame_count = 0;
+
+	return true;
+}
+
+
+bool
+NpyStream_open(
+	NpyStream* self,
+	const char* path,
+	size_t row_count,
+	size_t col_count,
+	bool direct_io
+) {
+	assert(self);
+	assert(path);
+
+	// Initialize members
+	self->path = strclone(path);
+	self->row_count = row_count;
+	self->col_count = col_count;
+	self->frame_count = 0;
+	self->pending_frame_count = 0;
+	self->is_direct = false;
+	self->has_failed = false;
+	self->buffer = (uint8_t*)checked_aligned_malloc(NPY_STREAM_BUFFER_SIZE, NPY_STREAM_BLOCK_SIZE);
+	self->buffer_len = 0;
+
+	// Create the file
+	self->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+	if (self->fd == -1) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to open file '%s': %s",
+			path,
+			strerror(errno)
+		);
+		aligned_free(self->buffer);
+		free(self->path);
+		return false;
+	}
+
+	// Access hints
+	if (direct_io && (!NpyStream_set_direct(self, true)))
+		SDL_Log("direct I/O not supported for '%s', writing through the page cache", path);
+
+	#if defined(POSIX_FADV_SEQUENTIAL)
+	posix_fadvise(self->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+	#endif
+
+	// Reserve the header, one block to keep the frames aligned
+	size_t shape[3] = { 0, row_count, col_count };
+	npy_format_header((char*)self->buffer, NPY_STREAM_BLOCK_SIZE, shape, 3);
+	self->buffer_len = NPY_STREAM_BLOCK_SIZE;
+
+	// Job done
+	return true;
+}
+
+
+bool
+NpyStream_close(
+	NpyStream* self
+) {
+	assert(self);
+
+	// Write the pending frames
+	bool ret = (!self->has_failed) && NpyStream_flush(self);
+
+	// Rewrite the header with the count of the frames in the file
+	size_t shape[3] = { self->frame_count, self->row_count, self->col_count };
+	npy_format_header((char*)self->buffer, NPY_STREAM_BLOCK_SIZE, shape, 3);
+
+	if (lseek(self->fd, 0, SEEK_SET) == -1) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to seek in file '%s': %s",
+			self->path,
+			strerror(errno)
+		);
+		ret = false;
+	}
+	else
+		ret &= NpyStream_write_all(self, self->buffer, NPY_STREAM_BLOCK_SIZE);
+
+	// Close the file
+	if (close(self->fd)) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to close file '%s': %s",
+			self->path,
+			strerror(errno)
+		);
+		ret = false;
+	}
+
+	// Free ressources
+	aligned_free(self->buffer);
+	free(self->path);
+
+	#ifdef DEBUG
+	self->fd = -1;
+	self->buffer = 0;
+	self->path = 0;
+	#endif
+
+	// Job done
+	return ret;
+}
+
+
+bool
+NpyStream_write(
+	NpyStream* self,
+	const Matrix* matrix
+) {
+	assert(self);
+	assert(matrix);
+	assert(matrix->row_count == self->row_count);
+	assert(matrix->col_count == self->col_count);
+
+	// Stop at the first failure, the frames would be misplaced
+	if (self->has_failed)
+		return false;
+
+	// Encode the frame to the buffer, writing the buffer whenever full
+	const size_t buffer_capacity = NPY_STREAM_BUFFER_SIZE / 4;
+
+	const real_t* src_row = matrix->data;
+	for(size_t i = matrix->row_count; i != 0; --i, src_row += matrix->row_stride) {
+		const real_t* src = src_row;
+		for(size_t j = matrix->col_count; j != 0; ) {
+			size_t len = buffer_capacity - self->buffer_len / 4;
+			if (len > j)
+				len = j;
+
+			npy_encode_float32(self->buffer + self->buffer_len, src, len);
+			self->buffer_len += 4 * len;
+			src += len;
+			j -= len;
+
+			if ((self->buffer_len == NPY_STREAM_BUFFER_SIZE) && (!NpyStream_flush(self))) {
+				self->has_failed = true;
+				return false;
+			}
+		}
+	}
+
+	// Job done, the frame is in the file once the buffer is written
+	self->pending_frame_count += 1;
+	return true;
+}
@@ -1,10 +1,21 @@
 #include <errno.h>
+#include <assert.h>
 #include <pestacle/memory.h>
 #include <SDL_log.h>
 
-#include "ieee764.h"
+#include "npy.h"
+#include "npy_stream.h"
+#include "async_writer.h"
 #include "output.h"
 
+// Native payloads are written straight from the matrix, along with the header
+#if defined(NPY_FLOAT32_IS_NATIVE) && (!defined(_WIN32))
+#define WRITE_NPY_WITH_WRITEV
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#endif
+
 
 // --- Interface --------------------------------------------------------------
 
@@ -41,6 +52,10 @@ node_inputs[] = {
 #define PATH_PREFIX_PARAMETER 0
 #define WIDTH_PARAMETER       1
 #define HEIGHT_PARAMETER      2
+#define QUEUE_SIZE_PARAMETER  3
+#define POLICY_PARAMETER      4
+#define MODE_PARAMETER        5
+#define DIRECT_IO_PARAMETER   6
 
 static const ParameterDefinition
 node_parameters[] = {
@@ -59,6 +74,26 @@ node_parameters[] = {
 		"height",
 		{ .int64_value = 240 }
 	},
+	{
+		ParameterType__integer,
+		"queue-size",
+		{ .int64_value = 4 }
+	},
+	{
+		ParameterType__string,
+		"policy",
+		{ .string_value = "block" }
+	},
+	{
+		ParameterType__string,
+		"mode",
+		{ .string_value = "files" }
+	},
+	{
+		ParameterType__bool,
+		"direct-io",
+		{ .bool_value = false }
+	},
 	PARAMETER_DEFINITION_END
 };
 
@@ -74,35 +109,48 @@ matrix_io_output_node_delegate = {
 		node_update,
 		0
 	},
+	NodeDelegateFlag__none
 };
 
 
 // --- Implementation ---------------------------------------------------------
 
-static const char
-npy_header_signature[] = {
-	'\x93', 'N', 'U', 'M', 'P', 'Y', '\x01', '\x00'
-};
+#if defined(WRITE_NPY_WITH_WRITEV)
+
+#define WRITEV_MAX_IOV_COUNT 64
+
 
-static const char
-npy_byte_order = '<';
+// Write a set of buffers, resuming after partial writes
+static bool
+writev_all(
+	int fd,
+	struct iovec* iov,
+	int iov_count
+) {
+	while(iov_count > 0) {
+		ssize_t ret = writev(fd, iov, iov_count);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
 
-static const char*
-npy_dtype = "f4";
+			return false;
+		}
 
-static const bool
-npy_fortran_order = false;
+		// Skip what was written
+		size_t len = (size_t)ret;
+		while((iov_count > 0) && (len >= iov->iov_len)) {
+			len -= iov->iov_len;
+			++iov;
+			--iov_count;
+		}
 
+		if (iov_count > 0) {
+			iov->iov_base = ((uint8_t*)iov->iov_base) + len;
+			iov->iov_len -= len;
+		}
+	}
 
-uint32_t
-uint32t_reverse_bytes(
-	uint32_t x
-) { 
-  return 
-      ((x >> 24) & 0x000000fful) | 
-      ((x >>  8) & 0x0000ff00ul) | 
-      ((x <<  8) & 0x00ff0000ul) | 
-      ((x << 24) & 0xff000000ul); 
+	return true;
 }
 
 
@@ -111,53 +159,99 @@ write_npy(
 	const char* path,
 	const Matrix* matrix
 ) {
-	#define WRITE_BUFFER_SIZE 4096 // Must be a multiple of 4
+	// Generate file header
+	char header[256];
+	size_t shape[2] = { matrix->row_count, matrix->col_count };
+	size_t header_size = npy_header_size(shape, 2);
+	assert(header_size <= sizeof(header));
+	npy_format_header(header, header_size, shape, 2);
 
-	// Allocate write buffer
-	char* write_buffer = checked_malloc(WRITE_BUFFER_SIZE);
+	// Open the file
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd == -1) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to open file '%s': %s",
+			path,
+			strerror(errno)
+		);
+		return false;
+	}
 
-	/*
-	 * Generate file header
-	 */
-	
-	// Fill the write_buffer with ' ' char
-	memset(write_buffer, ' ', WRITE_BUFFER_SIZE);
-
-	// Copy the signature to write_buffer
-	memcpy(write_buffer, npy_header_signature, sizeof(npy_header_signature));
-	size_t header_size = sizeof(npy_header_signature) + 2;
-
-	// Write metadata
-	int metadata_size = snprintf(
-		write_buffer + header_size,
-		WRITE_BUFFER_SIZE - header_size,
-		"{'descr': '%c%s', 'fortran_order': %s, 'shape': (%zu, %zu), }",
-		npy_byte_order,
-		npy_dtype,
-		npy_fortran_order ? "True" : "False",
-		matrix->row_count,
-		matrix->col_count
-	);
+	// Write the header and the rows, at once if the rows are packed
+	struct iovec iov[WRITEV_MAX_IOV_COUNT];
+	iov[0].iov_base = header;
+	iov[0].iov_len = header_size;
+	int iov_count = 1;
+
+	bool ret = true;
+	if (matrix->row_stride == matrix->col_count) {
+		iov[1].iov_base = matrix->data;
+		iov[1].iov_len = matrix->row_count * matrix->col_count * sizeof(real_t);
+		iov_count = 2;
+	}
+	else {
+		const real_t* row = matrix->data;
+		for(size_t i = matrix->row_count; (i != 0) && ret; --i, row += matrix->row_stride) {
+			iov[iov_count].iov_base = (void*)row;
+			iov[iov_count].iov_len = matrix->col_count * sizeof(real_t);
+			iov_count += 1;
+
+			if (iov_count == WRITEV_MAX_IOV_COUNT) {
+				ret = writev_all(fd, iov, iov_count);
+				iov_count = 0;
+			}
+		}
+	}
 
-	header_size += metadata_size;
+	if (ret)
+		ret = writev_all(fd, iov, iov_count);
 
-	// Replace the trailing '0' left by snprintf
-	write_buffer[header_size] = ' ';
+	if (!ret)
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to write to file '%s': %s",
+			path,
+			strerror(errno)
+		);
+
+	// Close the file
+	if (close(fd)) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to close file '%s': %s",
+			path,
+			strerror(errno)
+		);
+		ret = false;
+	}
+
+	// Job done
+	return ret;
+}
 
-	// Pad header size to a multiple of 64
-	size_t padded_header_size = header_size;
-	if (header_size % 64 != 0)
-		padded_header_size += 64 - (header_size % 64);
+#else
 
-	// Final character of the header is a line return
-	write_buffer[padded_header_size - 1] = '\n';
+static bool
+write_npy(
+	const char* path,
+	const Matrix* matrix
+) {
+	#define WRITE_BUFFER_SIZE 4096 // Must be a multiple of 64
+
+	bool ret = false;
+	FILE* fp = 0;
+
+	// Allocate write buffer
+	char* write_buffer = checked_malloc(WRITE_BUFFER_SIZE);
+
+	// Generate file header
+	size_t shape[2] = { matrix->row_count, matrix->col_count };
+	size_t header_size = npy_header_size(shape, 2);
+	npy_format_header(write_buffer, header_size, shape, 2);
 
-	// Write the header size
-	write_buffer[sizeof(npy_header_signature) + 0] = (padded_header_size - (sizeof(npy_header_signature) + 2)) % 256;
-	write_buffer[sizeof(npy_header_signature) + 1] = (padded_header_size - (sizeof(npy_header_signature) + 2)) / 256;
-	
 	// Open the file
-	FILE* fp = fopen(path, "wb");
+	fp = fopen(path, "wb");
 	if (!fp) {
 		SDL_LogError(
 			SDL_LOG_CATEGORY_SYSTEM,
@@ -169,7 +263,7 @@ write_npy(
 	}
 
 	// Write the file header
-	if (!fwrite(write_buffer, padded_header_size, 1, fp)) {
+	if (!fwrite(write_buffer, header_size, 1, fp)) {
 		SDL_LogError(
 			SDL_LOG_CATEGORY_SYSTEM,
 			"Unable to write to file '%s': %s",
@@ -180,108 +274,92 @@ write_npy(
 	}
 
 	// Write the file content, through a buffer
-	const real_t* src = matrix->data;
-	
-	uint32_t* dst = (uint32_t*)write_buffer;
-	size_t buffer_pos = 0;
-
-	for(size_t i = 0; i < matrix->row_count; ++i)
-		for(size_t j = 0; j < matrix->col_count; ++j, ++src) {
-			union ieee764_float32 value;
-			ieee764_float32_encode(&value, *src);
-
-			#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
-			*dst = value.uint32;
-			#elif __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
-			*dst = uint32t_reverse_bytes(value.uint32);
-			#else
-				#error Unsupported byte order
-			#endif
-
-			buffer_pos += 4;
-			dst += 1;
-
-			if (buffer_pos == WRITE_BUFFER_SIZE) {
-				if (!fwrite(write_buffer, WRITE_BUFFER_SIZE, 1, fp)) {
-					SDL_LogError(
-						SDL_LOG_CATEGORY_SYSTEM,
-						"Unable to write to file '%s': %s",
-						path,
-						strerror(errno)
-					);
-					goto termination;
-				}
-				
-				dst = (uint32_t*)write_buffer;
-				buffer_pos = 0;
+	size_t buffer_len = WRITE_BUFFER_SIZE / 4;
+
+	for(size_t i = 0; i < matrix->row_count; ++i) {
+		const real_t* src = matrix->data + i * matrix->row_stride;
+		for(size_t j = 0; j < matrix->col_count; j += buffer_len) {
+			size_t len = matrix->col_count - j;
+			if (len > buffer_len)
+				len = buffer_len;
+
+			npy_encode_float32(write_buffer, src + j, len);
+
+			if (!fwrite(write_buffer, 4 * len, 1, fp)) {
+				SDL_LogError(
+					SDL_LOG_CATEGORY_SYSTEM,
+					"Unable to write to file '%s': %s",
+					path,
+					strerror(errno)
+				);
+				goto termination;
 			}
 		}
-
-	if (buffer_pos > 0) {
-		if (!fwrite(write_buffer, buffer_pos, 1, fp)) {
-			SDL_LogError(
-				SDL_LOG_CATEGORY_SYSTEM,
-				"Unable to write to file '%s': %s",
-				path,
-				strerror(errno)
-			);
-			goto termination;
-		}
 	}
 
-	// Close the file
-	fclose(fp);
+	ret = true;
 
 termination:
+	// Close the file
+	if (fp && fclose(fp)) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Unable to close file '%s': %s",
+			path,
+			strerror(errno)
+		);
+		ret = false;
+	}
+
 	// Deallocate write_buffer
 	if (write_buffer)
 		free(write_buffer);
 
 	// Job done
-	return true;
+	return ret;
 }
 
+#endif
+
 
 #define MAX_PATH_LEN 1024
 
+typedef enum {
+	OutputMode__files,    // One .npy file per frame
+	OutputMode__stream    // All the frames in a single .npy file
+} OutputMode;
+
+
 typedef struct {
 	size_t dims[2];
 	const char* path_prefix;
-	char path[MAX_PATH_LEN];
-	size_t counter;
+	char path[MAX_PATH_LEN];   // Used by the writer thread only
+	OutputMode mode;
+	NpyStream stream;
+	AsyncWriter writer;
 } OutputData;
 
 
-static bool
-OutputData_init(
-	OutputData* self,
-	size_t col_count,
-	size_t row_count,
-	const char* path_prefix
-) {
-	self->dims[0] = row_count;
-	self->dims[1] = col_count;
-	self->path_prefix = path_prefix;
-	self->counter = 0;
-
-	return true;
-}
-
-
 static bool
 OutputData_write(
-	OutputData* self,
-	const Matrix* matrix
+	void* caller,
+	const Matrix* matrix,
+	size_t index
 ) {
+	OutputData* self = (OutputData*)caller;
 	bool exit_code = true;
 
+	// Append to the stream
+	if (self->mode == OutputMode__stream)
+		return NpyStream_write(&(self->stream), matrix);
+
 	// Creates the path
 	int ret = snprintf(
 		self->path,
 		MAX_PATH_LEN,
 		"%s%06zu.npy",
 		self->path_prefix,
-		self->counter
+		index
 	);
 
 	if (ret < 0) {
@@ -302,16 +380,84 @@ OutputData_write(
 		goto termination;
 	}
 
-	// Writeh file file
-	write_npy(self->path, matrix);
+	// Write the file
+	exit_code = write_npy(self->path, matrix);
 
 termination:
 	// Job done
-	self->counter += 1;
 	return exit_code;
 }
 
 
+static bool
+OutputData_init(
+	OutputData* self,
+	size_t col_count,
+	size_t row_count,
+	const char* path_prefix,
+	size_t queue_size,
+	RingWriterPolicy policy,
+	OutputMode mode,
+	bool direct_io
+) {
+	self->dims[0] = row_count;
+	self->dims[1] = col_count;
+	self->path_prefix = path_prefix;
+	self->mode = mode;
+
+	// Create the stream file
+	if (mode == OutputMode__stream) {
+		int ret = snprintf(
+			self->path,
+			MAX_PATH_LEN,
+			"%sframes.npy",
+			path_prefix
+		);
+
+		if ((ret < 0) || (ret >= MAX_PATH_LEN)) {
+			SDL_LogError(
+				SDL_LOG_CATEGORY_SYSTEM,
+				"file path is too long\n"
+			);
+			return false;
+		}
+
+		if (!NpyStream_open(&(self->stream), self->path, row_count, col_count, direct_io))
+			return false;
+	}
+
+	// Start the writer thread
+	if (!AsyncWriter_init(&(self->writer), row_count, col_count, queue_size, policy, OutputData_write, self)) {
+		if (mode == OutputMode__stream)
+			NpyStream_close(&(self->stream));
+		return false;
+	}
+
+	// Job done
+	return true;
+}
+
+
+static void
+OutputData_destroy(
+	OutputData* self
+) {
+	// Write the queued frames
+	AsyncWriter_destroy(&(self->writer));
+
+	if (self->mode == OutputMode__stream)
+		NpyStream_close(&(self->stream));
+
+	SDL_Log(
+		"%s : %zu frame(s) queued, %zu written, %zu dropped",
+		self->path_prefix,
+		AsyncWriter_queued_count(&(self->writer)),
+		AsyncWriter_written_count(&(self->writer)),
+		AsyncWriter_dropped_count(&(self->writer))
+	);
+}
+
+
 static bool
 node_setup(
 	Node* self
@@ -320,6 +466,49 @@ node_setup(
 	const char* path_prefix = self->parameters[PATH_PREFIX_PARAMETER].string_value;
 	size_t width = (size_t)self->parameters[WIDTH_PARAMETER].int64_value;
 	size_t height = (size_t)self->parameters[HEIGHT_PARAMETER].int64_value;
+	int64_t queue_size = self->parameters[QUEUE_SIZE_PARAMETER].int64_value;
+	const char* policy_str = self->parameters[POLICY_PARAMETER].string_value;
+	const char* mode_str = self->parameters[MODE_PARAMETER].string_value;
+	bool direct_io = self->parameters[DIRECT_IO_PARAMETER].bool_value;
+
+	// Check parameters validity
+	if (queue_size < 1) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"invalid queue-size parameter"
+		);
+		return false;
+	}
+
+	RingWriterPolicy policy = RingWriterPolicy__block;
+	if (strcmp(policy_str, "block") == 0) {
+		policy = RingWriterPolicy__block;
+	}
+	else if (strcmp(policy_str, "drop") == 0) {
+		policy = RingWriterPolicy__drop;
+	}
+	else {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"invalid policy parameter"
+		);
+		return false;
+	}
+
+	OutputMode mode = OutputMode__files;
+	if (strcmp(mode_str, "files") == 0) {
+		mode = OutputMode__files;
+	}
+	else if (strcmp(mode_str, "stream") == 0) {
+		mode = OutputMode__stream;
+	}
+	else {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"invalid mode parameter"
+		);
+		return false;
+	}
 
 	// Setup input data descriptor
 	DataDescriptor_set_as_matrix(
@@ -332,7 +521,7 @@ node_setup(
 		return false;
 
 	// Initialise data
-	if (!OutputData_init(data, width, height, path_prefix)) {
+	if (!OutputData_init(data, width, height, path_prefix, (size_t)queue_size, policy, mode, direct_io)) {
 		free(data);
 		return false;
 	}
@@ -348,8 +537,10 @@ node_destroy(
 	Node* self
 ) {
 	OutputData* data = (OutputData*)self->data;
-	if (data)
+	if (data) {
+		OutputData_destroy(data);
 		free(data);
+	}
 }
 
 
@@ -358,8 +549,8 @@ node_update(
 	Node* self
 ) {
 	OutputData* data = (OutputData*)self->data;
-	OutputData_write(
-		data,
+	AsyncWriter_push(
+		&(data->writer),
 		Node_output(self->inputs[SOURCE_INPUT]).matrix
 	);
 }
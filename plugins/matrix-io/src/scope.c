@@ -1,5 +1,6 @@
 #include "scope.h"
 #include "output.h"
+#include "load.h"
 
 
 // --- Interface --------------------------------------------------------------
@@ -13,6 +14,7 @@ scope_setup(
 static const NodeDelegate*
 node_delegate_list[] = {
 	&matrix_io_output_node_delegate,
+	&matrix_io_load_node_delegate,
 	0
 }; // node_delegate_list
 
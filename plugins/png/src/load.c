@@ -54,6 +54,7 @@ png_load_node_delegate = {
 		0,
 		node_output
 	},
+	NodeDelegateFlag__none
 };
 
 
@@ -2,10 +2,14 @@
 
 #include <pestacle/macros.h>
 #include <pestacle/math/average.h>
+#include <pestacle/math/histogram.h>
 #include <pestacle/math/kahan_sum.h>
 #include <pestacle/math/vector.h>
 #include <pestacle/math/matrix.h>
+#include <pestacle/math/array_ops_backend.h>
+#include <pestacle/math/fast_math.h>
 #include <pestacle/math/special.h>
+#include <pestacle/image/gaussian.h>
 
 
 // --- Special functions tests ------------------------------------------------
@@ -53,6 +57,39 @@ MU_TEST(test_weighted_average) {
 }
 
 
+MU_TEST(test_histogram) {
+	Histogram hist;
+	Histogram_init(&hist);
+
+	mu_assert_double_eq(0, Histogram_percentile(&hist, (real_t).5));
+
+	// 1 to 1000 microseconds
+	for(size_t i = 1; i <= 1000; ++i)
+		Histogram_accumulate(&hist, ((real_t)i) * (real_t)1e-6);
+
+	mu_check(Histogram_count(&hist) == 1000);
+	mu_check(fabs(Histogram_max(&hist) - 1e-3) < 1e-9);
+
+	// Percentiles known within 1 / 32 of their value, never above the max
+	const real_t p_values[] = { .01, .5, .9, .99, .999, 1 };
+	for(size_t i = 0; i < sizeof(p_values) / sizeof(real_t); ++i) {
+		real_t expected = p_values[i] * (real_t)1e-3;
+		real_t ret = Histogram_percentile(&hist, p_values[i]);
+		mu_check(ret >= expected * (1 - 1e-6));
+		mu_check(ret <= expected * (1 + 1. / 32));
+		mu_check(ret <= Histogram_max(&hist));
+	}
+
+	size_t count = Histogram_count_above(&hist, (real_t)500e-6);
+	mu_check((count <= 500) && (count >= 500 - 500 / 32));
+
+	// Out of range durations land in the last bucket
+	Histogram_accumulate(&hist, (real_t)1e6);
+	mu_check(Histogram_count_above(&hist, (real_t)1) == 1);
+	mu_check(Histogram_percentile(&hist, (real_t)1) >= HISTOGRAM_MAX_DURATION * (1 - 1. / 32));
+}
+
+
 // --- Kahan sum test ---------------------------------------------------------
 
 MU_TEST(test_kahan_sum) {
@@ -884,6 +921,337 @@ MU_TEST(test_Matrix_exp) {
 }
 
 
+MU_TEST(test_Matrix_colwise_convolution) {
+	Matrix U, V, W;
+	Vector K;
+	ThreadPool pool;
+
+	mu_check(ThreadPool_init(&pool, 2));
+
+	for(size_t i = 16; i < 64; i += 23) {
+		for(size_t j = 1; j < 400; j += 131) {
+			Matrix_init(&U, i, j);
+			Matrix_filler(&U);
+
+			Matrix_init(&V, i, j);
+			Matrix_init(&W, i, j);
+
+			for(size_t k = 1; k < 8; k += 3) {
+				Vector_init(&K, 2 * k + 1);
+				Vector_set_gaussian_kernel(&K, (real_t)k / 2);
+
+				// Blocks of columns give the same results as one column at a time
+				Matrix_parallel_colwise_convolution__zero(&V, &U, &K, &pool);
+				for(size_t n = 0; n < j; ++n)
+					array_ops_strided_convolution__zero(W.data + n, U.data + n, K.data, i, K.len, j, j);
+
+				for(size_t n = 0; n < V.data_len; ++n)
+					mu_assert_double_eq(W.data[n], V.data[n]);
+
+				Matrix_parallel_colwise_convolution__mirror(&V, &U, &K, &pool);
+				for(size_t n = 0; n < j; ++n)
+					array_ops_strided_convolution__mirror(W.data + n, U.data + n, K.data, i, K.len, j, j);
+
+				for(size_t n = 0; n < V.data_len; ++n)
+					mu_assert_double_eq(W.data[n], V.data[n]);
+
+				Vector_destroy(&K);
+			}
+
+			Matrix_destroy(&W);
+			Matrix_destroy(&V);
+			Matrix_destroy(&U);
+		}
+	}
+
+	ThreadPool_destroy(&pool);
+}
+
+
+MU_TEST(test_Matrix_colwise_box_filter) {
+	Matrix U, V, W, S, T;
+	ThreadPool pool;
+
+	mu_check(ThreadPool_init(&pool, 2));
+
+	for(size_t i = 16; i < 64; i += 23) {
+		for(size_t j = 1; j < 400; j += 131) {
+			Matrix_init(&U, i, j);
+			Matrix_filler(&U);
+
+			Matrix_init(&V, i, j);
+			Matrix_init(&W, i, j);
+			Matrix_init(&S, j, i);
+			Matrix_init(&T, j, i);
+
+			for(size_t k = 1; k < 16; k += 6) {
+				// Same results as a row-wise box filter on the transpose
+				Matrix_parallel_colwise_box_filter(&V, &U, k, &pool);
+
+				Matrix_transpose(&T, &U);
+				Matrix_rowwise_box_filter(&S, &T, k);
+				Matrix_transpose(&W, &S);
+
+				for(size_t n = 0; n < V.data_len; ++n)
+					mu_assert_double_eq(W.data[n], V.data[n]);
+			}
+
+			Matrix_destroy(&T);
+			Matrix_destroy(&S);
+			Matrix_destroy(&W);
+			Matrix_destroy(&V);
+			Matrix_destroy(&U);
+		}
+	}
+
+	ThreadPool_destroy(&pool);
+}
+
+
+MU_TEST(test_Matrix_iterated_box_filter) {
+	Matrix U, V, W, T;
+	ThreadPool pool;
+
+	mu_check(ThreadPool_init(&pool, 2));
+
+	for(size_t i = 16; i < 64; i += 23) {
+		for(size_t j = 16; j < 400; j += 131) {
+			Matrix_init(&U, i, j);
+			Matrix_filler(&U);
+
+			Matrix_init(&V, i, j);
+			Matrix_init(&W, i, j);
+			Matrix_init(&T, i, j);
+
+			for(size_t k = 1; k < 16; k += 6) {
+				const size_t filter_sizes[3] = { k, k + 2, k + 2 };
+
+				// Same results as the successive box filters, up to the rounding
+				Matrix_parallel_rowwise_iterated_box_filter(&V, &U, filter_sizes, 3, &pool);
+
+				Matrix_rowwise_box_filter(&W, &U, filter_sizes[0]);
+				Matrix_rowwise_box_filter(&T, &W, filter_sizes[1]);
+				Matrix_rowwise_box_filter(&W, &T, filter_sizes[2]);
+
+				for(size_t n = 0; n < V.data_len; ++n)
+					mu_check(fabs(W.data[n] - V.data[n]) <= 1e-5 * (1 + fabs(W.data[n])));
+
+				Matrix_parallel_colwise_iterated_box_filter(&V, &U, filter_sizes, 3, &pool);
+
+				Matrix_colwise_box_filter(&W, &U, filter_sizes[0]);
+				Matrix_colwise_box_filter(&T, &W, filter_sizes[1]);
+				Matrix_colwise_box_filter(&W, &T, filter_sizes[2]);
+
+				for(size_t n = 0; n < V.data_len; ++n)
+					mu_check(fabs(W.data[n] - V.data[n]) <= 1e-5 * (1 + fabs(W.data[n])));
+			}
+
+			Matrix_destroy(&T);
+			Matrix_destroy(&W);
+			Matrix_destroy(&V);
+			Matrix_destroy(&U);
+		}
+	}
+
+	ThreadPool_destroy(&pool);
+}
+
+
+#define TEST_MATRIX_SUBMITTER_COUNT 3
+
+
+typedef struct {
+	ThreadPool* pool;
+	Matrix U;
+	Matrix V;      // Filtered through the pool
+	Matrix W;      // Filtered without the pool
+	bool is_equal;
+} TestMatrixSubmitter;
+
+
+static int
+test_Matrix_submitter_main(
+	void* data
+) {
+	TestMatrixSubmitter* self = (TestMatrixSubmitter*)data;
+	const size_t filter_sizes[3] = { 5, 7, 7 };
+
+	self->is_equal = true;
+	for(int i = 0; i < 64; ++i) {
+		Matrix_parallel_rowwise_iterated_box_filter(&(self->V), &(self->U), filter_sizes, 3, self->pool);
+		Matrix_rowwise_iterated_box_filter(&(self->W), &(self->U), filter_sizes, 3);
+
+		for(size_t n = 0; n < self->V.data_len; ++n)
+			self->is_equal &= self->V.data[n] == self->W.data[n];
+
+		Matrix_parallel_colwise_iterated_box_filter(&(self->V), &(self->U), filter_sizes, 3, self->pool);
+		Matrix_colwise_iterated_box_filter(&(self->W), &(self->U), filter_sizes, 3);
+
+		for(size_t n = 0; n < self->V.data_len; ++n)
+			self->is_equal &= self->V.data[n] == self->W.data[n];
+	}
+
+	return 0;
+}
+
+
+MU_TEST(test_Matrix_iterated_box_filter_submitters) {
+	ThreadPool pool;
+	mu_check(ThreadPool_init(&pool, 2));
+
+	// Threads outside of the pool run each other's tasks while waiting for
+	// their own jobs, each with its own scratch
+	TestMatrixSubmitter submitters[TEST_MATRIX_SUBMITTER_COUNT];
+	SDL_Thread* threads[TEST_MATRIX_SUBMITTER_COUNT];
+
+	for(size_t i = 0; i < TEST_MATRIX_SUBMITTER_COUNT; ++i) {
+		TestMatrixSubmitter* submitter = submitters + i;
+		submitter->pool = &pool;
+
+		Matrix_init(&(submitter->U), 64 + 16 * i, 300);
+		Matrix_filler(&(submitter->U));
+		Matrix_init(&(submitter->V), 64 + 16 * i, 300);
+		Matrix_init(&(submitter->W), 64 + 16 * i, 300);
+	}
+
+	for(size_t i = 0; i < TEST_MATRIX_SUBMITTER_COUNT; ++i)
+		threads[i] = SDL_CreateThread(test_Matrix_submitter_main, "test-submitter", submitters + i);
+
+	for(size_t i = 0; i < TEST_MATRIX_SUBMITTER_COUNT; ++i) {
+		mu_check(threads[i] != 0);
+		SDL_WaitThread(threads[i], 0);
+		mu_check(submitters[i].is_equal);
+
+		Matrix_destroy(&(submitters[i].W));
+		Matrix_destroy(&(submitters[i].V));
+		Matrix_destroy(&(submitters[i].U));
+	}
+
+	ThreadPool_destroy(&pool);
+}
+
+
+MU_TEST(test_Matrix_padded) {
+	Matrix U, V, P, Q, W;
+	Vector K;
+
+	Vector_init(&K, 5);
+	Vector_set_gaussian_kernel(&K, (real_t)1);
+
+	const size_t filter_sizes[3] = { 3, 5, 5 };
+
+	for(size_t i = 8; i < 64; i += 13) {
+		for(size_t j = 8; j < 100; j += 17) {
+			Matrix_init(&U, i, j);
+			Matrix_init(&V, i, j);
+			Matrix_init_padded(&P, i, j);
+			Matrix_init_padded(&Q, i, j);
+
+			// Rows aligned, padded unless already a multiple of the alignment
+			mu_check(Matrix_is_contiguous(&U));
+			mu_check(Matrix_is_contiguous(&P) == (j % (ARRAY_OPS_ALIGNMENT / sizeof(real_t)) == 0));
+			for(size_t n = 0; n < i; ++n)
+				mu_check(((size_t)(P.data + n * P.row_stride)) % ARRAY_OPS_ALIGNMENT == 0);
+
+			for(size_t n = 0; n < i; ++n)
+				for(size_t m = 0; m < j; ++m)
+					Matrix_set_coeff(&U, n, m, (real_t)sin(n + .37 * m) + (real_t)1.5);
+
+			// Element-wise operations and reductions
+			Matrix_fill(&P, (real_t)-1);
+			Matrix_copy(&P, &U);
+			Matrix_copy(&V, &U);
+			Matrix_copy(&Q, &U);
+
+			Matrix_scaled_add(&P, &Q, (real_t).5);
+			Matrix_scaled_add(&V, &U, (real_t).5);
+			Matrix_sqrt(&P);
+			Matrix_sqrt(&V);
+
+			for(size_t n = 0; n < i; ++n)
+				for(size_t m = 0; m < j; ++m)
+					mu_assert_double_eq(Matrix_get_coeff(&V, n, m), Matrix_get_coeff(&P, n, m));
+
+			real_t std_a, std_b;
+			mu_assert_double_eq(Matrix_reduction_min(&V), Matrix_reduction_min(&P));
+			mu_assert_double_eq(Matrix_reduction_max(&V), Matrix_reduction_max(&P));
+			mu_check(fabs(Matrix_reduction_sum(&V) - Matrix_reduction_sum(&P)) < 1e-6 * V.data_len);
+			mu_check(fabs(Matrix_reduction_logsumexp(&V) - Matrix_reduction_logsumexp(&P)) < 1e-5);
+			mu_check(fabs(Matrix_reduction_mean(&V, &std_a) - Matrix_reduction_mean(&P, &std_b)) < 1e-5);
+			mu_check(fabs(std_a - std_b) < 1e-5);
+			mu_check(fabs(Matrix_reduction_average(&V, &U, &std_a) - Matrix_reduction_average(&P, &Q, &std_b)) < 1e-5);
+			mu_check(fabs(std_a - std_b) < 1e-5);
+
+			// Filters, between padded and packed matrices
+			Matrix_rowwise_convolution__mirror(&P, &U, &K);
+			Matrix_rowwise_convolution__mirror(&V, &U, &K);
+			Matrix_colwise_convolution__zero(&Q, &P, &K);
+			Matrix_colwise_convolution__zero(&U, &V, &K);
+			Matrix_colwise_iterated_box_filter(&P, &Q, filter_sizes, 3);
+			Matrix_colwise_iterated_box_filter(&V, &U, filter_sizes, 3);
+			Matrix_rowwise_iterated_box_filter(&Q, &P, filter_sizes, 3);
+			Matrix_rowwise_iterated_box_filter(&U, &V, filter_sizes, 3);
+
+			for(size_t n = 0; n < i; ++n)
+				for(size_t m = 0; m < j; ++m)
+					mu_assert_double_eq(Matrix_get_coeff(&U, n, m), Matrix_get_coeff(&Q, n, m));
+
+			Matrix_init_padded(&W, j, i);
+			Matrix_transpose(&W, &Q);
+			for(size_t n = 0; n < i; ++n)
+				for(size_t m = 0; m < j; ++m)
+					mu_assert_double_eq(Matrix_get_coeff(&U, n, m), Matrix_get_coeff(&W, m, n));
+
+			Matrix_destroy(&W);
+			Matrix_destroy(&Q);
+			Matrix_destroy(&P);
+			Matrix_destroy(&V);
+			Matrix_destroy(&U);
+		}
+	}
+
+	Vector_destroy(&K);
+}
+
+
+MU_TEST(test_Matrix_view) {
+	Matrix U, V, W;
+
+	Matrix_init(&U, 40, 50);
+	for(size_t n = 0; n < U.row_count; ++n)
+		for(size_t m = 0; m < U.col_count; ++m)
+			Matrix_set_coeff(&U, n, m, (real_t)(n * U.col_count + m));
+
+	for(size_t i = 1; i < 30; i += 7) {
+		for(size_t j = 1; j < 40; j += 9) {
+			Matrix_init_view(&V, &U, 7, 3, i, j);
+			Matrix_init(&W, i, j);
+
+			// The view shares the storage of the matrix
+			mu_check(V.row_stride == U.row_stride);
+			mu_check(V.data_len == i * j);
+			for(size_t n = 0; n < i; ++n)
+				for(size_t m = 0; m < j; ++m)
+					mu_check(&(V.data[n * V.row_stride + m]) == &(U.data[(n + 7) * U.row_stride + m + 3]));
+
+			// It is read as any other matrix
+			Matrix_copy(&W, &V);
+			for(size_t n = 0; n < i; ++n)
+				for(size_t m = 0; m < j; ++m)
+					mu_assert_double_eq(Matrix_get_coeff(&U, n + 7, m + 3), Matrix_get_coeff(&W, n, m));
+
+			mu_assert_double_eq(Matrix_get_coeff(&U, 7, 3), Matrix_reduction_min(&V));
+			mu_assert_double_eq(Matrix_get_coeff(&U, i + 6, j + 2), Matrix_reduction_max(&V));
+			mu_assert_double_eq(Matrix_reduction_sum(&W), Matrix_reduction_sum(&V));
+
+			Matrix_destroy(&W);
+		}
+	}
+
+	Matrix_destroy(&U);
+}
+
+
 MU_TEST(test_Matrix_reduction_min) {
 	Matrix U;
 
@@ -1075,8 +1443,358 @@ MU_TEST(test_Matrix_inc) {
 }
 
 
+MU_TEST(test_Matrix_run) {
+	Matrix U, V;
+	ThreadPool pool;
+
+	const ArrayOp ops[] = {
+		{ ArrayOpCode__inc, -1000 },
+		{ ArrayOpCode__scale, (real_t)1e-3 },
+		{ ArrayOpCode__square, 0 },
+		{ ArrayOpCode__scale, -1 },
+		{ ArrayOpCode__exp, 0 },
+		{ ArrayOpCode__heaviside, (real_t).5 }
+	};
+	size_t op_count = sizeof(ops) / sizeof(ops[0]);
+
+	mu_check(ThreadPool_init(&pool, 2));
+
+	for(size_t i = 1; i < 256; i += 37) {
+		for(size_t j = 1; j < 256; j += 37) {
+			Matrix_init(&V, i, j);
+			Matrix_filler(&V);
+			Matrix_inc(&V, -1000);
+			Matrix_scale(&V, (real_t)1e-3);
+			Matrix_square(&V);
+			Matrix_scale(&V, -1);
+			Matrix_exp(&V);
+			Matrix_heaviside(&V, (real_t).5);
+
+			// Fused operations give the same result as the operations in turn
+			Matrix_init(&U, i, j);
+			for(size_t k = 0; k < 2; ++k) {
+				Matrix_filler(&U);
+				if (k == 0)
+					Matrix_run(&U, ops, op_count);
+				else
+					Matrix_parallel_run(&U, ops, op_count, &pool);
+
+				for(size_t ui = 0; ui < i; ++ui)
+					for(size_t uj = 0; uj < j; ++uj)
+						mu_assert_double_eq(
+							Matrix_get_coeff(&V, ui, uj),
+							Matrix_get_coeff(&U, ui, uj)
+						);
+			}
+
+			Matrix_destroy(&U);
+			Matrix_destroy(&V);
+		}
+	}
+
+	ThreadPool_destroy(&pool);
+}
+
+
+// --- Gaussian filter tests --------------------------------------------------
+
+MU_TEST(test_GaussianFilter_recursive) {
+	Matrix U, V;
+	GaussianFilter convolution_filter, recursive_filter;
+	ThreadPool pool;
+
+	mu_check(ThreadPool_init(&pool, 2));
+
+	const enum GaussianFilterMode modes[] = {
+		GaussianFilterMode__ZERO,
+		GaussianFilterMode__MIRROR
+	};
+
+	for(size_t m = 0; m < 2; ++m) {
+		for(real_t sigma = 2; sigma <= 16; sigma *= 2) {
+			size_t row_count = 97, col_count = 181;
+
+			Matrix_init(&U, row_count, col_count);
+			Matrix_init(&V, row_count, col_count);
+
+			GaussianFilter_init(&convolution_filter, row_count, col_count, sigma, modes[m], GaussianFilterMethod__CONVOLUTION);
+			GaussianFilter_init(&recursive_filter, row_count, col_count, sigma, modes[m], GaussianFilterMethod__RECURSIVE);
+
+			// Values in [0, 1], the recursive filter is within 2.5% of the
+			// convolution
+			unsigned int seed = 42;
+			for(size_t i = 0; i < U.data_len; ++i) {
+				seed = 1664525 * seed + 1013904223;
+				U.data[i] = ((real_t)(seed >> 8)) / (1 << 24);
+			}
+			Matrix_copy(&V, &U);
+
+			GaussianFilter_parallel_transform(&convolution_filter, &U, &pool);
+			GaussianFilter_parallel_transform(&recursive_filter, &V, &pool);
+
+			for(size_t i = 0; i < U.data_len; ++i)
+				mu_check(fabs(U.data[i] - V.data[i]) < (real_t).025);
+
+			// Constant values are preserved in MIRROR mode
+			if (modes[m] == GaussianFilterMode__MIRROR) {
+				Matrix_fill(&V, (real_t)1);
+				GaussianFilter_transform(&recursive_filter, &V);
+
+				for(size_t i = 0; i < V.data_len; ++i)
+					mu_check(fabs(V.data[i] - 1) < (real_t)1e-4);
+			}
+
+			GaussianFilter_destroy(&recursive_filter);
+			GaussianFilter_destroy(&convolution_filter);
+			Matrix_destroy(&V);
+			Matrix_destroy(&U);
+		}
+	}
+
+	ThreadPool_destroy(&pool);
+}
+
+
+// --- Fast math tests --------------------------------------------------------
+
+#define FAST_MATH_TEST_SAMPLE_COUNT 1000003
+
+
+static int64_t
+fast_math_test_ulp_distance(
+	float x,
+	double y
+) {
+	// Map the floats to integers ordered as the floats
+	float z = (float)y;
+
+	int32_t x_bits, z_bits;
+	memcpy(&x_bits, &x, sizeof(x_bits));
+	memcpy(&z_bits, &z, sizeof(z_bits));
+
+	int64_t u = (x_bits < 0) ? ((int64_t)INT32_MIN) - x_bits : x_bits;
+	int64_t v = (z_bits < 0) ? ((int64_t)INT32_MIN) - z_bits : z_bits;
+
+	return (u > v) ? u - v : v - u;
+}
+
+
+MU_TEST(test_fast_exp) {
+	real_t start = FAST_MATH_EXP_LO;
+	real_t end   = FAST_MATH_EXP_HI;
+
+	for(size_t i = 0; i < FAST_MATH_TEST_SAMPLE_COUNT; ++i) {
+		real_t x = start + ((end - start) / (FAST_MATH_TEST_SAMPLE_COUNT - 1)) * i;
+		mu_check(fast_math_test_ulp_distance(fast_exp(x), exp((double)x)) <= 1);
+	}
+
+	mu_check(fast_exp((real_t)0) == (real_t)1);
+	mu_check(fast_exp((real_t)100) == INFINITY);
+	mu_check(fast_exp((real_t)-100) == (real_t)0);
+	mu_check(isnan(fast_exp(NAN)));
+}
+
+
+MU_TEST(test_fast_log) {
+	// Samples spread over the exponents and the mantissas
+	for(size_t i = 0; i < FAST_MATH_TEST_SAMPLE_COUNT; ++i) {
+		uint32_t bits = 0x00800000 + (uint32_t)((((uint64_t)0x7f000000) * i) / FAST_MATH_TEST_SAMPLE_COUNT);
+		real_t x;
+		memcpy(&x, &bits, sizeof(x));
+		mu_check(fast_math_test_ulp_distance(fast_log(x), log((double)x)) <= 1);
+	}
+
+	mu_check(fast_log((real_t)1) == (real_t)0);
+	mu_check(fast_log((real_t)0) == -INFINITY);
+	mu_check(fast_log(INFINITY) == INFINITY);
+	mu_check(isnan(fast_log((real_t)-1)));
+	mu_check(isnan(fast_log(NAN)));
+}
+
+
+MU_TEST(test_fast_pow) {
+	static const real_t exponents[] = {
+		(real_t)2.4, ((real_t)1) / ((real_t)3), (real_t)-.5, (real_t)2
+	};
+
+	for(size_t j = 0; j < sizeof(exponents) / sizeof(exponents[0]); ++j) {
+		real_t y = exponents[j];
+
+		// Samples for which |y log(x)| <= 4
+		real_t start = (real_t)exp(-4 / fabs(y));
+		real_t end   = (real_t)exp( 4 / fabs(y));
+
+		for(size_t i = 0; i < FAST_MATH_TEST_SAMPLE_COUNT; i += 7) {
+			real_t x = start + ((end - start) / (FAST_MATH_TEST_SAMPLE_COUNT - 1)) * i;
+			mu_check(fast_math_test_ulp_distance(fast_pow(x, y), pow((double)x, (double)y)) <= 5);
+		}
+	}
+}
+
+
+// --- array_ops backends tests ----------------------------------------------
+
+#define BACKEND_TEST_MAX_LEN 4099
+
+
+static void
+backend_test_filler(
+	real_t* dst,
+	size_t len,
+	unsigned int seed
+) {
+	// Values in [-2, -1/4] and [1/4, 2], so that divisions are well defined
+	for(size_t i = 0; i < len; ++i, ++dst) {
+		seed = 1664525 * seed + 1013904223;
+		real_t x = ((real_t)(seed >> 8)) / (1 << 24);
+		*dst = (x < (real_t).5) ? -(real_t).25 - 3.5 * x : (real_t).25 + 3.5 * (x - (real_t).5);
+	}
+}
+
+
+static bool
+backend_test_equal(
+	const real_t* u,
+	const real_t* v,
+	size_t len
+) {
+	for( ; len != 0; --len, ++u, ++v)
+		if (*u != *v)
+			return false;
+
+	return true;
+}
+
+
+MU_TEST(test_array_ops_backends) {
+	const ArrayOpsKernels* ref = &(array_ops_scalar_backend.kernels);
+
+	// Unaligned arrays, with a guard value past the end
+	real_t* a = array_ops_allocate(BACKEND_TEST_MAX_LEN + 2);
+	real_t* b = array_ops_allocate(BACKEND_TEST_MAX_LEN + 2);
+	real_t* u = array_ops_allocate(BACKEND_TEST_MAX_LEN + 2);
+	real_t* v = array_ops_allocate(BACKEND_TEST_MAX_LEN + 2);
+	real_t* state = array_ops_allocate(6 * (BACKEND_TEST_MAX_LEN + 2));
+
+	for(const ArrayOpsBackend* const* backend_ptr = array_ops_list_backends(); *backend_ptr; ++backend_ptr) {
+		const ArrayOpsBackend* backend = *backend_ptr;
+		if (!backend->is_supported())
+			continue;
+
+		printf("testing the %s backend\n", backend->name);
+		const ArrayOpsKernels* k = &(backend->kernels);
+
+		for(size_t len = 1; len <= BACKEND_TEST_MAX_LEN; len += (len < 80) ? 1 : 337) {
+			backend_test_filler(a, len + 2, (unsigned int)len);
+			backend_test_filler(b, len + 2, (unsigned int)(len + 7));
+
+			#define BACKEND_TEST_KERNEL(NAME, ...) \
+				array_ops_copy(u, a, len + 2); \
+				array_ops_copy(v, a, len + 2); \
+				ref->NAME(u + 1, __VA_ARGS__); \
+				k->NAME(v + 1, __VA_ARGS__); \
+				mu_check(backend_test_equal(u, v, len + 2));
+
+			BACKEND_TEST_KERNEL(fill, len, (real_t)42);
+			BACKEND_TEST_KERNEL(copy, b + 1, len);
+			BACKEND_TEST_KERNEL(heaviside, len, (real_t).5);
+			BACKEND_TEST_KERNEL(inc, len, (real_t).3);
+			BACKEND_TEST_KERNEL(scale, len, (real_t)-1.7);
+			BACKEND_TEST_KERNEL(scaled_copy, b + 1, len, (real_t)1.3);
+			BACKEND_TEST_KERNEL(add, b + 1, len);
+			BACKEND_TEST_KERNEL(sub, b + 1, len);
+			BACKEND_TEST_KERNEL(scaled_add, b + 1, len, (real_t)-.7);
+			BACKEND_TEST_KERNEL(mul, b + 1, len);
+			BACKEND_TEST_KERNEL(div, b + 1, len);
+			BACKEND_TEST_KERNEL(min, b + 1, len);
+			BACKEND_TEST_KERNEL(scaled_min, b + 1, len, (real_t).7);
+			BACKEND_TEST_KERNEL(max, b + 1, len);
+			BACKEND_TEST_KERNEL(scaled_max, b + 1, len, (real_t).7);
+
+			// The box filter step updates its sums, compensations and tail
+			for(size_t n = 0; n < 2; ++n) {
+				real_t* sum = state + 3 * n * (BACKEND_TEST_MAX_LEN + 2);
+				real_t* comp = sum + BACKEND_TEST_MAX_LEN + 2;
+				real_t* tail = comp + BACKEND_TEST_MAX_LEN + 2;
+
+				array_ops_scaled_copy(sum, b, len, (real_t)100);
+				array_ops_scaled_copy(comp, a, len, (real_t)1e-6);
+				array_ops_copy(tail, b + 1, len);
+
+				const ArrayOpsKernels* kernels = (n == 0) ? ref : k;
+				kernels->box_filter_step((n == 0) ? u : v, sum, comp, tail, a, len, (real_t)7);
+			}
+
+			mu_check(backend_test_equal(u, v, len));
+			for(size_t n = 0; n < 3; ++n)
+				mu_check(backend_test_equal(state + n * (BACKEND_TEST_MAX_LEN + 2), state + (n + 3) * (BACKEND_TEST_MAX_LEN + 2), len));
+
+			// Transposes of blocks of up to 19 x 19 values, strided
+			for(size_t row_count = 1; row_count <= 19 && row_count * 21 <= len; row_count += 3) {
+				for(size_t col_count = 1; col_count <= 19 && col_count * 21 <= len; col_count += 2) {
+					BACKEND_TEST_KERNEL(transpose, b + 1, row_count, col_count, 21, 20);
+				}
+			}
+
+			// The same values for the min and max, the sums up to the rounding
+			// error bound of a sequential sum
+			mu_check(ref->reduction_min(a + 1, len) == k->reduction_min(a + 1, len));
+			mu_check(ref->reduction_max(a + 1, len) == k->reduction_max(a + 1, len));
+
+			double abs_sum = 0;
+			for(size_t i = 1; i <= len; ++i)
+				abs_sum += fabs(a[i]);
+
+			real_t sum = ref->reduction_sum(a + 1, len);
+			mu_check(fabs(sum - k->reduction_sum(a + 1, len)) <= 2.5e-7 * len * abs_sum);
+
+			real_t square_sum = ref->reduction_square_sum(a + 1, len);
+			mu_check(fabs(square_sum - k->reduction_square_sum(a + 1, len)) <= 2.5e-7 * len * square_sum);
+
+			// The transcendental functions, on positive values, with inputs of
+			// exp spread over [-100, 100] to cover its clamping
+			array_ops_abs(a, len + 2);
+
+			BACKEND_TEST_KERNEL(square_root, len);
+			BACKEND_TEST_KERNEL(fast_log, len);
+			BACKEND_TEST_KERNEL(fast_pow, len, (real_t)2.4);
+			BACKEND_TEST_KERNEL(fast_pow, len, (real_t)-.3);
+
+			array_ops_scale(a, len + 2, (real_t)50);
+			array_ops_inc(a, len + 2, (real_t)-50);
+			BACKEND_TEST_KERNEL(fast_exp, len);
+
+			#undef BACKEND_TEST_KERNEL
+		}
+	}
+
+	array_ops_free(state);
+	array_ops_free(v);
+	array_ops_free(u);
+	array_ops_free(b);
+	array_ops_free(a);
+}
+
+
 // --- Main entry point -------------------------------------------------------
 
+MU_TEST_SUITE(test_GaussianFilter_suite) {
+	MU_RUN_TEST(test_GaussianFilter_recursive);
+}
+
+
+MU_TEST_SUITE(test_fast_math_suite) {
+	MU_RUN_TEST(test_fast_exp);
+	MU_RUN_TEST(test_fast_log);
+	MU_RUN_TEST(test_fast_pow);
+}
+
+
+MU_TEST_SUITE(test_array_ops_backends_suite) {
+	MU_RUN_TEST(test_array_ops_backends);
+}
+
+
 MU_TEST_SUITE(test_special_suite) {
 	MU_RUN_TEST(test_special_erfinv);
 }
@@ -1090,6 +1808,7 @@ MU_TEST_SUITE(test_kahan_sum_suite) {
 MU_TEST_SUITE(test_average_suite) {
 	MU_RUN_TEST(test_average);
 	MU_RUN_TEST(test_weighted_average);	
+	MU_RUN_TEST(test_histogram);
 }
 
 
@@ -1132,6 +1851,13 @@ MU_TEST_SUITE(test_Matrix_suite) {
 	MU_RUN_TEST(test_Matrix_sqrt);
 	MU_RUN_TEST(test_Matrix_scale);
 	MU_RUN_TEST(test_Matrix_inc);
+	MU_RUN_TEST(test_Matrix_run);
+	MU_RUN_TEST(test_Matrix_colwise_convolution);
+	MU_RUN_TEST(test_Matrix_colwise_box_filter);
+	MU_RUN_TEST(test_Matrix_iterated_box_filter);
+	MU_RUN_TEST(test_Matrix_iterated_box_filter_submitters);
+	MU_RUN_TEST(test_Matrix_padded);
+	MU_RUN_TEST(test_Matrix_view);
 	MU_RUN_TEST(test_Matrix_reduction_min);
 	MU_RUN_TEST(test_Matrix_reduction_max);
 	MU_RUN_TEST(test_Matrix_reduction_sum);
@@ -1154,6 +1880,9 @@ main(
 	MU_RUN_SUITE(test_average_suite);
 	MU_RUN_SUITE(test_Vector_suite);
 	MU_RUN_SUITE(test_Matrix_suite);
+	MU_RUN_SUITE(test_GaussianFilter_suite);
+	MU_RUN_SUITE(test_fast_math_suite);
+	MU_RUN_SUITE(test_array_ops_backends_suite);
 	MU_REPORT();
 	return MU_EXIT_CODE;
 }
@@ -0,0 +1,584 @@
+#include "minunit.h"
+
+#include <math.h>
+#include <float.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <pestacle/macros.h>
+#include <pestacle/memory.h>
+#include <pestacle/strings.h>
+
+#include "npy.h"
+#include "npy_stream.h"
+#include "ieee764.h"
+#include "load.h"
+
+
+// --- ieee764 encoding tests -------------------------------------------------
+
+#ifdef NPY_FLOAT32_IS_IEEE
+
+// Returns true if the encoding of a value matches its representation
+static bool
+test_ieee764_encode_matches(
+	float value
+) {
+	uint32_t expected;
+	memcpy(&expected, &value, sizeof(uint32_t));
+
+	union ieee764_float32 encoded;
+	ieee764_float32_encode(&encoded, value);
+
+	return encoded.uint32 == expected;
+}
+
+
+MU_TEST(test_ieee764_float32_encode) {
+	const float values[] = {
+		0.f,
+		-0.f,
+		1.f,
+		-1.5f,
+		3.14159265f,
+		FLT_MAX,
+		-FLT_MAX,
+		FLT_MIN,
+		-FLT_MIN,
+		FLT_TRUE_MIN,
+		-FLT_TRUE_MIN,
+		FLT_MIN / 3,
+		-FLT_MIN / 1024,
+		INFINITY,
+		-INFINITY
+	};
+
+	for(size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+		mu_check(test_ieee764_encode_matches(values[i]));
+
+	// Sweep the representations, NaNs aside
+	for(uint32_t bits = 0; bits < 0xfffff000u; bits += 0xfff1u) {
+		float value;
+		memcpy(&value, &bits, sizeof(float));
+
+		if (!isnan(value))
+			mu_check(test_ieee764_encode_matches(value));
+	}
+
+	// NaNs remain NaNs
+	union ieee764_float32 encoded;
+	ieee764_float32_encode(&encoded, NAN);
+
+	float decoded;
+	memcpy(&decoded, &(encoded.uint32), sizeof(float));
+	mu_check(isnan(decoded));
+}
+
+
+MU_TEST(test_npy_encode_float32) {
+	const real_t values[] = {
+		0.f,
+		-0.f,
+		1.f,
+		-2.75f,
+		FLT_TRUE_MIN,
+		-FLT_MIN / 3,
+		FLT_MAX,
+		INFINITY,
+		-INFINITY
+	};
+	const size_t value_count = sizeof(values) / sizeof(values[0]);
+
+	uint8_t encoded[sizeof(values)];
+	npy_encode_float32(encoded, values, value_count);
+
+	// Little-endian IEEE 754 float32, whatever the host
+	for(size_t i = 0; i < value_count; ++i) {
+		uint32_t bits;
+		memcpy(&bits, values + i, sizeof(uint32_t));
+
+		for(size_t j = 0; j < 4; ++j)
+			mu_check(encoded[4 * i + j] == (uint8_t)(bits >> (8 * j)));
+	}
+}
+
+#endif
+
+
+// --- npy header tests -------------------------------------------------------
+
+#define TEST_NPY_HEADER_CAPACITY 256
+
+
+// Write a header with the given version and dictionary, returns its size
+static size_t
+test_npy_make_header(
+	uint8_t* dst,
+	int version,
+	const char* dict
+) {
+	size_t dict_len = strlen(dict);
+	size_t preamble_size = (version == 1) ? 10 : 12;
+
+	memcpy(dst, "\x93NUMPY", 6);
+	dst[6] = (uint8_t)version;
+	dst[7] = 0;
+
+	dst[8] = (uint8_t)(dict_len & 0xff);
+	dst[9] = (uint8_t)((dict_len >> 8) & 0xff);
+	if (version != 1) {
+		dst[10] = (uint8_t)((dict_len >> 16) & 0xff);
+		dst[11] = (uint8_t)((dict_len >> 24) & 0xff);
+	}
+
+	memcpy(dst + preamble_size, dict, dict_len);
+
+	return preamble_size + dict_len;
+}
+
+
+MU_TEST(test_npy_header_round_trip) {
+	const size_t shapes[][3] = {
+		{ 7, 480, 640 },
+		{ 0, 2, 3 },
+		{ 5, 0, 0 }
+	};
+	const size_t dim_counts[] = { 3, 3, 1 };
+
+	for(size_t i = 0; i < sizeof(dim_counts) / sizeof(dim_counts[0]); ++i) {
+		size_t size = npy_header_size(shapes[i], dim_counts[i]);
+		mu_check(size % 64 == 0);
+
+		char header[TEST_NPY_HEADER_CAPACITY];
+		mu_check(size <= TEST_NPY_HEADER_CAPACITY);
+		mu_check(npy_format_header(header, size, shapes[i], dim_counts[i]));
+		mu_check(header[size - 1] == '\n');
+
+		// A larger header is padded
+		char large_header[2 * TEST_NPY_HEADER_CAPACITY];
+		mu_check(npy_format_header(large_header, size + 64, shapes[i], dim_counts[i]));
+		mu_check(!npy_format_header(large_header, size + 1, shapes[i], dim_counts[i]));
+
+		size_t shape[3];
+		size_t dim_count;
+		size_t data_offset;
+		mu_check(npy_parse_header((const uint8_t*)header, size, shape, 3, &dim_count, &data_offset));
+		mu_check(dim_count == dim_counts[i]);
+		mu_check(data_offset == size);
+		for(size_t j = 0; j < dim_count; ++j)
+			mu_check(shape[j] == shapes[i][j]);
+
+		mu_check(npy_parse_header((const uint8_t*)large_header, size + 64, shape, 3, &dim_count, &data_offset));
+		mu_check(data_offset == size + 64);
+	}
+
+	// A 1-D shape is written as (n,)
+	const size_t shape_1d[] = { 5 };
+	char header[TEST_NPY_HEADER_CAPACITY];
+	npy_format_header(header, npy_header_size(shape_1d, 1), shape_1d, 1);
+	header[npy_header_size(shape_1d, 1) - 1] = '\0';
+	mu_check(strstr(header + 10, "'shape': (5,)") != 0);
+}
+
+
+MU_TEST(test_npy_parse_header) {
+	uint8_t header[TEST_NPY_HEADER_CAPACITY];
+	size_t shape[3];
+	size_t dim_count;
+	size_t data_offset;
+	size_t size;
+
+	// Version 2 and 3 headers have a 4 bytes length
+	size = test_npy_make_header(header, 2, "{'descr': '<f4', 'fortran_order': False, 'shape': (3, 4), }\n");
+	mu_check(npy_parse_header(header, size, shape, 3, &dim_count, &data_offset));
+	mu_check(dim_count == 2);
+	mu_check((shape[0] == 3) && (shape[1] == 4));
+	mu_check(data_offset == size);
+
+	// Keys can come in any order
+	size = test_npy_make_header(header, 1, "{'shape': (2,), 'fortran_order': False, 'descr': '<f4'}\n");
+	mu_check(npy_parse_header(header, size, shape, 3, &dim_count, &data_offset));
+	mu_check((dim_count == 1) && (shape[0] == 2));
+
+	// Header longer than the data
+	size = test_npy_make_header(header, 1, "{'descr': '<f4', 'fortran_order': False, 'shape': (3, 4), }\n");
+	mu_check(!npy_parse_header(header, size - 1, shape, 3, &dim_count, &data_offset));
+	mu_check(!npy_parse_header(header, 9, shape, 3, &dim_count, &data_offset));
+
+	// Truncated dictionary
+	size = test_npy_make_header(header, 1, "{'descr': '<f4', 'fortran_order': False, 'shape': (3, 4");
+	mu_check(!npy_parse_header(header, size, shape, 3, &dim_count, &data_offset));
+
+	size = test_npy_make_header(header, 1, "{'descr': '<f4', 'fortran_order': False, 'sha");
+	mu_check(!npy_parse_header(header, size, shape, 3, &dim_count, &data_offset));
+
+	// Other array types
+	size = test_npy_make_header(header, 1, "{'descr': '<f8', 'fortran_order': False, 'shape': (3, 4), }\n");
+	mu_check(!npy_parse_header(header, size, shape, 3, &dim_count, &data_offset));
+
+	size = test_npy_make_header(header, 1, "{'descr': '>f4', 'fortran_order': False, 'shape': (3, 4), }\n");
+	mu_check(!npy_parse_header(header, size, shape, 3, &dim_count, &data_offset));
+
+	size = test_npy_make_header(header, 1, "{'descr': '<f4', 'fortran_order': True, 'shape': (3, 4), }\n");
+	mu_check(!npy_parse_header(header, size, shape, 3, &dim_count, &data_offset));
+
+	// Too many dimensions
+	size = test_npy_make_header(header, 1, "{'descr': '<f4', 'fortran_order': False, 'shape': (2, 3, 4, 5), }\n");
+	mu_check(!npy_parse_header(header, size, shape, 3, &dim_count, &data_offset));
+
+	// Wrong signature
+	size = test_npy_make_header(header, 1, "{'descr': '<f4', 'fortran_order': False, 'shape': (3, 4), }\n");
+	header[1] = 'X';
+	mu_check(!npy_parse_header(header, size, shape, 3, &dim_count, &data_offset));
+}
+
+
+// --- npy stream tests -------------------------------------------------------
+
+#define TEST_NPY_STREAM_PATH "test_npy_stream.npy"
+#define TEST_NPY_STREAM_ROW_COUNT 100
+#define TEST_NPY_STREAM_COL_COUNT 333
+#define TEST_NPY_STREAM_FRAME_COUNT 40
+
+
+// Read a whole file, returns 0 on failure
+static uint8_t*
+test_read_file(
+	const char* path,
+	size_t* size
+) {
+	FILE* fp = fopen(path, "rb");
+	if (!fp)
+		return 0;
+
+	fseek(fp, 0, SEEK_END);
+	long len = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	uint8_t* data = (uint8_t*)checked_malloc((size_t)len);
+	*size = fread(data, 1, (size_t)len, fp);
+	fclose(fp);
+
+	return data;
+}
+
+
+MU_TEST(test_NpyStream_round_trip) {
+	const size_t row_count = TEST_NPY_STREAM_ROW_COUNT;
+	const size_t col_count = TEST_NPY_STREAM_COL_COUNT;
+	const size_t frame_count = TEST_NPY_STREAM_FRAME_COUNT;
+	const size_t payload_len = 4 * frame_count * row_count * col_count;
+
+	// The frames span several buffer writes, the last one partial
+	mu_check(payload_len > NPY_STREAM_BUFFER_SIZE);
+	mu_check((NPY_STREAM_BLOCK_SIZE + payload_len) % NPY_STREAM_BUFFER_SIZE != 0);
+
+	Matrix frame;
+	Matrix_init(&frame, row_count, col_count);
+	uint8_t* expected = (uint8_t*)checked_malloc(payload_len);
+
+	// With direct I/O requested, the stream might fall back to the page cache
+	for(int direct_io = 0; direct_io < 2; ++direct_io) {
+		NpyStream stream;
+		mu_check(NpyStream_open(&stream, TEST_NPY_STREAM_PATH, row_count, col_count, direct_io == 1));
+
+		uint8_t* expected_row = expected;
+		for(size_t k = 0; k < frame_count; ++k) {
+			for(size_t i = 0; i < row_count; ++i, expected_row += 4 * col_count) {
+				for(size_t j = 0; j < col_count; ++j)
+					Matrix_set_coeff(&frame, i, j, (real_t)k - ((real_t)i) / 4 + ((real_t)j) / 1024);
+
+				npy_encode_float32(expected_row, frame.data + i * frame.row_stride, col_count);
+			}
+
+			mu_check(NpyStream_write(&stream, &frame));
+		}
+
+		mu_check(NpyStream_close(&stream));
+
+		// The header gives the final shape, followed by the frames as written
+		size_t size = 0;
+		uint8_t* data = test_read_file(TEST_NPY_STREAM_PATH, &size);
+		remove(TEST_NPY_STREAM_PATH);
+
+		mu_check(data != 0);
+		mu_check(size == NPY_STREAM_BLOCK_SIZE + payload_len);
+
+		size_t shape[3];
+		size_t dim_count;
+		size_t data_offset;
+		mu_check(npy_parse_header(data, size, shape, 3, &dim_count, &data_offset));
+		mu_check(dim_count == 3);
+		mu_check((shape[0] == frame_count) && (shape[1] == row_count) && (shape[2] == col_count));
+		mu_check(data_offset == NPY_STREAM_BLOCK_SIZE);
+		mu_check(memcmp(data + data_offset, expected, payload_len) == 0);
+
+		free(data);
+	}
+
+	free(expected);
+	Matrix_destroy(&frame);
+}
+
+
+// --- load node tests --------------------------------------------------------
+
+#define TEST_LOAD_PATH "test_load.npy"
+#define TEST_LOAD_ROW_COUNT 3
+#define TEST_LOAD_COL_COUNT 5
+
+
+static real_t
+test_load_coeff(
+	size_t frame_index,
+	size_t i,
+	size_t j
+) {
+	return (real_t)(1000 * frame_index + 16 * i + j);
+}
+
+
+// Write a .npy file with the given header shape, followed by frame_count frames and extra_len bytes
+static bool
+test_load_write_file(
+	const size_t* shape,
+	size_t dim_count,
+	size_t frame_count,
+	size_t extra_len
+) {
+	size_t header_size = npy_header_size(shape, dim_count);
+	char* header = (char*)checked_malloc(header_size);
+	if (!npy_format_header(header, header_size, shape, dim_count)) {
+		free(header);
+		return false;
+	}
+
+	FILE* fp = fopen(TEST_LOAD_PATH, "wb");
+	if (!fp) {
+		free(header);
+		return false;
+	}
+
+	fwrite(header, 1, header_size, fp);
+	free(header);
+
+	uint8_t row[4 * TEST_LOAD_COL_COUNT];
+	real_t coeffs[TEST_LOAD_COL_COUNT];
+	for(size_t k = 0; k < frame_count; ++k)
+		for(size_t i = 0; i < TEST_LOAD_ROW_COUNT; ++i) {
+			for(size_t j = 0; j < TEST_LOAD_COL_COUNT; ++j)
+				coeffs[j] = test_load_coeff(k, i, j);
+
+			npy_encode_float32(row, coeffs, TEST_LOAD_COL_COUNT);
+			fwrite(row, 1, sizeof(row), fp);
+		}
+
+	for(size_t i = 0; i < extra_len; ++i)
+		fputc(0, fp);
+
+	return fclose(fp) == 0;
+}
+
+
+static Node*
+test_load_node_new(
+	bool loop
+) {
+	Node* node = Node_new("load", &matrix_io_load_node_delegate, 0);
+
+	ParameterValue* value;
+	Node_get_parameter_by_name(node, "path", 0, &value);
+	free(value->string_value);
+	value->string_value = strclone(TEST_LOAD_PATH);
+
+	Node_get_parameter_by_name(node, "loop", 0, &value);
+	value->bool_value = loop;
+
+	return node;
+}
+
+
+static void
+test_load_node_delete(
+	Node* node
+) {
+	Node_destroy(node);
+	free(node);
+}
+
+
+// Check that the node outputs the given frame
+static bool
+test_load_check_frame(
+	Node* node,
+	size_t frame_index
+) {
+	const Matrix* frame = Node_output(node).matrix;
+	if ((frame->row_count != TEST_LOAD_ROW_COUNT) || (frame->col_count != TEST_LOAD_COL_COUNT))
+		return false;
+
+	for(size_t i = 0; i < TEST_LOAD_ROW_COUNT; ++i)
+		for(size_t j = 0; j < TEST_LOAD_COL_COUNT; ++j)
+			if (Matrix_get_coeff(frame, i, j) != test_load_coeff(frame_index, i, j))
+				return false;
+
+	return true;
+}
+
+
+// Setup a load node on the test file and check the frames of successive updates
+static bool
+test_load_check_frames(
+	bool loop,
+	const size_t* frame_indices,
+	size_t update_count
+) {
+	Node* node = test_load_node_new(loop);
+
+	bool ret = Node_setup(node);
+	ret = ret && (node->out_descriptor.type == DataType__matrix);
+	ret = ret && (node->out_descriptor.matrix.width == TEST_LOAD_COL_COUNT);
+	ret = ret && (node->out_descriptor.matrix.height == TEST_LOAD_ROW_COUNT);
+
+	for(size_t i = 0; ret && (i < update_count); ++i) {
+		Node_update(node);
+		ret = test_load_check_frame(node, frame_indices[i]);
+	}
+
+	test_load_node_delete(node);
+	return ret;
+}
+
+
+static bool
+test_load_setup_fails(void) {
+	Node* node = test_load_node_new(true);
+	bool ret = !Node_setup(node);
+	test_load_node_delete(node);
+	return ret;
+}
+
+
+MU_TEST(test_load_closed_recording) {
+	const size_t shape[] = { 3, TEST_LOAD_ROW_COUNT, TEST_LOAD_COL_COUNT };
+	const size_t frame_indices[] = { 0, 1, 2, 0, 1 };
+
+	// Bytes past the recorded frames are ignored
+	mu_check(test_load_write_file(shape, 3, 4, 7));
+	mu_check(test_load_check_frames(true, frame_indices, 5));
+
+	// A single matrix is a recording of one frame
+	mu_check(test_load_write_file(shape + 1, 2, 1, 0));
+	mu_check(test_load_check_frames(true, frame_indices, 1));
+	mu_check(test_load_check_frames(false, frame_indices, 1));
+
+	remove(TEST_LOAD_PATH);
+}
+
+
+MU_TEST(test_load_unclosed_recording) {
+	const size_t shape[] = { 0, TEST_LOAD_ROW_COUNT, TEST_LOAD_COL_COUNT };
+	const size_t frame_indices[] = { 0, 1, 2, 3, 0 };
+
+	// The frame count comes from the file size, a partial last frame is dropped
+	mu_check(test_load_write_file(shape, 3, 4, 4 * TEST_LOAD_COL_COUNT));
+	mu_check(test_load_check_frames(true, frame_indices, 5));
+
+	// No complete frame
+	mu_check(test_load_write_file(shape, 3, 0, 4 * TEST_LOAD_COL_COUNT));
+	mu_check(test_load_setup_fails());
+
+	remove(TEST_LOAD_PATH);
+}
+
+
+MU_TEST(test_load_invalid_files) {
+	// Missing file
+	remove(TEST_LOAD_PATH);
+	mu_check(test_load_setup_fails());
+
+	// Fewer frames than in the header
+	const size_t truncated_shape[] = { 4, TEST_LOAD_ROW_COUNT, TEST_LOAD_COL_COUNT };
+	mu_check(test_load_write_file(truncated_shape, 3, 3, 4 * TEST_LOAD_COL_COUNT));
+	mu_check(test_load_setup_fails());
+
+	// Frame size overflowing a size_t, wrapping to 4 bytes
+	const size_t overflow_shape[] = { 1, SIZE_MAX / sizeof(real_t) + 2, 1 };
+	mu_check(test_load_write_file(overflow_shape, 3, 1, 0));
+	mu_check(test_load_setup_fails());
+
+	// Frame larger than the file
+	const size_t oversized_shape[] = { 1, 1 << 20, 1 << 20 };
+	mu_check(test_load_write_file(oversized_shape, 3, 1, 0));
+	mu_check(test_load_setup_fails());
+
+	// Empty matrices
+	const size_t empty_shape[] = { 1, 0, TEST_LOAD_COL_COUNT };
+	mu_check(test_load_write_file(empty_shape, 3, 1, 0));
+	mu_check(test_load_setup_fails());
+
+	// Not a matrix
+	mu_check(test_load_write_file(truncated_shape + 2, 1, 1, 0));
+	mu_check(test_load_setup_fails());
+
+	remove(TEST_LOAD_PATH);
+}
+
+
+MU_TEST(test_load_loop) {
+	const size_t shape[] = { 3, TEST_LOAD_ROW_COUNT, TEST_LOAD_COL_COUNT };
+	const size_t loop_frame_indices[] = { 0, 1, 2, 0, 1, 2, 0 };
+	const size_t no_loop_frame_indices[] = { 0, 1, 2, 2, 2, 2, 2 };
+
+	// Past the last frame, either start again or stay on it
+	mu_check(test_load_write_file(shape, 3, 3, 0));
+	mu_check(test_load_check_frames(true, loop_frame_indices, 7));
+	mu_check(test_load_check_frames(false, no_loop_frame_indices, 7));
+
+	remove(TEST_LOAD_PATH);
+}
+
+
+// --- Main entry point ------------------------------------------------------
+
+#ifdef NPY_FLOAT32_IS_IEEE
+MU_TEST_SUITE(test_ieee764_suite) {
+	MU_RUN_TEST(test_ieee764_float32_encode);
+	MU_RUN_TEST(test_npy_encode_float32);
+}
+#endif
+
+
+MU_TEST_SUITE(test_npy_header_suite) {
+	MU_RUN_TEST(test_npy_header_round_trip);
+	MU_RUN_TEST(test_npy_parse_header);
+}
+
+
+MU_TEST_SUITE(test_NpyStream_suite) {
+	MU_RUN_TEST(test_NpyStream_round_trip);
+}
+
+
+MU_TEST_SUITE(test_load_suite) {
+	MU_RUN_TEST(test_load_closed_recording);
+	MU_RUN_TEST(test_load_unclosed_recording);
+	MU_RUN_TEST(test_load_invalid_files);
+	MU_RUN_TEST(test_load_loop);
+}
+
+
+int
+main(
+	ATTRIBUTE_UNUSED int argc,
+	ATTRIBUTE_UNUSED char *argv[]
+) {
+	#ifdef NPY_FLOAT32_IS_IEEE
+	MU_RUN_SUITE(test_ieee764_suite);
+	#endif
+	MU_RUN_SUITE(test_npy_header_suite);
+	MU_RUN_SUITE(test_NpyStream_suite);
+	MU_RUN_SUITE(test_load_suite);
+	MU_REPORT();
+	return MU_EXIT_CODE;
+}
@@ -6,6 +6,9 @@
 #include <pestacle/memory.h>
 #include <pestacle/tree_map.h>
 #include <pestacle/string_list.h>
+#include <pestacle/thread_pool.h>
+#include <pestacle/ring_writer.h>
+#include <pestacle/graph.h>
 
 
 // --- TreeMap testing -------------------------------------------------------
@@ -168,6 +171,1037 @@ MU_TEST(test_StringList_join) {
 }
 
 
+// --- ThreadPool testing ----------------------------------------------------
+
+#define THREAD_POOL_VALUE_COUNT 100000
+
+
+static void
+test_ThreadPool_increment_job(
+	void* context,
+	size_t begin,
+	size_t end
+) {
+	int* values = (int*)context;
+	for(size_t i = begin; i < end; ++i)
+		values[i] += 1;
+}
+
+
+typedef struct {
+	ThreadPool* pool;
+	int* values;
+} NestedJobContext;
+
+
+static void
+test_ThreadPool_nested_job(
+	void* context,
+	size_t begin,
+	size_t end
+) {
+	NestedJobContext* nested_context = (NestedJobContext*)context;
+	for(size_t i = begin; i < end; ++i)
+		ThreadPool_parallel_for(
+			nested_context->pool,
+			test_ThreadPool_increment_job,
+			nested_context->values + i * 1000,
+			0, 1000, 16
+		);
+}
+
+
+MU_TEST(test_ThreadPool_parallel_for) {
+	int* values = (int*)checked_malloc(sizeof(int) * THREAD_POOL_VALUE_COUNT);
+
+	for(size_t thread_count = 0; thread_count < 4; ++thread_count) {
+		ThreadPool pool;
+		mu_check(ThreadPool_init(&pool, thread_count));
+
+		for(size_t i = 0; i < THREAD_POOL_VALUE_COUNT; ++i)
+			values[i] = 0;
+
+		// Each index is processed exactly once
+		ThreadPool_parallel_for(&pool, test_ThreadPool_increment_job, values, 0, THREAD_POOL_VALUE_COUNT, 64);
+
+		// Jobs can submit jobs
+		NestedJobContext context = { &pool, values };
+		ThreadPool_parallel_for(&pool, test_ThreadPool_nested_job, &context, 0, THREAD_POOL_VALUE_COUNT / 1000, 1);
+
+		for(size_t i = 0; i < THREAD_POOL_VALUE_COUNT; ++i)
+			if (values[i] != 2)
+				mu_fail("each index should be processed exactly once");
+
+		ThreadPool_destroy(&pool);
+	}
+
+	// Without a pool, the job is run by the caller
+	for(size_t i = 0; i < THREAD_POOL_VALUE_COUNT; ++i)
+		values[i] = 0;
+
+	ThreadPool_parallel_for(0, test_ThreadPool_increment_job, values, 0, THREAD_POOL_VALUE_COUNT, 64);
+	for(size_t i = 0; i < THREAD_POOL_VALUE_COUNT; ++i)
+		mu_check(values[i] == 1);
+
+	free(values);
+}
+
+
+// --- RingWriter testing ---------------------------------------------------
+
+#define RING_WRITER_ITEM_COUNT 1000
+
+
+typedef struct {
+	size_t next_value;
+	size_t error_count;
+} RingWriterTestOutput;
+
+
+static void
+test_RingWriter_copy(
+	void* caller,
+	void* slot,
+	const void* item
+) {
+	(void)caller;
+	*((size_t*)slot) = *((const size_t*)item);
+}
+
+
+static bool
+test_RingWriter_write(
+	void* caller,
+	void* slot
+) {
+	// Items are expected in order, odd values fail to be written
+	RingWriterTestOutput* output = (RingWriterTestOutput*)caller;
+	size_t value = *((size_t*)slot);
+
+	if (value != output->next_value)
+		output->error_count += 1;
+
+	output->next_value = value + 1;
+	return (value % 2) == 0;
+}
+
+
+MU_TEST(test_RingWriter_push) {
+	size_t slots[4];
+	RingWriterTestOutput output = { 0, 0 };
+
+	RingWriter writer;
+	mu_check(RingWriter_init(
+		&writer,
+		slots,
+		sizeof(slots) / sizeof(slots[0]),
+		sizeof(slots[0]),
+		RingWriterPolicy__block,
+		test_RingWriter_copy,
+		test_RingWriter_write,
+		&output,
+		"test-writer"
+	));
+
+	for(size_t i = 0; i < RING_WRITER_ITEM_COUNT; ++i)
+		mu_check(RingWriter_push(&writer, &i));
+
+	RingWriter_wait(&writer);
+
+	mu_check(RingWriter_pending_count(&writer) == 0);
+	mu_check(RingWriter_queued_count(&writer) == RING_WRITER_ITEM_COUNT);
+	mu_check(RingWriter_written_count(&writer) == RING_WRITER_ITEM_COUNT / 2);
+	mu_check(RingWriter_failed_count(&writer) == RING_WRITER_ITEM_COUNT / 2);
+	mu_check(RingWriter_dropped_count(&writer) == 0);
+
+	RingWriter_destroy(&writer);
+
+	mu_check(output.error_count == 0);
+	mu_check(output.next_value == RING_WRITER_ITEM_COUNT);
+}
+
+
+// --- GraphMemoryPlan testing -----------------------------------------------
+
+#define TEST_GRAPH_WIDTH 8
+#define TEST_GRAPH_HEIGHT 6
+#define TEST_GRAPH_FRAME_COUNT 4
+
+
+// When false, the test nodes allocate their own output, as a reference
+static bool test_graph_is_planned = true;
+
+
+static const NodeInputDefinition
+test_graph_no_inputs[] = {
+	NODE_INPUT_DEFINITION_END
+};
+
+
+static const NodeInputDefinition
+test_graph_inputs[] = {
+	{
+		"a",
+		true
+	},
+	{
+		"b",
+		false
+	},
+	NODE_INPUT_DEFINITION_END
+};
+
+
+static const NodeInputDefinition
+test_graph_single_input[] = {
+	{
+		"a",
+		true
+	},
+	NODE_INPUT_DEFINITION_END
+};
+
+
+static const ParameterDefinition
+test_graph_parameters[] = {
+	{
+		ParameterType__integer,
+		"value",
+		{ .int64_value = 0 }
+	},
+	PARAMETER_DEFINITION_END
+};
+
+
+static void
+test_graph_setup_output(
+	Node* self,
+	size_t width,
+	size_t height
+) {
+	DataDescriptor_set_as_matrix(&(self->out_descriptor), width, height);
+
+	if (test_graph_is_planned)
+		Node_request_output_buffer(self);
+	else
+		Matrix_init(&(self->output_buffer), height, width);
+}
+
+
+static bool
+test_graph_node_setup(
+	Node* self
+) {
+	test_graph_setup_output(self, TEST_GRAPH_WIDTH, TEST_GRAPH_HEIGHT);
+	return true;
+}
+
+
+static bool
+test_graph_input_node_setup(
+	Node* self
+) {
+	const DataDescriptor* in_descriptor = &(self->inputs[0]->out_descriptor);
+
+	test_graph_setup_output(
+		self,
+		in_descriptor->matrix.width,
+		in_descriptor->matrix.height
+	);
+
+	return true;
+}
+
+
+static bool
+test_graph_constant_node_setup(
+	Node* self
+) {
+	// Never updated, thus computed once with its own storage
+	DataDescriptor_set_as_matrix(&(self->out_descriptor), TEST_GRAPH_WIDTH, TEST_GRAPH_HEIGHT);
+	Matrix_init(&(self->output_buffer), TEST_GRAPH_HEIGHT, TEST_GRAPH_WIDTH);
+	Matrix_fill(&(self->output_buffer), (real_t)self->parameters[0].int64_value);
+	return true;
+}
+
+
+static bool
+test_graph_view_node_setup(
+	Node* self
+) {
+	// All the rows of the input but the first one
+	const DataDescriptor* in_descriptor = &(self->inputs[0]->out_descriptor);
+
+	DataDescriptor_set_as_matrix(
+		&(self->out_descriptor),
+		in_descriptor->matrix.width,
+		in_descriptor->matrix.height - 1
+	);
+
+	Node_request_output_view(self);
+	return true;
+}
+
+
+// value * a + 1
+static void
+test_graph_affine_ops(
+	const Node* self,
+	ArrayOp* ops
+) {
+	ops[0].code = ArrayOpCode__scale;
+	ops[0].arg = (real_t)self->parameters[0].int64_value;
+	ops[1].code = ArrayOpCode__inc;
+	ops[1].arg = (real_t)1;
+}
+
+
+static bool
+test_graph_affine_node_setup(
+	Node* self
+) {
+	test_graph_input_node_setup(self);
+
+	// Without a planned output, run as an unfused node
+	if (self->requests_output_buffer) {
+		ArrayOp ops[2];
+		test_graph_affine_ops(self, ops);
+		Node_set_element_wise_ops(self, ops, 2);
+	}
+
+	return true;
+}
+
+
+static void
+test_graph_node_destroy(
+	Node* self
+) {
+	if ((!self->requests_output_buffer) && (!self->is_view) && (self->output_buffer.data))
+		Matrix_destroy(&(self->output_buffer));
+}
+
+
+static void
+test_graph_source_node_update(
+	Node* self
+) {
+	// Changes at each update
+	for(size_t i = 0; i < self->output_buffer.row_count; ++i)
+		for(size_t j = 0; j < self->output_buffer.col_count; ++j)
+			Matrix_set_coeff(
+				&(self->output_buffer),
+				i,
+				j,
+				(real_t)(self->parameters[0].int64_value + self->version) + ((real_t)i) / 2 + ((real_t)j) / 4
+			);
+}
+
+
+static bool
+test_graph_counter_node_setup(
+	Node* self
+) {
+	// Frame counter, only read and written by the update
+	self->data = checked_calloc(1, sizeof(int64_t));
+
+	test_graph_setup_output(self, TEST_GRAPH_WIDTH, TEST_GRAPH_HEIGHT);
+	return true;
+}
+
+
+static void
+test_graph_counter_node_destroy(
+	Node* self
+) {
+	free(self->data);
+	test_graph_node_destroy(self);
+}
+
+
+static void
+test_graph_counter_node_update(
+	Node* self
+) {
+	// Changes at each update, whichever thread runs it
+	int64_t* frame_index = (int64_t*)self->data;
+
+	for(size_t i = 0; i < self->output_buffer.row_count; ++i)
+		for(size_t j = 0; j < self->output_buffer.col_count; ++j)
+			Matrix_set_coeff(
+				&(self->output_buffer),
+				i,
+				j,
+				(real_t)(self->parameters[0].int64_value + *frame_index) + ((real_t)i) / 2 + ((real_t)j) / 4
+			);
+
+	*frame_index += 1;
+}
+
+
+static void
+test_graph_add_node_update(
+	Node* self
+) {
+	// a + b, or 2 a + 1 without b
+	if (!self->is_in_place)
+		Matrix_copy(&(self->output_buffer), Node_output(self->inputs[0]).matrix);
+
+	if (self->inputs[1])
+		Matrix_add(&(self->output_buffer), Node_output(self->inputs[1]).matrix);
+	else {
+		Matrix_scale(&(self->output_buffer), (real_t)2);
+		Matrix_inc(&(self->output_buffer), (real_t)1);
+	}
+}
+
+
+static void
+test_graph_affine_node_update(
+	Node* self
+) {
+	if (!self->is_in_place)
+		Matrix_copy(&(self->output_buffer), Node_output(self->inputs[0]).matrix);
+
+	if (self->element_wise_op_count)
+		Node_run_element_wise_ops(self);
+	else {
+		ArrayOp ops[2];
+		test_graph_affine_ops(self, ops);
+		Matrix_run(&(self->output_buffer), ops, 2);
+	}
+}
+
+
+static void
+test_graph_view_node_update(
+	Node* self
+) {
+	const Matrix* src = Node_output(self->inputs[0]).matrix;
+
+	Matrix_init_view(
+		&(self->output_buffer),
+		src,
+		1,
+		0,
+		self->output_buffer.row_count,
+		self->output_buffer.col_count
+	);
+}
+
+
+static NodeOutput
+test_graph_node_output(
+	const Node* self
+) {
+	NodeOutput ret = { .matrix = &(self->output_buffer) };
+	return ret;
+}
+
+
+static const NodeDelegate
+test_graph_source_node_delegate = {
+	"source",
+	test_graph_no_inputs,
+	test_graph_parameters,
+	{
+		test_graph_node_setup,
+		test_graph_node_destroy,
+		test_graph_source_node_update,
+		test_graph_node_output
+	},
+	NodeDelegateFlag__none
+};
+
+
+static const NodeDelegate
+test_graph_counter_node_delegate = {
+	"counter",
+	test_graph_no_inputs,
+	test_graph_parameters,
+	{
+		test_graph_counter_node_setup,
+		test_graph_counter_node_destroy,
+		test_graph_counter_node_update,
+		test_graph_node_output
+	},
+	NodeDelegateFlag__none
+};
+
+
+static const NodeDelegate
+test_graph_constant_node_delegate = {
+	"constant",
+	test_graph_no_inputs,
+	test_graph_parameters,
+	{
+		test_graph_constant_node_setup,
+		test_graph_node_destroy,
+		0,
+		test_graph_node_output
+	},
+	NodeDelegateFlag__none
+};
+
+
+static const NodeDelegate
+test_graph_add_node_delegate = {
+	"add",
+	test_graph_inputs,
+	test_graph_parameters,
+	{
+		test_graph_input_node_setup,
+		test_graph_node_destroy,
+		test_graph_add_node_update,
+		test_graph_node_output
+	},
+	NodeDelegateFlag__stateless | NodeDelegateFlag__in_place
+};
+
+
+static const NodeDelegate
+test_graph_affine_node_delegate = {
+	"affine",
+	test_graph_single_input,
+	test_graph_parameters,
+	{
+		test_graph_affine_node_setup,
+		test_graph_node_destroy,
+		test_graph_affine_node_update,
+		test_graph_node_output
+	},
+	NodeDelegateFlag__stateless | NodeDelegateFlag__in_place
+};
+
+
+static const NodeDelegate
+test_graph_view_node_delegate = {
+	"view",
+	test_graph_inputs,
+	test_graph_parameters,
+	{
+		test_graph_view_node_setup,
+		test_graph_node_destroy,
+		test_graph_view_node_update,
+		test_graph_node_output
+	},
+	NodeDelegateFlag__stateless
+};
+
+
+static const ScopeDelegate
+test_graph_scope_delegate = {
+	"test",
+	test_graph_parameters,
+	{
+		0,
+		0
+	}
+};
+
+
+typedef struct {
+	const char* name;
+	const NodeDelegate* delegate;
+	const char* input_a;
+	const char* input_b;
+	int64_t value;
+} TestGraphNodeDefinition;
+
+
+typedef struct {
+	Scope* scope;
+	Graph graph;
+} TestGraph;
+
+
+static Node*
+TestGraph_find(
+	TestGraph* self,
+	const char* name
+) {
+	for(size_t i = 0; i < self->graph.sorted_node_count; ++i)
+		if (strcmp(self->graph.sorted_nodes[i]->name, name) == 0)
+			return self->graph.sorted_nodes[i];
+
+	return 0;
+}
+
+
+static bool
+TestGraph_init(
+	TestGraph* self,
+	const TestGraphNodeDefinition* defs,
+	size_t def_count,
+	bool is_planned
+) {
+	self->scope = Scope_new("test", &test_graph_scope_delegate, 0);
+
+	// Nodes are defined after their inputs
+	Node** nodes = (Node**)checked_malloc(def_count * sizeof(Node*));
+	for(size_t i = 0; i < def_count; ++i) {
+		nodes[i] = Node_new(defs[i].name, defs[i].delegate, self->scope);
+		nodes[i]->parameters[0].int64_value = defs[i].value;
+
+		for(size_t j = 0; j < i; ++j) {
+			if (defs[i].input_a && (strcmp(defs[i].input_a, defs[j].name) == 0))
+				Node_set_input_by_name(nodes[i], "a", nodes[j]);
+
+			if (defs[i].input_b && (strcmp(defs[i].input_b, defs[j].name) == 0))
+				Node_set_input_by_name(nodes[i], "b", nodes[j]);
+		}
+
+		Scope_add_node(self->scope, nodes[i]);
+	}
+
+	free(nodes);
+
+	test_graph_is_planned = is_planned;
+	bool ret = Graph_init(&(self->graph), self->scope) && Graph_setup(&(self->graph));
+	test_graph_is_planned = true;
+
+	return ret;
+}
+
+
+static void
+TestGraph_destroy(
+	TestGraph* self
+) {
+	Graph_destroy(&(self->graph));
+	Scope_destroy(self->scope);
+	free(self->scope);
+}
+
+
+// Returns true if the output of a node shares its storage with another node
+static bool
+TestGraph_shares_buffer(
+	TestGraph* self,
+	const char* name
+) {
+	Node* node = TestGraph_find(self, name);
+	for(size_t i = 0; i < self->graph.sorted_node_count; ++i) {
+		Node* other = self->graph.sorted_nodes[i];
+		if ((other != node) && (other->requests_output_buffer) && (other->output_buffer.data == node->output_buffer.data))
+			return true;
+	}
+
+	return false;
+}
+
+
+static bool
+test_graph_matrix_equals(
+	const Matrix* a,
+	const Matrix* b
+) {
+	if ((a->row_count != b->row_count) || (a->col_count != b->col_count))
+		return false;
+
+	for(size_t i = 0; i < a->row_count; ++i)
+		for(size_t j = 0; j < a->col_count; ++j)
+			if (Matrix_get_coeff(a, i, j) != Matrix_get_coeff(b, i, j))
+				return false;
+
+	return true;
+}
+
+
+/*
+ * Update the graph with a planned memory, serially then with a thread pool,
+ * and check that the outputs read by no node match the ones of a graph with
+ * a buffer per node
+ */
+
+static bool
+test_graph_check_outputs(
+	const TestGraphNodeDefinition* defs,
+	size_t def_count
+) {
+	bool ret = true;
+
+	ThreadPool pool;
+	ThreadPool_init(&pool, 3);
+
+	for(int k = 0; (k < 2) && ret; ++k) {
+		TestGraph reference;
+		TestGraph planned;
+		if ((!TestGraph_init(&reference, defs, def_count, false)) || (!TestGraph_init(&planned, defs, def_count, true))) {
+			ret = false;
+			break;
+		}
+
+		if (k == 1)
+			Graph_set_thread_pool(&(planned.graph), &pool);
+
+		for(size_t frame = 0; frame < TEST_GRAPH_FRAME_COUNT; ++frame) {
+			Graph_update(&(reference.graph));
+			Graph_update(&(planned.graph));
+
+			for(size_t i = 0; i < def_count; ++i) {
+				bool is_read = false;
+				for(size_t j = i + 1; j < def_count; ++j)
+					if ((defs[j].input_a && (strcmp(defs[j].input_a, defs[i].name) == 0)) || (defs[j].input_b && (strcmp(defs[j].input_b, defs[i].name) == 0)))
+						is_read = true;
+
+				if (is_read)
+					continue;
+
+				ret &= test_graph_matrix_equals(
+					Node_output(TestGraph_find(&reference, defs[i].name)).matrix,
+					Node_output(TestGraph_find(&planned, defs[i].name)).matrix
+				);
+			}
+		}
+
+		TestGraph_destroy(&planned);
+		TestGraph_destroy(&reference);
+	}
+
+	ThreadPool_destroy(&pool);
+	return ret;
+}
+
+
+MU_TEST(test_GraphMemoryPlan_chain) {
+	static const TestGraphNodeDefinition defs[] = {
+		{ "src", &test_graph_source_node_delegate, 0, 0, 1 },
+		{ "x", &test_graph_add_node_delegate, "src", 0, 0 },
+		{ "y", &test_graph_add_node_delegate, "x", 0, 0 },
+		{ "z", &test_graph_add_node_delegate, "y", 0, 0 }
+	};
+	const size_t def_count = sizeof(defs) / sizeof(defs[0]);
+
+	TestGraph graph;
+	mu_check(TestGraph_init(&graph, defs, def_count, true));
+
+	// A source may be updated ahead of the graph, and keeps its buffer. Each
+	// other node takes over the buffer of its input.
+	mu_check(graph.graph.memory_plan->buffer_count == 2);
+	mu_check(graph.graph.memory_plan->in_place_count == 2);
+	mu_check(!TestGraph_find(&graph, "x")->is_in_place);
+	mu_check(TestGraph_find(&graph, "y")->is_in_place);
+	mu_check(TestGraph_find(&graph, "z")->is_in_place);
+	mu_check(TestGraph_find(&graph, "z")->output_buffer.data == TestGraph_find(&graph, "x")->output_buffer.data);
+
+	TestGraph_destroy(&graph);
+
+	mu_check(test_graph_check_outputs(defs, def_count));
+}
+
+
+MU_TEST(test_GraphMemoryPlan_diamond) {
+	static const TestGraphNodeDefinition defs[] = {
+		{ "src", &test_graph_source_node_delegate, 0, 0, 1 },
+		{ "left", &test_graph_add_node_delegate, "src", 0, 0 },
+		{ "right", &test_graph_add_node_delegate, "src", "src", 0 },
+		{ "join", &test_graph_add_node_delegate, "left", "right", 0 },
+		{ "out", &test_graph_add_node_delegate, "join", 0, 0 },
+		{ "tail", &test_graph_add_node_delegate, "out", "out", 0 }
+	};
+	const size_t def_count = sizeof(defs) / sizeof(defs[0]);
+
+	TestGraph graph;
+	mu_check(TestGraph_init(&graph, defs, def_count, true));
+
+	Node* left = TestGraph_find(&graph, "left");
+	Node* right = TestGraph_find(&graph, "right");
+	Node* join = TestGraph_find(&graph, "join");
+	Node* out = TestGraph_find(&graph, "out");
+	Node* tail = TestGraph_find(&graph, "tail");
+
+	// Updated even when left is not, join can not overwrite its output
+	mu_check(!left->is_in_place);
+	mu_check(!right->is_in_place);
+	mu_check(!join->is_in_place);
+	mu_check(left->output_buffer.data != right->output_buffer.data);
+	mu_check(join->output_buffer.data != left->output_buffer.data);
+	mu_check(join->output_buffer.data != right->output_buffer.data);
+
+	// The only reader of join takes over its buffer
+	mu_check(out->is_in_place);
+	mu_check(out->output_buffer.data == join->output_buffer.data);
+
+	// Once join is updated, the buffers of left and right are free
+	mu_check((tail->output_buffer.data == left->output_buffer.data) || (tail->output_buffer.data == right->output_buffer.data));
+	mu_check(graph.graph.memory_plan->buffer_count == 4);
+
+	TestGraph_destroy(&graph);
+
+	mu_check(test_graph_check_outputs(defs, def_count));
+}
+
+
+MU_TEST(test_GraphMemoryPlan_view) {
+	static const TestGraphNodeDefinition defs[] = {
+		{ "src", &test_graph_source_node_delegate, 0, 0, 1 },
+		{ "base", &test_graph_add_node_delegate, "src", "src", 0 },
+		{ "view", &test_graph_view_node_delegate, "base", 0, 0 },
+		{ "view-of-view", &test_graph_view_node_delegate, "view", 0, 0 },
+		{ "view-out", &test_graph_add_node_delegate, "view-of-view", 0, 0 },
+		{ "other", &test_graph_source_node_delegate, 0, 0, 10 },
+		{ "other-1", &test_graph_add_node_delegate, "other", "other", 0 },
+		{ "other-2", &test_graph_add_node_delegate, "other-1", "other-1", 0 },
+		{ "other-3", &test_graph_add_node_delegate, "other-2", "other-2", 0 },
+		{ "other-4", &test_graph_add_node_delegate, "other-3", "other-3", 0 }
+	};
+	const size_t def_count = sizeof(defs) / sizeof(defs[0]);
+
+	TestGraph graph;
+	mu_check(TestGraph_init(&graph, defs, def_count, true));
+
+	// The buffer of base lives until view-out reads view-of-view, its view
+	Graph_update(&(graph.graph));
+
+	Node* base = TestGraph_find(&graph, "base");
+	mu_check(TestGraph_find(&graph, "view-of-view")->output_buffer.data == base->output_buffer.data + base->output_buffer.row_stride * 2);
+	mu_check(TestGraph_find(&graph, "other-3")->output_buffer.data != base->output_buffer.data);
+	mu_check(TestGraph_find(&graph, "other-4")->output_buffer.data != base->output_buffer.data);
+
+	// A view is not a planned buffer, the node reading it can not run in place
+	mu_check(!TestGraph_find(&graph, "view-out")->is_in_place);
+
+	TestGraph_destroy(&graph);
+
+	mu_check(test_graph_check_outputs(defs, def_count));
+}
+
+
+MU_TEST(test_GraphMemoryPlan_unread_view) {
+	static const TestGraphNodeDefinition defs[] = {
+		{ "src", &test_graph_source_node_delegate, 0, 0, 1 },
+		{ "base", &test_graph_add_node_delegate, "src", "src", 0 },
+		{ "view", &test_graph_view_node_delegate, "base", 0, 0 },
+		{ "x", &test_graph_add_node_delegate, "src", "src", 0 },
+		{ "y", &test_graph_add_node_delegate, "x", "x", 0 },
+		{ "z", &test_graph_add_node_delegate, "y", "y", 0 }
+	};
+	const size_t def_count = sizeof(defs) / sizeof(defs[0]);
+
+	TestGraph graph;
+	mu_check(TestGraph_init(&graph, defs, def_count, true));
+
+	// A view read by no node is read by the host, its storage stays alive
+	mu_check(!TestGraph_shares_buffer(&graph, "base"));
+
+	TestGraph_destroy(&graph);
+
+	mu_check(test_graph_check_outputs(defs, def_count));
+}
+
+
+MU_TEST(test_GraphMemoryPlan_unread_output) {
+	static const TestGraphNodeDefinition defs[] = {
+		{ "src", &test_graph_source_node_delegate, 0, 0, 1 },
+		{ "unread", &test_graph_add_node_delegate, "src", "src", 0 },
+		{ "x", &test_graph_add_node_delegate, "src", 0, 0 },
+		{ "y", &test_graph_add_node_delegate, "x", "x", 0 },
+		{ "z", &test_graph_add_node_delegate, "y", "y", 0 },
+		{ "w", &test_graph_add_node_delegate, "z", "z", 0 }
+	};
+	const size_t def_count = sizeof(defs) / sizeof(defs[0]);
+
+	TestGraph graph;
+	mu_check(TestGraph_init(&graph, defs, def_count, true));
+
+	// An output read by no node keeps its buffer, the other ones are reused
+	mu_check(!TestGraph_shares_buffer(&graph, "unread"));
+	mu_check(TestGraph_shares_buffer(&graph, "x"));
+
+	TestGraph_destroy(&graph);
+
+	mu_check(test_graph_check_outputs(defs, def_count));
+}
+
+
+MU_TEST(test_GraphMemoryPlan_static_input) {
+	static const TestGraphNodeDefinition defs[] = {
+		{ "src", &test_graph_source_node_delegate, 0, 0, 1 },
+		{ "constant", &test_graph_constant_node_delegate, 0, 0, 5 },
+		{ "static", &test_graph_add_node_delegate, "constant", 0, 0 },
+		{ "s", &test_graph_add_node_delegate, "src", "src", 0 },
+		{ "x", &test_graph_add_node_delegate, "s", "static", 0 },
+		{ "y", &test_graph_add_node_delegate, "static", "x", 0 },
+		{ "z", &test_graph_add_node_delegate, "y", "y", 0 }
+	};
+	const size_t def_count = sizeof(defs) / sizeof(defs[0]);
+
+	TestGraph graph;
+	mu_check(TestGraph_init(&graph, defs, def_count, true));
+
+	// A static output is computed once, and keeps its buffer
+	Node* static_node = TestGraph_find(&graph, "static");
+	mu_check(!TestGraph_shares_buffer(&graph, "static"));
+	mu_check(!TestGraph_find(&graph, "y")->is_in_place);
+
+	// As its other input never changes, x is updated whenever s is, and can
+	// overwrite the output of s
+	mu_check(TestGraph_find(&graph, "x")->is_in_place);
+
+	for(size_t i = 0; i < TEST_GRAPH_FRAME_COUNT; ++i)
+		Graph_update(&(graph.graph));
+
+	mu_check(static_node->version == 1);
+	mu_check(TestGraph_find(&graph, "z")->version == TEST_GRAPH_FRAME_COUNT);
+
+	TestGraph_destroy(&graph);
+
+	mu_check(test_graph_check_outputs(defs, def_count));
+}
+
+
+MU_TEST(test_Graph_fuse_element_wise_nodes) {
+	static const TestGraphNodeDefinition defs[] = {
+		{ "src", &test_graph_source_node_delegate, 0, 0, 1 },
+		{ "a", &test_graph_affine_node_delegate, "src", 0, 2 },
+		{ "b", &test_graph_affine_node_delegate, "a", 0, 3 },
+		{ "c", &test_graph_affine_node_delegate, "b", 0, -1 },
+		{ "fan", &test_graph_affine_node_delegate, "c", 0, 2 },
+		{ "fan2", &test_graph_affine_node_delegate, "c", 0, 3 },
+		{ "sum", &test_graph_add_node_delegate, "fan", "fan2", 0 },
+		{ "after", &test_graph_affine_node_delegate, "sum", 0, 2 },
+		{ "tail", &test_graph_affine_node_delegate, "after", 0, -3 }
+	};
+	const size_t def_count = sizeof(defs) / sizeof(defs[0]);
+
+	TestGraph graph;
+	mu_check(TestGraph_init(&graph, defs, def_count, true));
+
+	Node* a = TestGraph_find(&graph, "a");
+	Node* after = TestGraph_find(&graph, "after");
+
+	// The source keeps its buffer, thus a heads the chain a, b, c
+	mu_check(!a->is_in_place);
+	mu_check(!a->fusion_head);
+	mu_check(TestGraph_find(&graph, "b")->fusion_head == a);
+	mu_check(TestGraph_find(&graph, "c")->fusion_head == a);
+	mu_check(a->element_wise_op_count == 6);
+
+	// The readers of an output read twice do not run in place
+	mu_check(!TestGraph_find(&graph, "fan")->is_in_place);
+	mu_check(!TestGraph_find(&graph, "fan")->fusion_head);
+	mu_check(!TestGraph_find(&graph, "fan2")->fusion_head);
+
+	// A node running in place on a node without element-wise operations
+	// heads a new chain
+	mu_check(after->is_in_place);
+	mu_check(!after->fusion_head);
+	mu_check(TestGraph_find(&graph, "tail")->fusion_head == after);
+	mu_check(after->element_wise_op_count == 4);
+
+	TestGraph_destroy(&graph);
+
+	mu_check(test_graph_check_outputs(defs, def_count));
+}
+
+
+// --- GraphPipeline testing -------------------------------------------------
+
+#define TEST_GRAPH_PIPELINE_FRAME_COUNT 16
+
+
+MU_TEST(test_GraphPipeline_acquire) {
+	static const TestGraphNodeDefinition defs[] = {
+		{ "counter", &test_graph_counter_node_delegate, 0, 0, 1 },
+		{ "x", &test_graph_add_node_delegate, "counter", 0, 0 },
+		{ "y", &test_graph_add_node_delegate, "x", "counter", 0 }
+	};
+	const size_t def_count = sizeof(defs) / sizeof(defs[0]);
+
+	for(size_t depth = 1; depth <= 2; ++depth) {
+		TestGraph reference;
+		TestGraph pipelined;
+		mu_check(TestGraph_init(&reference, defs, def_count, true));
+		mu_check(TestGraph_init(&pipelined, defs, def_count, true));
+		mu_check(Graph_set_pipeline_depth(&(pipelined.graph), depth));
+		mu_check(pipelined.graph.pipeline->source_count == 1);
+
+		Node* counter = TestGraph_find(&pipelined, "counter");
+		Node* y = TestGraph_find(&pipelined, "y");
+
+		// Each frame reads the next frame of the source, and updates its readers
+		for(size_t frame = 0; frame < TEST_GRAPH_PIPELINE_FRAME_COUNT; ++frame) {
+			Graph_update(&(reference.graph));
+			Graph_update(&(pipelined.graph));
+
+			mu_check(counter->version == frame + 1);
+			mu_check(y->version == frame + 1);
+
+			for(size_t i = 0; i < def_count; ++i)
+				mu_check(test_graph_matrix_equals(
+					Node_output(TestGraph_find(&reference, defs[i].name)).matrix,
+					Node_output(TestGraph_find(&pipelined, defs[i].name)).matrix
+				));
+		}
+
+		// Stop the pipeline once the producer filled all the slots ahead
+		GraphPipeline* pipeline = pipelined.graph.pipeline;
+		for(int i = 0; (i < 1000) && (SDL_SemValue(pipeline->ready_slots) < depth); ++i)
+			SDL_Delay(1);
+
+		mu_check(SDL_SemValue(pipeline->ready_slots) == depth);
+		mu_check(Graph_set_pipeline_depth(&(pipelined.graph), 0));
+		mu_check(!pipelined.graph.pipeline);
+		mu_check(!counter->latched_output);
+
+		// The source is updated by the graph again, past the frames dropped
+		// with the slots
+		Graph_update(&(pipelined.graph));
+		mu_check(counter->version == TEST_GRAPH_PIPELINE_FRAME_COUNT + 1);
+		mu_check(y->version == TEST_GRAPH_PIPELINE_FRAME_COUNT + 1);
+		mu_check(*((int64_t*)counter->data) == (int64_t)(TEST_GRAPH_PIPELINE_FRAME_COUNT + depth + 1));
+
+		// Destroy the graph while the producer runs ahead
+		mu_check(Graph_set_pipeline_depth(&(pipelined.graph), depth));
+		Graph_update(&(pipelined.graph));
+
+		TestGraph_destroy(&pipelined);
+		TestGraph_destroy(&reference);
+	}
+}
+
+
+// --- Node update tracking testing ------------------------------------------
+
+MU_TEST(test_Node_is_outdated) {
+	Node* src = Node_new("src", &test_graph_source_node_delegate, 0);
+	Node* constant = Node_new("constant", &test_graph_constant_node_delegate, 0);
+	Node* add = Node_new("add", &test_graph_add_node_delegate, 0);
+	Node_set_input_by_name(add, "a", src);
+
+	// A node without update method never is outdated, a stateful one always is
+	mu_check(!Node_is_outdated(constant));
+	mu_check(Node_is_outdated(src));
+	Node_mark_updated(src);
+	mu_check(Node_is_outdated(src));
+
+	// A stateless node is outdated until updated from its current inputs
+	mu_check(Node_is_outdated(add));
+	Node_mark_updated(add);
+	mu_check(!Node_is_outdated(add));
+
+	Node_mark_updated(src);
+	mu_check(Node_is_outdated(add));
+	Node_mark_updated(add);
+	mu_check(!Node_is_outdated(add));
+	mu_check(add->version == 2);
+
+	// Connecting the optional input makes it outdated, until updated again
+	Node_set_input_by_name(add, "b", constant);
+	mu_check(Node_is_outdated(add));
+	Node_mark_updated(add);
+	mu_check(!Node_is_outdated(add));
+
+	// Release ressources, the nodes were not set up
+	Node* nodes[] = { add, constant, src };
+	for(size_t i = 0; i < sizeof(nodes) / sizeof(nodes[0]); ++i) {
+		Node_destroy(nodes[i]);
+		free(nodes[i]);
+	}
+}
+
+
 // --- Main entry point ------------------------------------------------------
 
 MU_TEST_SUITE(test_TreeMap_suite) {
@@ -181,6 +1215,33 @@ MU_TEST_SUITE(test_StringList_suite) {
 }
 
 
+MU_TEST_SUITE(test_ThreadPool_suite) {
+	MU_RUN_TEST(test_ThreadPool_parallel_for);
+}
+
+
+MU_TEST_SUITE(test_RingWriter_suite) {
+	MU_RUN_TEST(test_RingWriter_push);
+}
+
+
+MU_TEST_SUITE(test_GraphPipeline_suite) {
+	MU_RUN_TEST(test_GraphPipeline_acquire);
+}
+
+
+MU_TEST_SUITE(test_GraphMemoryPlan_suite) {
+	MU_RUN_TEST(test_GraphMemoryPlan_chain);
+	MU_RUN_TEST(test_GraphMemoryPlan_diamond);
+	MU_RUN_TEST(test_GraphMemoryPlan_view);
+	MU_RUN_TEST(test_GraphMemoryPlan_unread_view);
+	MU_RUN_TEST(test_GraphMemoryPlan_unread_output);
+	MU_RUN_TEST(test_GraphMemoryPlan_static_input);
+	MU_RUN_TEST(test_Graph_fuse_element_wise_nodes);
+	MU_RUN_TEST(test_Node_is_outdated);
+}
+
+
 int
 main(
 	ATTRIBUTE_UNUSED int argc,
@@ -188,6 +1249,10 @@ main(
 ) {
 	MU_RUN_SUITE(test_TreeMap_suite);
 	MU_RUN_SUITE(test_StringList_suite);
+	MU_RUN_SUITE(test_ThreadPool_suite);
+	MU_RUN_SUITE(test_RingWriter_suite);
+	MU_RUN_SUITE(test_GraphMemoryPlan_suite);
+	MU_RUN_SUITE(test_GraphPipeline_suite);
 	MU_REPORT();
 	return MU_EXIT_CODE;
 }
@@ -11,8 +11,15 @@ extern "C" {
 typedef struct {
 	bool dry_run;
 	bool profile_mode;
+	bool perf_counters;
 	int frames_per_second;
 	int timeout;
+	int benchmark_frame_count;
+	int thread_count;
+	int pipeline_depth;
+	bool fast_math;
+	char* trace_path;
+	char* offline_path;
 	char* input_path;
 } CmdParameters;
 
@@ -0,0 +1,114 @@
+#ifndef PESTACLE_FRAME_WRITER_H
+#define PESTACLE_FRAME_WRITER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/******************************************************************************
+  Background writer of the frames displayed by the windows. The main thread
+  copies a window surface into a free slot of a ring (see RingWriter), and a
+  writer thread saves the slot as a binary PPM picture, named after the
+  window and the frame index. The main thread only waits when all the slots
+  are pending, so that no frame is ever dropped.
+ *****************************************************************************/
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <SDL.h>
+#include <pestacle/ring_writer.h>
+
+
+#define FRAME_WRITER_DEFAULT_SLOT_COUNT 8
+
+
+typedef struct {
+	const char* name;
+	size_t frame_index;
+	int width;
+	int height;
+	uint32_t* pixels;   // width x height pixels, SDL_PIXELFORMAT_RGB888
+	size_t pixel_capacity;
+} FrameWriterSlot;
+
+
+typedef struct {
+	char* dir_path;
+
+	size_t slot_count;
+	FrameWriterSlot* slots;
+
+	uint8_t* row_buffer;   // Used by the writer thread only
+	size_t row_capacity;
+
+	RingWriter ring;
+} FrameWriter;
+
+
+/*
+ * Initialize a writer saving its pictures to the directory dir_path, and
+ * start its writer thread.
+ *
+ * Returns false if the writer thread could not be started
+ */
+
+extern bool
+FrameWriter_init(
+	FrameWriter* self,
+	const char* dir_path,
+	size_t slot_count
+);
+
+
+/*
+ * Wait until the pending frames are saved, then stop the writer thread
+ */
+
+extern void
+FrameWriter_destroy(
+	FrameWriter* self
+);
+
+
+/*
+ * Queue a copy of the surface of a window, in SDL_PIXELFORMAT_RGB888, to be
+ * saved as <dir_path>/<name>-<frame_index>.ppm. The name should remain valid
+ * until the writer is destroyed. Waits for a free slot if needed.
+ */
+
+extern void
+FrameWriter_push(
+	FrameWriter* self,
+	const SDL_Surface* surface,
+	const char* name,
+	size_t frame_index
+);
+
+
+/*
+ * Wait until the pending frames are saved
+ */
+
+extern void
+FrameWriter_wait(
+	FrameWriter* self
+);
+
+
+/*
+ * Number of frames which could not be saved so far
+ */
+
+extern size_t
+FrameWriter_error_count(
+	FrameWriter* self
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PESTACLE_FRAME_WRITER_H */
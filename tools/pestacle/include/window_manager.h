@@ -31,13 +31,20 @@ struct s_WindowEventListener {
 
 struct s_Window {
 	Window* next;
-	SDL_Window* window;
+	char* name;
+	SDL_Window* window;   // 0 for an offscreen window
 	SDL_Surface* surface;
 	SDL_Renderer* renderer;
 	WindowEventListener* listener_head;
 }; // struct s_Window
 
 
+extern bool
+Window_is_offscreen(
+	const Window* self
+);
+
+
 extern void
 Window_set_bordered(
 	Window* self,
@@ -57,6 +64,7 @@ Window_add_event_listener(
 
 typedef struct {
 	Window* head;
+	bool is_offscreen;
 } WindowManager;
 
 
@@ -66,6 +74,17 @@ WindowManager_init(
 );
 
 
+/*
+ * Create the windows added from now on as offscreen surfaces, which are never
+ * shown and receive no event. Does not require the SDL video subsystem.
+ */
+
+extern void
+WindowManager_set_offscreen(
+	WindowManager* self
+);
+
+
 extern void
 WindowManager_destroy(
 	WindowManager* self
@@ -75,6 +94,7 @@ WindowManager_destroy(
 extern Window*
 WindowManager_add_window(
 	WindowManager* self,
+	const char* name,
 	const char* title,
 	int width,
 	int height
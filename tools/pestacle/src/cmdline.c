@@ -13,8 +13,15 @@ CmdParameters_init(
 ) {
 	self->dry_run = false;
 	self->profile_mode = false;
+	self->perf_counters = false;
 	self->frames_per_second = 60;
 	self->timeout = 0;
+	self->benchmark_frame_count = 0;
+	self->thread_count = 1;
+	self->pipeline_depth = 0;
+	self->fast_math = false;
+	self->trace_path = 0;
+	self->offline_path = 0;
 	self->input_path = 0;
 }
 
@@ -23,6 +30,12 @@ void
 CmdParameters_destroy(
 	CmdParameters* self
 ) {
+	if (self->trace_path)
+		free(self->trace_path);
+
+	if (self->offline_path)
+		free(self->offline_path);
+
 	if (self->input_path)
 		free(self->input_path);
 }
@@ -40,8 +53,15 @@ CmdParameters_parse(
 	struct arg_lit*  help;
 	struct arg_lit*  dry_run;
 	struct arg_lit*  profile_mode;
+	struct arg_lit*  perf_counters;
 	struct arg_int*  frames_per_second;
 	struct arg_int*  timeout;
+	struct arg_int*  benchmark;
+	struct arg_int*  thread_count;
+	struct arg_int*  pipeline_depth;
+	struct arg_lit*  fast_math;
+	struct arg_file* trace;
+	struct arg_file* offline;
 	struct arg_file* file;
 	struct arg_end*  end;
 
@@ -49,8 +69,15 @@ CmdParameters_parse(
 		help              = arg_litn( NULL,       "help",           0, 1, "display this help and exit"),
 		dry_run           = arg_litn( NULL,       "dry-run",        0, 1, "load but do not execute the script"),
 		profile_mode      = arg_litn( NULL,       "profile",        0, 1, "enable profiling of the executed script"),
+		perf_counters     = arg_litn( NULL,       "perf-counters",  0, 1, "profile with the hardware performance counters (Linux only)"),
 		frames_per_second = arg_intn( NULL,       "fps",     "<n>", 0, 1, "frames per seconds"),
 		timeout           = arg_intn( NULL,       "timeout", "<n>", 0, 1, "stops after specified number of seconds"),
+		benchmark         = arg_intn( NULL,       "benchmark", "<n>", 0, 1, "run n frames headless and as fast as possible, then print a report"),
+		thread_count      = arg_intn( NULL,       "threads", "<n>", 0, 1, "number of threads updating the graph, 0 for one per CPU"),
+		pipeline_depth    = arg_intn( NULL,       "pipeline-depth", "<n>", 0, 1, "number of frames the sources run ahead of the graph, 0 to disable"),
+		fast_math         = arg_litn( NULL,       "fast-math",      0, 1, "use fast approximations of exp, log and pow"),
+		trace             = arg_filen(NULL,       "trace",   "<file>", 0, 1, "save a timeline of the updates as a Chrome trace"),
+		offline           = arg_filen(NULL,       "offline", "<dir>", 0, 1, "render the --timeout seconds as fast as possible, saving the frames to dir"),
 		file              = arg_filen(NULL, NULL, "<file>",         1, 1, "input script"),
 		end               = arg_end(20),
 	};
@@ -85,6 +112,12 @@ CmdParameters_parse(
 	if (profile_mode->count > 0)
 		self->profile_mode = true;
 
+	// Read performance counters flag, which implies profiling
+	if (perf_counters->count > 0) {
+		self->profile_mode = true;
+		self->perf_counters = true;
+	}
+
 	// Read frame per seconds
 	if (frames_per_second->count > 0)
 		self->frames_per_second = frames_per_second->ival[0];
@@ -93,6 +126,70 @@ CmdParameters_parse(
 	if (timeout->count > 0)
 		self->timeout = timeout->ival[0];
 
+	// Read benchmark frame count, benchmarking implies profiling
+	if (benchmark->count > 0) {
+		if (benchmark->ival[0] <= 0) {
+			printf("%s: benchmark frame count must be positive\n", prog_name);
+			arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+			return false;
+		}
+
+		self->benchmark_frame_count = benchmark->ival[0];
+		self->profile_mode = true;
+	}
+
+	// Read thread count
+	if (thread_count->count > 0) {
+		if (thread_count->ival[0] < 0) {
+			printf("%s: thread count must be positive or zero\n", prog_name);
+			arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+			return false;
+		}
+
+		self->thread_count = thread_count->ival[0];
+	}
+
+	// Read pipeline depth
+	if (pipeline_depth->count > 0) {
+		if (pipeline_depth->ival[0] < 0) {
+			printf("%s: pipeline depth must be positive or zero\n", prog_name);
+			arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+			return false;
+		}
+
+		self->pipeline_depth = pipeline_depth->ival[0];
+	}
+
+	// Read fast math flag
+	if (fast_math->count > 0)
+		self->fast_math = true;
+
+	// Read trace file path
+	if (trace->count > 0) {
+		size_t trace_path_len = strlen(trace->filename[0]) + 1;
+		self->trace_path = (char*)checked_malloc(trace_path_len * sizeof(char));
+		memcpy(self->trace_path, trace->filename[0], trace_path_len * sizeof(char));
+	}
+
+	// Read offline rendering directory, which requires a duration
+	if (offline->count > 0) {
+		if (self->timeout <= 0) {
+			printf("%s: offline rendering requires a positive timeout\n", prog_name);
+			arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+			return false;
+		}
+
+		if (self->benchmark_frame_count) {
+			printf("%s: offline rendering and benchmark are exclusive\n", prog_name);
+			arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+			return false;
+		}
+
+		size_t offline_path_len = strlen(offline->filename[0]) + 1;
+		self->offline_path = (char*)checked_malloc(offline_path_len * sizeof(char));
+		memcpy(self->offline_path, offline->filename[0], offline_path_len * sizeof(char));
+	}
+
 	// Read input file path
 	size_t input_path_len = strlen(file->filename[0]) + 1;
 	self->input_path = (char*)checked_malloc(input_path_len * sizeof(char));
@@ -0,0 +1,246 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <pestacle/memory.h>
+#include <pestacle/strings.h>
+#include "frame_writer.h"
+
+
+// --- Implementation ---------------------------------------------------------
+
+static bool
+FrameWriter_save_slot(
+	FrameWriter* self,
+	const FrameWriterSlot* slot
+) {
+	// Build the path of the picture
+	int path_len = snprintf(
+		0,
+		0,
+		"%s/%s-%06zu.ppm",
+		self->dir_path,
+		slot->name,
+		slot->frame_index
+	);
+
+	char* path = (char*)checked_malloc(((size_t)path_len + 1) * sizeof(char));
+	snprintf(
+		path,
+		(size_t)path_len + 1,
+		"%s/%s-%06zu.ppm",
+		self->dir_path,
+		slot->name,
+		slot->frame_index
+	);
+
+	// Open the file
+	FILE* fp = fopen(path, "wb");
+	if (!fp) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Could not open file %s for writing",
+			path
+		);
+		free(path);
+		return false;
+	}
+
+	// Write the header, then the pixels one row at a time
+	bool ret = fprintf(fp, "P6\n%d %d\n255\n", slot->width, slot->height) > 0;
+
+	const uint32_t* src = slot->pixels;
+	for(int i = slot->height; (i != 0) && ret; --i) {
+		uint8_t* dst = self->row_buffer;
+		for(int j = slot->width; j != 0; --j, ++src, dst += 3) {
+			dst[0] = (uint8_t)((*src) >> 16);
+			dst[1] = (uint8_t)((*src) >> 8);
+			dst[2] = (uint8_t)(*src);
+		}
+
+		ret = fwrite(self->row_buffer, 3, (size_t)slot->width, fp) == (size_t)slot->width;
+	}
+
+	ret &= (fclose(fp) == 0);
+
+	if (!ret)
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"Could not write frame to file %s",
+			path
+		);
+
+	// Job done
+	free(path);
+	return ret;
+}
+
+
+typedef struct {
+	const SDL_Surface* surface;
+	const char* name;
+	size_t frame_index;
+} FrameWriterItem;
+
+
+static void
+FrameWriter_copy_slot(
+	void* caller,
+	void* slot,
+	const void* item
+) {
+	(void)caller;
+
+	FrameWriterSlot* dst = (FrameWriterSlot*)slot;
+	const FrameWriterItem* src = (const FrameWriterItem*)item;
+	const SDL_Surface* surface = src->surface;
+
+	// Copy the surface
+	size_t pixel_count = (size_t)surface->w * (size_t)surface->h;
+	if (pixel_count > dst->pixel_capacity) {
+		free(dst->pixels);
+		dst->pixels = (uint32_t*)checked_malloc(pixel_count * sizeof(uint32_t));
+		dst->pixel_capacity = pixel_count;
+	}
+
+	dst->name = src->name;
+	dst->frame_index = src->frame_index;
+	dst->width = surface->w;
+	dst->height = surface->h;
+
+	const uint8_t* src_row = (const uint8_t*)surface->pixels;
+	uint32_t* dst_row = dst->pixels;
+	size_t row_len = (size_t)surface->w * sizeof(uint32_t);
+	for(int i = surface->h; i != 0; --i, src_row += surface->pitch, dst_row += surface->w)
+		memcpy(dst_row, src_row, row_len);
+}
+
+
+static bool
+FrameWriter_write_slot(
+	void* caller,
+	void* slot
+) {
+	FrameWriter* self = (FrameWriter*)caller;
+	const FrameWriterSlot* src = (const FrameWriterSlot*)slot;
+
+	size_t row_len = 3 * (size_t)src->width;
+	if (row_len > self->row_capacity) {
+		free(self->row_buffer);
+		self->row_buffer = (uint8_t*)checked_malloc(row_len);
+		self->row_capacity = row_len;
+	}
+
+	return FrameWriter_save_slot(self, src);
+}
+
+
+static void
+FrameWriter_free_slots(
+	FrameWriter* self
+) {
+	for(size_t i = 0; i < self->slot_count; ++i)
+		free(self->slots[i].pixels);
+
+	free(self->slots);
+	free(self->row_buffer);
+	free(self->dir_path);
+}
+
+
+bool
+FrameWriter_init(
+	FrameWriter* self,
+	const char* dir_path,
+	size_t slot_count
+) {
+	assert(self);
+	assert(dir_path);
+	assert(slot_count > 0);
+
+	// Initialize members
+	self->dir_path = strclone(dir_path);
+
+	self->slot_count = slot_count;
+	self->slots = (FrameWriterSlot*)checked_malloc(slot_count * sizeof(FrameWriterSlot));
+	for(size_t i = 0; i < slot_count; ++i) {
+		self->slots[i].name = 0;
+		self->slots[i].pixels = 0;
+		self->slots[i].pixel_capacity = 0;
+	}
+
+	self->row_buffer = 0;
+	self->row_capacity = 0;
+
+	// Start the writer thread
+	if (!RingWriter_init(
+		&(self->ring),
+		self->slots,
+		slot_count,
+		sizeof(FrameWriterSlot),
+		RingWriterPolicy__block,
+		FrameWriter_copy_slot,
+		FrameWriter_write_slot,
+		self,
+		"pestacle-writer"
+	)) {
+		FrameWriter_free_slots(self);
+		return false;
+	}
+
+	// Job done
+	return true;
+}
+
+
+void
+FrameWriter_destroy(
+	FrameWriter* self
+) {
+	assert(self);
+
+	RingWriter_destroy(&(self->ring));
+	FrameWriter_free_slots(self);
+
+	#ifdef DEBUG
+	self->slots = 0;
+	self->row_buffer = 0;
+	self->dir_path = 0;
+	#endif
+}
+
+
+void
+FrameWriter_push(
+	FrameWriter* self,
+	const SDL_Surface* surface,
+	const char* name,
+	size_t frame_index
+) {
+	assert(self);
+	assert(surface);
+	assert(surface->format->BytesPerPixel == 4);
+	assert(name);
+
+	FrameWriterItem item = { surface, name, frame_index };
+	RingWriter_push(&(self->ring), &item);
+}
+
+
+void
+FrameWriter_wait(
+	FrameWriter* self
+) {
+	assert(self);
+
+	RingWriter_wait(&(self->ring));
+}
+
+
+size_t
+FrameWriter_error_count(
+	FrameWriter* self
+) {
+	assert(self);
+
+	return RingWriter_failed_count(&(self->ring));
+}
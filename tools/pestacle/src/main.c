@@ -2,18 +2,29 @@
 #include <errno.h>
 #include <SDL.h>
 
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
 #include <pestacle/macros.h>
 #include <pestacle/graph.h>
 #include <pestacle/scope.h>
 #include <pestacle/memory.h>
+#include <pestacle/thread_pool.h>
 #include <pestacle/plugin_manager.h>
 #include <pestacle/parser/parser.h>
 #include <pestacle/parser/scope_populate.h>
+#include <pestacle/math/array_ops.h>
+#include <pestacle/math/array_ops_backend.h>
 
 
 #include "cmdline.h"
 #include "root/scope.h"
 #include "window_manager.h"
+#include "frame_writer.h"
 
 
 static void
@@ -120,8 +131,13 @@ initialization_log() {
 		bool_str[SDL_HasNEON()]
 	);
 
+	SDL_Log(
+		"array operations backend => %s",
+		array_ops_get_backend()->name
+	);
+
 	// Display informations
-	int display_count = SDL_GetNumVideoDisplays();
+	int display_count = SDL_WasInit(SDL_INIT_VIDEO) ? SDL_GetNumVideoDisplays() : 0;
 	SDL_Log(
 		"%d display(s) found",
 		display_count
@@ -151,6 +167,29 @@ initialization_log() {
 }
 
 
+// Peak resident memory of the process, in bytes, 0 if unknown
+static size_t
+get_peak_memory() {
+	#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+
+	return (size_t)counters.PeakWorkingSetSize;
+	#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage))
+		return 0;
+
+	#if defined(__APPLE__)
+	return (size_t)usage.ru_maxrss;
+	#else
+	return 1024 * (size_t)usage.ru_maxrss;
+	#endif
+	#endif
+}
+
+
 static bool
 load_plugins(
 	PluginManager* plugin_manager,
@@ -218,8 +257,12 @@ main(int argc, char* argv[]) {
 	Scope* root_scope = 0;
 	Graph* graph = 0;
 	GraphProfile* graph_profile = 0;
+	Trace* trace = 0;
+	PerfCounters* perf_counters = 0;
+	ThreadPool* thread_pool = 0;
 	PluginManager* plugin_manager = 0;
 	WindowManager* window_manager = 0;
+	FrameWriter* frame_writer = 0;
 
 	CmdParameters params;
 	int exit_code = EXIT_SUCCESS;
@@ -232,8 +275,14 @@ main(int argc, char* argv[]) {
 	if (!CmdParameters_parse(&params, argc, argv))
 		return EXIT_FAILURE;
 	
-	// SDL initialization
-	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER | SDL_INIT_EVENTS)) {
+	// SDL initialization, benchmark and offline rendering run without display
+	bool is_headless = params.benchmark_frame_count || params.offline_path;
+
+	Uint32 sdl_flags = SDL_INIT_TIMER | SDL_INIT_EVENTS;
+	if (!is_headless)
+		sdl_flags |= SDL_INIT_VIDEO;
+
+	if (SDL_Init(sdl_flags)) {
 		SDL_LogError(
 			SDL_LOG_CATEGORY_SYSTEM,
 			"Unable to initialize SDL: %s",
@@ -245,6 +294,12 @@ main(int argc, char* argv[]) {
 	// Log initialization infos
 	initialization_log();
 
+	// Select the precision of the transcendental functions
+	if (params.fast_math) {
+		SDL_Log("using fast approximations of exp, log and pow");
+		array_ops_set_precision(ArrayOpsPrecision__fast);
+	}
+
 	// Initialize the plugin manager
 	plugin_manager = (PluginManager*)checked_malloc(sizeof(PluginManager));
 	PluginManager_init(plugin_manager);
@@ -253,6 +308,15 @@ main(int argc, char* argv[]) {
 	window_manager = (WindowManager*)checked_malloc(sizeof(WindowManager));
 	WindowManager_init(window_manager);
 
+	if (params.benchmark_frame_count)
+		SDL_Log("benchmarking %d frames, with offscreen windows", params.benchmark_frame_count);
+
+	if (params.offline_path)
+		SDL_Log("rendering %d seconds offline to %s", params.timeout, params.offline_path);
+
+	if (is_headless)
+		WindowManager_set_offscreen(window_manager);
+
 	// Initialize root scope
 	root_scope = Scope_new(
 		root_scope_delegate.name,
@@ -291,36 +355,97 @@ main(int argc, char* argv[]) {
 		goto termination;
 	}
 
-	// Setup graph profiling if required
-	if (params.profile_mode) {
+	// Setup the thread pool if required
+	size_t thread_count = (size_t)params.thread_count;
+	if (thread_count == 0)
+		thread_count = (size_t)SDL_GetCPUCount();
+
+	if (thread_count > 1) {
+		SDL_Log("updating the graph with %zu threads", thread_count);
+
+		thread_pool = (ThreadPool*)checked_malloc(sizeof(ThreadPool));
+		if (!ThreadPool_init(thread_pool, thread_count - 1)) {
+			free(thread_pool);
+			thread_pool = 0;
+			exit_code = EXIT_FAILURE;
+			goto termination;
+		}
+
+		Graph_set_thread_pool(graph, thread_pool);
+	}
+
+	// Setup the pipelined update of the sources if required
+	if ((params.pipeline_depth > 0) && (!params.dry_run)) {
+		SDL_Log("updating the sources %d frame(s) ahead", params.pipeline_depth);
+
+		if (!Graph_set_pipeline_depth(graph, (size_t)params.pipeline_depth)) {
+			exit_code = EXIT_FAILURE;
+			goto termination;
+		}
+	}
+
+	// Setup graph profiling if required, tracing relying on it
+	if (params.profile_mode || params.trace_path) {
 		graph_profile = (GraphProfile*)checked_malloc(sizeof(GraphProfile));
 		GraphProfile_init(graph_profile, graph);
+		GraphProfile_set_frame_period(graph_profile, ((real_t)1) / params.frames_per_second);
+	}
+
+	if (params.trace_path) {
+		trace = (Trace*)checked_malloc(sizeof(Trace));
+		Trace_init(trace, TRACE_DEFAULT_CAPACITY);
+		GraphProfile_set_trace(graph_profile, trace);
+	}
+
+	if (params.perf_counters) {
+		perf_counters = (PerfCounters*)checked_malloc(sizeof(PerfCounters));
+		if (PerfCounters_init(perf_counters))
+			GraphProfile_set_perf_counters(graph_profile, perf_counters);
+		else
+			SDL_Log("profiling without the performance counters");
 	}
 
 	// If we are in dry-run mode, terminate now
 	if (params.dry_run)
 		goto termination;
 
+	// Start saving the frames if rendering offline
+	if (params.offline_path) {
+		frame_writer = (FrameWriter*)checked_malloc(sizeof(FrameWriter));
+		if (!FrameWriter_init(frame_writer, params.offline_path, FRAME_WRITER_DEFAULT_SLOT_COUNT)) {
+			free(frame_writer);
+			frame_writer = 0;
+			exit_code = EXIT_FAILURE;
+			goto termination;
+		}
+	}
+
 	// Main processing loop
 	Uint64 performance_refresh_period =
 		SDL_GetPerformanceFrequency() / params.frames_per_second;
 
-	size_t timeout_frame_count =
+	size_t max_frame_count =
 		params.timeout * params.frames_per_second;
 
+	if (params.benchmark_frame_count)
+		max_frame_count = (size_t)params.benchmark_frame_count;
+
+	Uint64 loop_start_time = SDL_GetPerformanceCounter();
+
 	size_t frame_count = 0;
 	for(bool quit = false; !quit; frame_count += 1) {
 		Uint64 start_time = SDL_GetPerformanceCounter();
 
-		// Check if timeout reached
-		if ((params.timeout > 0) && (frame_count == timeout_frame_count)) {
+		// Check if timeout or frame count reached
+		if ((max_frame_count > 0) && (frame_count == max_frame_count)) {
 			quit = true;
 			continue;
 		}
 
-		// Event processing
+		// Event processing, none when rendering offline
+		Uint64 span_start_time = start_time;
 		SDL_Event event;
-		while (SDL_PollEvent(&event)) {
+		while ((!params.offline_path) && SDL_PollEvent(&event)) {
 			switch(event.type) {
 				case SDL_QUIT:
 					quit = true;
@@ -332,31 +457,105 @@ main(int argc, char* argv[]) {
 			}
 		}
 
+		if (trace) {
+			Uint64 span_end_time = SDL_GetPerformanceCounter();
+			Trace_record(trace, "events", span_start_time, span_end_time);
+			span_start_time = span_end_time;
+		}
+
 		// Graph update
-		if (params.profile_mode)
+		if (graph_profile)
 			Graph_update_with_profile(graph, graph_profile);
 		else
 			Graph_update(graph);
 
-		// Update all windows
+		if (trace) {
+			Uint64 span_end_time = SDL_GetPerformanceCounter();
+			Trace_record(trace, "graph update", span_start_time, span_end_time);
+			span_start_time = span_end_time;
+		}
+
+		// Update all windows, or queue their frames when rendering offline
 		WindowManager_update_windows(window_manager);
 
-		// Sleep
+		if (frame_writer)
+			for(Window* window = window_manager->head; window != 0; window = window->next)
+				FrameWriter_push(frame_writer, window->surface, window->name, frame_count);
+
+		// Sleep, unless running headless
 		Uint64 end_time = SDL_GetPerformanceCounter();
+		if (trace)
+			Trace_record(trace, "windows update", span_start_time, end_time);
+
 		Uint64 time_delta = end_time - start_time;
-		if (time_delta < performance_refresh_period)
+		if ((time_delta < performance_refresh_period) && (!is_headless)) {
 			SDL_Delay((1e3f * (performance_refresh_period - time_delta)) / SDL_GetPerformanceFrequency());
+			if (trace)
+				Trace_record(trace, "sleep", end_time, SDL_GetPerformanceCounter());
+		}
+	}
+
+	// Wait for the frames to be saved, then print the offline rendering speed
+	if (frame_writer) {
+		FrameWriter_wait(frame_writer);
+
+		real_t loop_time =
+			((real_t)(SDL_GetPerformanceCounter() - loop_start_time)) / SDL_GetPerformanceFrequency();
+
+		SDL_Log(
+			"rendered %zu frames in %.3f sec, %.1f times faster than real time",
+			max_frame_count,
+			loop_time,
+			params.timeout / loop_time
+		);
+
+		size_t error_count = FrameWriter_error_count(frame_writer);
+		if (error_count > 0) {
+			SDL_LogError(
+				SDL_LOG_CATEGORY_SYSTEM,
+				"%zu frame(s) could not be saved",
+				error_count
+			);
+			exit_code = EXIT_FAILURE;
+		}
+	}
+
+	// Print the benchmark results if required
+	if (params.benchmark_frame_count) {
+		real_t loop_time =
+			((real_t)(SDL_GetPerformanceCounter() - loop_start_time)) / SDL_GetPerformanceFrequency();
+
+		// The last iteration only checks for the frame count
+		size_t update_count = frame_count - 1;
+
+		fprintf(
+			stdout,
+			"%zu frames in %.3f sec, %.1f frames/s\n",
+			update_count,
+			loop_time,
+			update_count / loop_time
+		);
+
+		fprintf(
+			stdout,
+			"peak memory %.1f MB\n",
+			((real_t)get_peak_memory()) / (1024 * 1024)
+		);
 	}
 
 	// Print the profiling report if required
 	if (params.profile_mode)
 		GraphProfile_print_report(graph_profile, graph, stdout);
 
+	// Save the trace if required, while the node names are valid
+	if (trace && (!Trace_save(trace, params.trace_path)))
+		exit_code = EXIT_FAILURE;
+
 	// Free ressources
 termination:
-	if (root_scope) {
-		Scope_destroy(root_scope);
-		free(root_scope);
+	if (frame_writer) {
+		FrameWriter_destroy(frame_writer);
+		free(frame_writer);
 	}
 
 	if (graph) {
@@ -364,11 +563,31 @@ termination:
 		free(graph);
 	}
 
-	if (params.profile_mode && graph_profile) {
+	if (root_scope) {
+		Scope_destroy(root_scope);
+		free(root_scope);
+	}
+
+	if (thread_pool) {
+		ThreadPool_destroy(thread_pool);
+		free(thread_pool);
+	}
+
+	if (graph_profile) {
 		GraphProfile_destroy(graph_profile);
 		free(graph_profile);
 	}
 
+	if (trace) {
+		Trace_destroy(trace);
+		free(trace);
+	}
+
+	if (perf_counters) {
+		PerfCounters_destroy(perf_counters);
+		free(perf_counters);
+	}
+
 	if (plugin_manager) {
 		PluginManager_destroy(plugin_manager);
 		free(plugin_manager);
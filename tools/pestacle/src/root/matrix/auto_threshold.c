@@ -68,6 +68,7 @@ root_matrix_auto_threshold_node_delegate = {
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__none
 };
 
 
@@ -143,12 +144,13 @@ AutoThreshold_em_initialization(
 	for(int i = 0; i < 2; ++i)
 		AverageResult_init(&(avg[i]));
 
-	const real_t* coeff = input->data;
-	for(size_t i = 0; i < input->row_count; ++i)
+	for(size_t i = 0; i < input->row_count; ++i) {
+		const real_t* coeff = input->data + i * input->row_stride;
 		for(size_t j = 0; j < input->col_count; ++j, ++coeff) {
 			int k = fabs((*coeff) - coeff_min) > fabs((*coeff) - coeff_max);
 			AverageResult_accumulate(&(avg[k]), *coeff);
 		}
+	}
 
 	for(int i = 0; i < 2; ++i) {
 		self->mu[i] = AverageResult_mean(&(avg[i]));
@@ -176,14 +178,15 @@ AutoThreshold_weighted_em_initialization(
 	for(int i = 0; i < 2; ++i)
 		WeightedAverageResult_init(&(avg[i]));
 
-	const real_t* w = weight->data;
-	const real_t* coeff = input->data;
-	for(size_t i = 0; i < input->row_count; ++i)
+	for(size_t i = 0; i < input->row_count; ++i) {
+		const real_t* w = weight->data + i * weight->row_stride;
+		const real_t* coeff = input->data + i * input->row_stride;
 		for(size_t j = 0; j < input->col_count; ++j, ++coeff, ++w) {
 			int k = fabs((*coeff) - coeff_min) > fabs((*coeff) - coeff_max);
 			KahanSum_accumulate(&weight_sum, *w);
 			WeightedAverageResult_accumulate(&(avg[k]), *w, *coeff);
 		}
+	}
 	
 	for(int i = 0; i < 2; ++i) {
 		self->mu[i] = WeightedAverageResult_mean(&(avg[i]));
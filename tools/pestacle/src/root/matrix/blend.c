@@ -12,12 +12,6 @@ node_setup(
 );
 
 
-static void
-node_destroy(
-	Node* self
-);
-
-
 static void
 node_update(
 	Node* self
@@ -66,10 +60,11 @@ root_matrix_blend_node_delegate = {
 	node_parameters,
 	{
 		node_setup,
-		node_destroy,
+		0,
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__stateless
 };
 
 
@@ -97,39 +92,17 @@ node_setup(
 		&(self->in_descriptors[MASK_INPUT]), width, height
 	);
 
-	// Allocate data
-	Matrix* data =
-		(Matrix*)checked_malloc(sizeof(Matrix));
-
-	if (!data)
-		return false;
-
-	// Setup data
-	Matrix_init(data, height, width);
-	Matrix_fill(data, (real_t)0);
-
 	// Setup output descriptor
 	DataDescriptor_set_as_matrix(&(self->out_descriptor), width, height);
 
+	// Request the output buffer
+	Node_request_output_buffer(self);
+
 	// Job done
-	self->data = data;
 	return true;
 }
 
 
-static void
-node_destroy(
-	Node* self
-) {
-	Matrix* data = (Matrix*)self->data;
-
-	if (data) {
-		Matrix_destroy(data);
-		free(data);
-	}
-}
-
-
 static void
 node_update(
 	Node* self
@@ -145,7 +118,7 @@ node_update(
 	const Matrix* mask =
 		Node_output(self->inputs[MASK_INPUT]).matrix;
 
-	Matrix* data = (Matrix*)self->data;
+	Matrix* data = &(self->output_buffer);
 
 	Matrix_copy(data, src_a);
 	Matrix_sub(data, src_b);
@@ -158,8 +131,6 @@ static NodeOutput
 node_output(
 	const Node* self
 ) {
-	const Matrix* data = (const Matrix*)self->data;
-
-	NodeOutput ret = { .matrix = data };
+	NodeOutput ret = { .matrix = &(self->output_buffer) };
 	return ret;
 }
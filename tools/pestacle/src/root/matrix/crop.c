@@ -11,12 +11,6 @@ node_setup(
 );
 
 
-static void
-node_destroy(
-	Node* self
-);
-
-
 static void
 node_update(
 	Node* self
@@ -79,10 +73,11 @@ root_matrix_crop_node_delegate = {
 	node_parameters,
 	{
 		node_setup,
-		node_destroy,
+		0,
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__stateless
 };
 
 
@@ -108,10 +103,6 @@ node_setup(
 	size_t output_width  = (size_t)self->parameters[WIDTH_PARAMETER].int64_value;
 	size_t output_height = (size_t)self->parameters[HEIGHT_PARAMETER].int64_value;
 
-	// Allocate
-	Matrix* data = (Matrix*)checked_malloc(sizeof(Matrix));
-	Matrix_init(data, output_height, output_width);
-
 	// Setup output descriptor
 	DataDescriptor_set_as_matrix(
 		&(self->out_descriptor),
@@ -119,19 +110,18 @@ node_setup(
 		output_height
 	);
 
-	// Job done
-	self->data = data;
-	return true;
-}
+	// A crop inside the input is a view on it, otherwise request the output
+	// buffer
+	int64_t x = self->parameters[X_PARAMETER].int64_value;
+	int64_t y = self->parameters[Y_PARAMETER].int64_value;
 
+	if ((x >= 0) && (y >= 0) && ((size_t)x + output_width <= input_width) && ((size_t)y + output_height <= input_height))
+		Node_request_output_view(self);
+	else
+		Node_request_output_buffer(self);
 
-static void
-node_destroy(
-	Node* self
-) {
-	Matrix* data = (Matrix*)self->data;
-	if (data)
-		Matrix_destroy(data);
+	// Job done
+	return true;
 }
 
 
@@ -140,7 +130,20 @@ node_update(
 	Node* self
 ) {
 	const Matrix* src = Node_output(self->inputs[SOURCE_INPUT]).matrix;
-	Matrix* dst = (Matrix*)self->data;
+	Matrix* dst = &(self->output_buffer);
+
+	// Point the view to the input, which may have moved since the last update
+	if (self->is_view) {
+		Matrix_init_view(
+			dst,
+			src,
+			(size_t)self->parameters[Y_PARAMETER].int64_value,
+			(size_t)self->parameters[X_PARAMETER].int64_value,
+			dst->row_count,
+			dst->col_count
+		);
+		return;
+	}
 
 	// Fill the output with zeros
 	Matrix_fill(dst, (real_t)0);
@@ -163,26 +166,28 @@ node_update(
 	if (x0 < 0)
 		x0 = 0;
 
-	if (x1 >= (int64_t)src->col_count)
-		x1 = src->col_count - 1;
+	if (x1 > (int64_t)src->col_count)
+		x1 = src->col_count;
 
 	if (y0 < 0)
 		y0 = 0;
 
-	if (y1 >= (int64_t)src->row_count)
-		y1 = src->row_count - 1;
+	if (y1 > (int64_t)src->row_count)
+		y1 = src->row_count;
 
 	// Copy input data
 	size_t width = (size_t)(x1 - x0);
 	size_t height = (size_t)(y1 - y0);
 
 	const real_t* src_data = src->data;
-	src_data += y0 * src->col_count;
+	src_data += y0 * src->row_stride;
 	src_data += x0;
 
 	real_t* dst_data = dst->data;
+	dst_data += (y0 - self->parameters[Y_PARAMETER].int64_value) * dst->row_stride;
+	dst_data += x0 - self->parameters[X_PARAMETER].int64_value;
 
-	for(size_t i = height; i != 0; --i, src_data += src->col_count, dst_data += dst->col_count)
+	for(size_t i = height; i != 0; --i, src_data += src->row_stride, dst_data += dst->row_stride)
 		array_ops_copy(dst_data, src_data, width);
 }
 
@@ -191,8 +196,6 @@ static NodeOutput
 node_output(
 	const Node* self
 ) {
-	Matrix* data = (Matrix*)self->data;
-
-	NodeOutput ret = { .matrix = data };
+	NodeOutput ret = { .matrix = &(self->output_buffer) };
 	return ret;
 }
@@ -45,6 +45,7 @@ node_inputs[] = {
 
 #define SIGMA_PARAMETER  0
 #define MODE_PARAMETER   1
+#define METHOD_PARAMETER 2
 
 static const ParameterDefinition
 node_parameters[] = {
@@ -58,6 +59,11 @@ node_parameters[] = {
 		"mode",
 		{ .string_value = "zero" }
 	},
+	{
+		ParameterType__string,
+		"method",
+		{ .string_value = "convolution" }
+	},
 	PARAMETER_DEFINITION_END
 };
 
@@ -73,13 +79,13 @@ root_matrix_gaussian_node_delegate = {
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__stateless
 };
 
 
 // --- Implementation ---------------------------------------------------------
 
 typedef struct {
-	Matrix out;
 	GaussianFilter filter;
 } GaussianData;
 
@@ -90,17 +96,16 @@ GaussianData_init(
 	size_t width,
 	size_t height,
 	real_t sigma,
-	enum GaussianFilterMode mode
+	enum GaussianFilterMode mode,
+	enum GaussianFilterMethod method
 ) {
-	Matrix_init(&(self->out), height, width);
-	Matrix_fill(&(self->out), (real_t)0);
-
 	GaussianFilter_init(
 		&(self->filter),
 		height,
 		width,
 		sigma,
-		mode
+		mode,
+		method
 	);
 }
 
@@ -109,7 +114,6 @@ static void
 GaussianData_destroy(
 	GaussianData* self
 ) {
-	Matrix_destroy(&(self->out));
 	GaussianFilter_destroy(&(self->filter));
 }
 
@@ -133,6 +137,7 @@ node_setup(
 	// Retrieve the parameters
 	real_t sigma = (real_t)self->parameters[SIGMA_PARAMETER].real_value;
 	char* mode_str = (char*)self->parameters[MODE_PARAMETER].string_value;
+	char* method_str = (char*)self->parameters[METHOD_PARAMETER].string_value;
 
 	// Check parameters validity
 	if (sigma <= __FLT_EPSILON__) {
@@ -158,6 +163,29 @@ node_setup(
 		return false;
 	}
 
+	enum GaussianFilterMethod method = GaussianFilterMethod__CONVOLUTION;
+	if (strcmp(method_str, "convolution") == 0) {
+		method = GaussianFilterMethod__CONVOLUTION;
+	}
+	else if (strcmp(method_str, "recursive") == 0) {
+		method = GaussianFilterMethod__RECURSIVE;
+	}
+	else {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"invalid method parameter"
+		);
+		return false;
+	}
+
+	if ((method == GaussianFilterMethod__RECURSIVE) && (sigma < (real_t).5)) {
+		SDL_LogError(
+			SDL_LOG_CATEGORY_SYSTEM,
+			"the recursive method requires a sigma parameter of at least 0.5"
+		);
+		return false;
+	}
+
 	// Allocate data
 	GaussianData* data =
 		(GaussianData*)checked_malloc(sizeof(GaussianData));
@@ -166,11 +194,14 @@ node_setup(
 		return false;
 
 	// Setup data
-	GaussianData_init(data, width, height, sigma, mode);
+	GaussianData_init(data, width, height, sigma, mode, method);
 
 	// Setup output descriptor
 	DataDescriptor_set_as_matrix(&(self->out_descriptor), width, height);
 
+	// Request the output buffer
+	Node_request_output_buffer(self);
+
 	// Job done
 	self->data = data;
 	return true;
@@ -197,13 +228,14 @@ node_update(
 	GaussianData* data = (GaussianData*)self->data;
 
 	Matrix_copy(
-		&(data->out),
+		&(self->output_buffer),
 		Node_output(self->inputs[SOURCE_INPUT]).matrix
 	);
 
-	GaussianFilter_transform(
+	GaussianFilter_parallel_transform(
 		&(data->filter),
-		&(data->out)
+		&(self->output_buffer),
+		self->thread_pool
 	);
 }
 
@@ -212,8 +244,6 @@ static NodeOutput
 node_output(
 	const Node* self
 ) {
-	const GaussianData* data = (const GaussianData*)self->data;
-
-	NodeOutput ret = { .matrix = &(data->out) };
+	NodeOutput ret = { .matrix = &(self->output_buffer) };
 	return ret;
 }
@@ -61,6 +61,7 @@ root_matrix_gradient_map_node_delegate = {
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__stateless
 };
 
 
@@ -132,9 +133,10 @@ node_update(
 		(SDL_Surface*)self->data;
 
 	// Compute the output
-	const real_t* coeff = src->data;
+	const real_t* coeff_row = src->data;
 	uint8_t* pixel_row = (uint8_t*)dst->pixels;
-	for(int i = dst->h; i != 0; --i, pixel_row += dst->pitch) {
+	for(int i = dst->h; i != 0; --i, coeff_row += src->row_stride, pixel_row += dst->pitch) {
+		const real_t* coeff = coeff_row;
 		uint8_t* pixel = pixel_row;
 		for(int j = dst->w; j != 0; --j, pixel += 4, ++coeff) {
 			uint8_t level = (uint8_t)fmax(fmin(255.f * (*coeff), 255.f), 0.f);
@@ -65,6 +65,7 @@ root_matrix_heat_diffusion_node_delegate = {
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__none
 };
 
 
@@ -174,16 +175,18 @@ node_update(
 	);
 
 	// Diffusion operator on U
-	Matrix_rowwise_convolution__zero(
+	Matrix_parallel_rowwise_convolution__zero(
 		&(data->U_tmp),
 		&(data->U),
-		&(data->diff_kernel)
+		&(data->diff_kernel),
+		self->thread_pool
 	);
 
-	Matrix_colwise_convolution__zero(
+	Matrix_parallel_colwise_convolution__zero(
 		&(data->U),
 		&(data->U_tmp),
-		&(data->diff_kernel)
+		&(data->diff_kernel),
+		self->thread_pool
 	);
 	
 	// Apply decay
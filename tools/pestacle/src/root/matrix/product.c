@@ -12,12 +12,6 @@ node_setup(
 );
 
 
-static void
-node_destroy(
-	Node* self
-);
-
-
 static void
 node_update(
 	Node* self
@@ -60,39 +54,16 @@ root_matrix_product_node_delegate = {
 	node_parameters,
 	{
 		node_setup,
-		node_destroy,
+		0,
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__stateless | NodeDelegateFlag__in_place
 };
 
 
 // --- Implementation ---------------------------------------------------------
 
-typedef struct {
-	Matrix out;
-} Product;
-
-
-static void
-Product_init(
-	Product* self,
-	size_t width,
-	size_t height
-) {
-	Matrix_init(&(self->out), height, width);
-	Matrix_fill(&(self->out), (real_t)0);
-}
-
-
-static void
-Product_destroy(
-	Product* self
-) {
-	Matrix_destroy(&(self->out));
-}
-
-
 static bool
 node_setup(
 	Node* self
@@ -113,50 +84,29 @@ node_setup(
 		&(self->in_descriptors[SOURCE_B_INPUT]), width, height
 	);
 
-	// Allocate data
-	Product* data =
-		(Product*)checked_malloc(sizeof(Product));
-
-	if (!data)
-		return false;
-
-	// Setup data
-	Product_init(data, width, height);
-
 	// Setup output descriptor
 	DataDescriptor_set_as_matrix(&(self->out_descriptor), width, height);
 
+	// Request the output buffer
+	Node_request_output_buffer(self);
+
 	// Job done
-	self->data = data;
 	return true;
 }
 
 
-static void
-node_destroy(
-	Node* self
-) {
-	Product* data = (Product*)self->data;
-
-	if (data) {
-		Product_destroy(data);
-		free(data);
-	}
-}
-
-
 static void
 node_update(
 	Node* self
 ) {
-	Product* data = (Product*)self->data;
+	if (!self->is_in_place)
+		Matrix_copy(
+			&(self->output_buffer),
+			Node_output(self->inputs[SOURCE_A_INPUT]).matrix
+		);
 
-	Matrix_copy(
-		&(data->out),
-		Node_output(self->inputs[SOURCE_A_INPUT]).matrix
-	);
 	Matrix_mul(
-		&(data->out),
+		&(self->output_buffer),
 		Node_output(self->inputs[SOURCE_B_INPUT]).matrix
 	);
 }
@@ -166,8 +116,6 @@ static NodeOutput
 node_output(
 	const Node* self
 ) {
-	const Product* data = (const Product*)self->data;
-
-	NodeOutput ret = { .matrix = &(data->out) };
+	NodeOutput ret = { .matrix = &(self->output_buffer) };
 	return ret;
 }
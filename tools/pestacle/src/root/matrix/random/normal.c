@@ -83,6 +83,7 @@ root_matrix_random_normal_node_delegate = {
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__none
 };
 
 
@@ -71,6 +71,7 @@ root_matrix_random_uniform_node_delegate = {
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__none
 };
 
 
@@ -11,12 +11,6 @@ node_setup(
 );
 
 
-static void
-node_destroy(
-	Node* self
-);
-
-
 static void
 node_update(
 	Node* self
@@ -67,10 +61,11 @@ root_matrix_resample_nearest_node_delegate = {
 	node_parameters,
 	{
 		node_setup,
-		node_destroy,
+		0,
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__stateless
 };
 
 
@@ -96,10 +91,6 @@ node_setup(
 	size_t output_width  = (size_t)self->parameters[WIDTH_PARAMETER].int64_value;
 	size_t output_height = (size_t)self->parameters[HEIGHT_PARAMETER].int64_value;
 
-	// Allocate
-	Matrix* data = (Matrix*)checked_malloc(sizeof(Matrix));
-	Matrix_init(data, output_height, output_width);
-
 	// Setup output descriptor
 	DataDescriptor_set_as_matrix(
 		&(self->out_descriptor),
@@ -107,28 +98,20 @@ node_setup(
 		output_height
 	);
 
+	// Request the output buffer
+	Node_request_output_buffer(self);
+
 	// Job done
-	self->data = data;
 	return true;
 }
 
 
-static void
-node_destroy(
-	Node* self
-) {
-	Matrix* data = (Matrix*)self->data;
-	if (data)
-		Matrix_destroy(data);
-}
-
-
 static void
 node_update(
 	Node* self
 ) {
 	const Matrix* src = Node_output(self->inputs[SOURCE_INPUT]).matrix;
-	Matrix* dst = (Matrix*)self->data;
+	Matrix* dst = &(self->output_buffer);
 
 	Matrix_resample_nearest(dst, src);
 }
@@ -138,8 +121,6 @@ static NodeOutput
 node_output(
 	const Node* self
 ) {
-	Matrix* data = (Matrix*)self->data;
-
-	NodeOutput ret = { .matrix = data };
+	NodeOutput ret = { .matrix = &(self->output_buffer) };
 	return ret;
 }
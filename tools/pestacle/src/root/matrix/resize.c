@@ -77,26 +77,21 @@ root_matrix_resize_node_delegate = {
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__stateless
 };
 
 
 // --- Implementation ---------------------------------------------------------
 
+#define PASS_COUNT 3
+
 typedef struct {
 	Matrix A;
 	Matrix B;
-	Matrix C;
-	Matrix D;
-	Matrix out;
-	size_t lo_filter_size_x;
-	size_t hi_filter_size_x;
-	size_t lo_filter_size_y;
-	size_t hi_filter_size_y;
+	size_t filter_sizes_x[PASS_COUNT];
+	size_t filter_sizes_y[PASS_COUNT];
 } MatrixResizeData;
 
-
-#define PASS_COUNT 3
-
 static real_t
 get_ideal_filter_size(
 	real_t sigma,
@@ -136,21 +131,12 @@ matrix_resize_data_init(
 	size_t output_width,
 	size_t output_height
 ) {
-	Matrix_init(&(self->A), input_height, input_width);
+	Matrix_init_padded(&(self->A), input_height, input_width);
 	Matrix_fill(&(self->A), (real_t)0);
 
-	Matrix_init(&(self->B), input_height, input_width);
+	Matrix_init_padded(&(self->B), input_height, input_width);
 	Matrix_fill(&(self->B), (real_t)0);
 
-	Matrix_init(&(self->C), input_width, input_height);
-	Matrix_fill(&(self->C), (real_t)0);
-
-	Matrix_init(&(self->D), input_width, input_height);
-	Matrix_fill(&(self->D), (real_t)0);
-
-	Matrix_init(&(self->out), output_height, output_width);
-	Matrix_fill(&(self->out), (real_t)0);
-
 	real_t x_factor = ((float)input_width) / ((float)output_width);
 	real_t y_factor = ((float)input_height) / ((float)output_height);
 
@@ -160,10 +146,14 @@ matrix_resize_data_init(
 	real_t ideal_filter_size_x = get_ideal_filter_size(kernel_x_sigma, PASS_COUNT);
 	real_t ideal_filter_size_y = get_ideal_filter_size(kernel_y_sigma, PASS_COUNT);
 
-	self->lo_filter_size_x = get_lo_filter_size(ideal_filter_size_x);
-	self->lo_filter_size_y = get_lo_filter_size(ideal_filter_size_y);
-	self->hi_filter_size_x = get_hi_filter_size(ideal_filter_size_x);
-	self->hi_filter_size_y = get_hi_filter_size(ideal_filter_size_y);
+	// One pass with the lower filter size, then the others with the higher
+	self->filter_sizes_x[0] = get_lo_filter_size(ideal_filter_size_x);
+	self->filter_sizes_y[0] = get_lo_filter_size(ideal_filter_size_y);
+
+	for(size_t i = 1; i < PASS_COUNT; ++i) {
+		self->filter_sizes_x[i] = get_hi_filter_size(ideal_filter_size_x);
+		self->filter_sizes_y[i] = get_hi_filter_size(ideal_filter_size_y);
+	}
 }
 
 
@@ -173,9 +163,6 @@ matrix_resize_data_destroy(
 ) {
 	Matrix_destroy(&(self->A));
 	Matrix_destroy(&(self->B));
-	Matrix_destroy(&(self->C));
-	Matrix_destroy(&(self->D));
-	Matrix_destroy(&(self->out));
 }
 
 
@@ -221,6 +208,9 @@ node_setup(
 		output_height
 	);
 
+	// Request the output buffer
+	Node_request_output_buffer(self);
+
 	// Job done
 	self->data = data;
 	return true;
@@ -246,64 +236,28 @@ node_update(
 	const Matrix* src =
 		Node_output(self->inputs[SOURCE_INPUT]).matrix;
 
-	// A = box-filter(src)
-	Matrix_rowwise_box_filter(
+	// A = row-wise box-filters(src)
+	Matrix_parallel_rowwise_iterated_box_filter(
 		&(data->A),
 		src,
-		data->lo_filter_size_x
+		data->filter_sizes_x,
+		PASS_COUNT,
+		self->thread_pool
 	);
 
-	// B = box-filter(A)
-	Matrix_rowwise_box_filter(
+	// B = column-wise box-filters(A)
+	Matrix_parallel_colwise_iterated_box_filter(
 		&(data->B),
 		&(data->A),
-		data->hi_filter_size_x
-	);
-
-	// A = box-filter(B)
-	Matrix_rowwise_box_filter(
-		&(data->A),
-		&(data->B),
-		data->hi_filter_size_x
+		data->filter_sizes_y,
+		PASS_COUNT,
+		self->thread_pool
 	);
 
-	// C = transpose(A)
-	Matrix_transpose(
-		&(data->C),
-		&(data->A)
-	);
-
-	// D = box-filter(C)
-	Matrix_rowwise_box_filter(
-		&(data->D),
-		&(data->C),
-		data->lo_filter_size_y
-	);
-
-	// C = box-filter(D)
-	Matrix_rowwise_box_filter(
-		&(data->C),
-		&(data->D),
-		data->hi_filter_size_y
-	);
-
-	// D = box-filterC)
-	Matrix_rowwise_box_filter(
-		&(data->D),
-		&(data->C),
-		data->hi_filter_size_y
-	);
-
-	// A = transpose(D)
-	Matrix_transpose(
-		&(data->A),
-		&(data->D)
-	);
-
-	// out = resample(A)
+	// out = resample(B)
 	Matrix_resample_nearest(
-		&(data->out),
-		&(data->A)
+		&(self->output_buffer),
+		&(data->B)
 	);
 }
 
@@ -312,8 +266,6 @@ static NodeOutput
 node_output(
 	const Node* self
 ) {
-	MatrixResizeData* data = (MatrixResizeData*)self->data;
-
-	NodeOutput ret = { .matrix = &(data->out) };
+	NodeOutput ret = { .matrix = &(self->output_buffer) };
 	return ret;
 }
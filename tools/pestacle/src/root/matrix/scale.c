@@ -11,12 +11,6 @@ node_setup(
 );
 
 
-static void
-node_destroy(
-	Node* self
-);
-
-
 static void
 node_update(
 	Node* self
@@ -61,10 +55,11 @@ root_matrix_scale_node_delegate = {
 	node_parameters,
 	{
 		node_setup,
-		node_destroy,
+		0,
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__stateless | NodeDelegateFlag__in_place
 };
 
 
@@ -86,36 +81,22 @@ node_setup(
 		&(self->in_descriptors[SOURCE_INPUT]), width, height
 	);
 
-	// Allocate data
-	Matrix* data =
-		(Matrix*)checked_malloc(sizeof(Matrix));
-
-	if (!data)
-		return false;
-
-	// Setup data
-	Matrix_init(data, height, width);
-	Matrix_fill(data, (real_t)0);
-
 	// Setup output descriptor
 	DataDescriptor_set_as_matrix(&(self->out_descriptor), width, height);
 
-	// Job done
-	self->data = data;
-	return true;
-}
+	// Request the output buffer
+	Node_request_output_buffer(self);
 
+	// Declare the element-wise operations
+	ArrayOp op = {
+		ArrayOpCode__scale,
+		(real_t)self->parameters[FACTOR_PARAMETER].real_value
+	};
 
-static void
-node_destroy(
-	Node* self
-) {
-	Matrix* data = (Matrix*)self->data;
+	Node_set_element_wise_ops(self, &op, 1);
 
-	if (data) {
-		Matrix_destroy(data);
-		free(data);
-	}
+	// Job done
+	return true;
 }
 
 
@@ -123,18 +104,13 @@ static void
 node_update(
 	Node* self
 ) {
-	real_t factor = (real_t)self->parameters[FACTOR_PARAMETER].real_value;
-
-	Matrix* data = (Matrix*)self->data;
+	if (!self->is_in_place)
+		Matrix_copy(
+			&(self->output_buffer),
+			Node_output(self->inputs[SOURCE_INPUT]).matrix
+		);
 
-	Matrix_copy(
-		data,
-		Node_output(self->inputs[SOURCE_INPUT]).matrix
-	);
-	Matrix_scale(
-		data,
-		factor
-	);
+	Node_run_element_wise_ops(self);
 }
 
 
@@ -142,8 +118,6 @@ static NodeOutput
 node_output(
 	const Node* self
 ) {
-	const Matrix* data = (const Matrix*)self->data;
-
-	NodeOutput ret = { .matrix = data };
+	NodeOutput ret = { .matrix = &(self->output_buffer) };
 	return ret;
 }
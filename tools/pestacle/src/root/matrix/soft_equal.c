@@ -14,12 +14,6 @@ node_setup(
 );
 
 
-static void
-node_destroy(
-	Node* self
-);
-
-
 static void
 node_update(
 	Node* self
@@ -76,59 +70,16 @@ root_matrix_soft_equal_node_delegate = {
 	node_parameters,
 	{
 		node_setup,
-		node_destroy,
+		0,
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__stateless | NodeDelegateFlag__in_place
 };
 
 
 // --- Implementation ---------------------------------------------------------
 
-typedef struct {
-	Matrix out;
-	real_t value;
-	real_t factor;
-} SoftEqual;
-
-
-static void
-SoftEqual_init(
-	SoftEqual* self,
-	size_t width,
-	size_t height,
-	real_t value,
-	real_t radius,
-	real_t ratio
-) {
-	Matrix_init(&(self->out), height, width);
-	Matrix_fill(&(self->out), (real_t)0);
-
-	self->value = value;
-	self->factor = -pow(erfinv(ratio) / radius, 2);
-}
-
-
-static void
-SoftEqual_destroy(
-	SoftEqual* self
-) {
-	Matrix_destroy(&(self->out));
-}
-
-
-static void
-SoftEqual_transform(
-	SoftEqual* self,
-	Matrix* out
-) {
-	Matrix_inc(out, -self->value);
-	Matrix_square(out);
-	Matrix_scale(out, self->factor);
-	Matrix_exp(out);
-}
-
-
 static bool
 node_setup(
 	Node* self
@@ -167,35 +118,27 @@ node_setup(
 		return false;
 	}
 
-	// Allocate data
-	SoftEqual* data =
-		(SoftEqual*)checked_malloc(sizeof(SoftEqual));
-
-	if (!data)
-		return false;
-
-	// Setup data
-	SoftEqual_init(data, width, height, value, radius, ratio);
-
 	// Setup output descriptor
 	DataDescriptor_set_as_matrix(&(self->out_descriptor), width, height);
 
-	// Job done
-	self->data = data;
-	return true;
-}
+	// Request the output buffer
+	Node_request_output_buffer(self);
 
+	// Declare the element-wise operations : exp(-((x - value) / s) ^ 2), with
+	// s such that the ratio of the mass is within the radius
+	real_t factor = -pow(erfinv(ratio) / radius, 2);
 
-static void
-node_destroy(
-	Node* self
-) {
-	SoftEqual* data = (SoftEqual*)self->data;
+	ArrayOp ops[] = {
+		{ ArrayOpCode__inc, -value },
+		{ ArrayOpCode__square, (real_t)0 },
+		{ ArrayOpCode__scale, factor },
+		{ ArrayOpCode__exp, (real_t)0 }
+	};
 
-	if (data) {
-		SoftEqual_destroy(data);
-		free(data);
-	}
+	Node_set_element_wise_ops(self, ops, sizeof(ops) / sizeof(ops[0]));
+
+	// Job done
+	return true;
 }
 
 
@@ -203,17 +146,13 @@ static void
 node_update(
 	Node* self
 ) {
-	SoftEqual* data = (SoftEqual*)self->data;
-
-	Matrix_copy(
-		&(data->out),
-		Node_output(self->inputs[SOURCE_INPUT]).matrix
-	);
+	if (!self->is_in_place)
+		Matrix_copy(
+			&(self->output_buffer),
+			Node_output(self->inputs[SOURCE_INPUT]).matrix
+		);
 
-	SoftEqual_transform(
-		data,
-		&(data->out)
-	);
+	Node_run_element_wise_ops(self);
 }
 
 
@@ -221,8 +160,6 @@ static NodeOutput
 node_output(
 	const Node* self
 ) {
-	const SoftEqual* data = (const SoftEqual*)self->data;
-
-	NodeOutput ret = { .matrix = &(data->out) };
+	NodeOutput ret = { .matrix = &(self->output_buffer) };
 	return ret;
 }
@@ -66,6 +66,7 @@ root_matrix_stddev_node_delegate = {
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__stateless
 };
 
 
@@ -73,7 +74,6 @@ root_matrix_stddev_node_delegate = {
 
 typedef struct {
 	Matrix U;
-	Matrix out;
 	GaussianFilter filter;
 } StdDevData;
 
@@ -85,9 +85,6 @@ StdDevData_init(
 	size_t height,
 	real_t sigma
 ) {
-	Matrix_init(&(self->out), height, width);
-	Matrix_fill(&(self->out), (real_t)0);
-
 	Matrix_init(&(self->U), height, width);
 	Matrix_fill(&(self->U), (real_t)0);
 
@@ -96,7 +93,8 @@ StdDevData_init(
 		height,
 		width,
 		sigma,
-		GaussianFilterMode__MIRROR
+		GaussianFilterMode__MIRROR,
+		GaussianFilterMethod__CONVOLUTION
 	);
 }
 
@@ -106,7 +104,6 @@ StdDevData_destroy(
 	StdDevData* self
 ) {
 	Matrix_destroy(&(self->U));
-	Matrix_destroy(&(self->out));
 	GaussianFilter_destroy(&(self->filter));
 }
 
@@ -143,6 +140,9 @@ node_setup(
 	// Setup output descriptor
 	DataDescriptor_set_as_matrix(&(self->out_descriptor), width, height);
 
+	// Request the output buffer
+	Node_request_output_buffer(self);
+
 	// Job done
 	self->data = data;
 	return true;
@@ -170,13 +170,14 @@ node_update(
 
 	// Compute out = gaussian(E^2)
 	Matrix_copy(
-		&(data->out),
+		&(self->output_buffer),
 		Node_output(self->inputs[SOURCE_INPUT]).matrix
 	);
-	Matrix_square(&(data->out));
-	GaussianFilter_transform(
+	Matrix_square(&(self->output_buffer));
+	GaussianFilter_parallel_transform(
 		&(data->filter),
-		&(data->out)
+		&(self->output_buffer),
+		self->thread_pool
 	);
 
 	// Compute U = gaussian(E)^2
@@ -184,15 +185,16 @@ node_update(
 		&(data->U),
 		Node_output(self->inputs[SOURCE_INPUT]).matrix
 	);
-	GaussianFilter_transform(
+	GaussianFilter_parallel_transform(
 		&(data->filter),
-		&(data->U)
+		&(data->U),
+		self->thread_pool
 	);
 	Matrix_square(&(data->U));
 
 	// Compute out = sqrt(out - U)
-	Matrix_sub(&(data->out), &(data->U));
-	Matrix_sqrt(&(data->out));
+	Matrix_sub(&(self->output_buffer), &(data->U));
+	Matrix_sqrt(&(self->output_buffer));
 }
 
 
@@ -200,8 +202,6 @@ static NodeOutput
 node_output(
 	const Node* self
 ) {
-	const StdDevData* data = (const StdDevData*)self->data;
-
-	NodeOutput ret = { .matrix = &(data->out) };
+	NodeOutput ret = { .matrix = &(self->output_buffer) };
 	return ret;
 }
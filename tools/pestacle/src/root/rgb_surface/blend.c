@@ -69,6 +69,7 @@ root_rgb_surface_blend_node_delegate = {
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__stateless
 };
 
 
@@ -152,12 +153,13 @@ node_update(
 		(SDL_Surface*)self->data;
 
 	// Compute the blend
-	const real_t* coeff = mask->data;
+	const real_t* coeff_row = mask->data;
 	uint8_t* dst_pixel_row = (uint8_t*)dst->pixels;
 	const uint8_t* src_a_pixel_row = (const uint8_t*)src_a->pixels;
 	const uint8_t* src_b_pixel_row = (const uint8_t*)src_b->pixels;
 	
-	for(int i = dst->h; i != 0; --i, dst_pixel_row += dst->pitch, src_a_pixel_row += src_a->pitch, src_b_pixel_row += src_b->pitch) {
+	for(int i = dst->h; i != 0; --i, coeff_row += mask->row_stride, dst_pixel_row += dst->pitch, src_a_pixel_row += src_a->pitch, src_b_pixel_row += src_b->pitch) {
+		const real_t* coeff = coeff_row;
 		uint8_t* dst_pixel = dst_pixel_row;
 		const uint8_t* src_a_pixel = src_a_pixel_row;
 		const uint8_t* src_b_pixel = src_b_pixel_row;
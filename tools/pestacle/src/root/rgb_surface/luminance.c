@@ -1,5 +1,6 @@
 #include <tgmath.h>
 #include <pestacle/memory.h>
+#include <pestacle/math/array_ops.h>
 
 #include "root/rgb_surface/luminance.h"
 
@@ -12,12 +13,6 @@ node_setup(
 );
 
 
-static void
-node_destroy(
-	Node* self
-);
-
-
 static void
 node_update(
 	Node* self
@@ -32,6 +27,8 @@ node_output(
 
 #define SOURCE_INPUT 0
 
+#define LUMINANCE_BLOCK_LEN 256
+
 
 static const NodeInputDefinition
 node_inputs[] = {
@@ -56,15 +53,35 @@ root_rgb_surface_luminance_node_delegate = {
 	node_parameters,
 	{
 		node_setup,
-		node_destroy,
+		0,
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__stateless
 };
 
 
 // --- Implementation ---------------------------------------------------------
 
+static real_t sRGB_to_linear_table[256];
+
+
+static real_t
+sRGB_to_linear(real_t x) {
+	if (x <= ((real_t).04045))
+		return x / ((real_t)12.92);
+
+	return pow(((x + ((real_t).055)) / ((real_t)1.055)), ((real_t)2.4));
+}
+
+
+static void
+init_sRGB_to_linear_table() {
+	for(int i = 0; i < 256; ++i)
+		sRGB_to_linear_table[i] = sRGB_to_linear(i / ((real_t)255));
+}
+
+
 static bool
 node_setup(
 	Node* self
@@ -80,98 +97,117 @@ node_setup(
 		&(self->in_descriptors[SOURCE_INPUT]), width, height
 	);
 
-	// Allocate
-	Matrix* matrix =
-		(Matrix*)checked_malloc(sizeof(Matrix));
-
-	if (!matrix)
-		return false;
-
 	// Setup output descriptor
 	DataDescriptor_set_as_matrix(&(self->out_descriptor), width, height);
 
-	// Setup the accumulator matrix
-	Matrix_init(matrix, height, width);
-	Matrix_fill(matrix, (real_t)0);
+	// Request the output buffer
+	Node_request_output_buffer(self);
+
+	// Tabulate the sRGB to linear conversion of the 256 channel values
+	init_sRGB_to_linear_table();
 
 	// Job done
-	self->data = matrix;
 	return true;
 }
 
 
 static void
-node_destroy(
-	Node* self
+Y_to_Lstar(
+	real_t* dst,
+	size_t len
 ) {
-	Matrix* matrix = (Matrix*)self->data;
-	if (matrix) {
-		Matrix_destroy(matrix);
-		free(matrix);
-	}
-}
-
+	// 1976 CIELAB perceived luminance formula, the cube roots being computed
+	// block by block with array_ops_pow
+	real_t cube_root[LUMINANCE_BLOCK_LEN];
 
-static real_t
-sRGB_to_linear(real_t x) {
-	if (x <= ((real_t).04045))
-		return x / ((real_t)12.92);
+	while(len != 0) {
+		size_t block_len = len < LUMINANCE_BLOCK_LEN ? len : LUMINANCE_BLOCK_LEN;
 
-	return pow(((x + ((real_t).055)) / ((real_t)1.055)), ((real_t)2.4));
-}
+		array_ops_copy(cube_root, dst, block_len);
+		array_ops_pow(cube_root, block_len, ((real_t)1) / ((real_t)3));
 
+		for(size_t i = 0; i < block_len; ++i) {
+			real_t L_star;
+			if (dst[i] <= ((real_t)0.008856))
+				L_star = dst[i] * ((real_t)(903.3));
+			else
+				L_star = cube_root[i] * 116 - 16;
 
-static real_t
-Y_to_Lstar(real_t Y) {
-	// 1976 CIELAB perceived luminance formula
-	if (Y <= ((real_t)0.008856))
-		return Y * ((real_t)(903.3));
+			dst[i] = L_star / ((real_t)100);
+		}
 
-	return pow(Y, ((real_t)1) / ((real_t)3)) * 116 - 16;
+		dst += block_len;
+		len -= block_len;
+	}
 }
 
 
-static void
-node_update(
-	Node* self
-) {
-	// Retrieve inputs and outputs
-	const SDL_Surface* src =
-		Node_output(self->inputs[SOURCE_INPUT]).rgb_surface;
+typedef struct {
+	const SDL_Surface* src;
+	Matrix* dst;
+} LuminanceJobContext;
 
-	Matrix* dst = (Matrix*)self->data;
 
-	// Compute the output
-	real_t* coeff = dst->data;
-	const uint8_t* pixel_row = (const uint8_t*)src->pixels;
-	for(int i = src->h; i != 0; --i, pixel_row += src->pitch) {
+static void
+luminance_job(
+	void* context,
+	size_t begin,
+	size_t end
+) {
+	const LuminanceJobContext* job_context = (const LuminanceJobContext*)context;
+	const SDL_Surface* src = job_context->src;
+
+	// Compute the output for the rows [begin, end)
+	const Matrix* dst = job_context->dst;
+	real_t* coeff_row = dst->data + begin * dst->row_stride;
+	const uint8_t* pixel_row = ((const uint8_t*)src->pixels) + begin * src->pitch;
+	for(size_t i = end - begin; i != 0; --i, pixel_row += src->pitch, coeff_row += dst->row_stride) {
+		// Linear luminance of the row
 		const uint8_t* pixel = pixel_row;
+		real_t* coeff = coeff_row;
 		for(int j = src->w; j != 0; --j, pixel += 4, ++coeff) {
-			real_t R = pixel[0] / ((real_t)255);
-			real_t G = pixel[1] / ((real_t)255);
-			real_t B = pixel[2] / ((real_t)255);
+			real_t R = sRGB_to_linear_table[pixel[0]];
+			real_t G = sRGB_to_linear_table[pixel[1]];
+			real_t B = sRGB_to_linear_table[pixel[2]];
 
-			R = sRGB_to_linear(R);
-			G = sRGB_to_linear(G);
-			B = sRGB_to_linear(B);
-
-			real_t Y =
+			*coeff =
 				((real_t)0.2126) * R +
 				((real_t)0.7152) * G +
 				((real_t)0.0722) * B;
-			
-			real_t L_star = Y_to_Lstar(Y);
-
-			*coeff = L_star / ((real_t)100);
 		}
+
+		// Perceived luminance of the row
+		Y_to_Lstar(coeff_row, (size_t)src->w);
 	}
 }
 
 
+static void
+node_update(
+	Node* self
+) {
+	// Retrieve inputs and outputs
+	LuminanceJobContext job_context = {
+		Node_output(self->inputs[SOURCE_INPUT]).rgb_surface,
+		&(self->output_buffer)
+	};
+
+	// Compute the output, the rows being split among the threads
+	ThreadPool_parallel_for(
+		self->thread_pool,
+		luminance_job,
+		&job_context,
+		0,
+		(size_t)job_context.src->h,
+		16
+	);
+}
+
+
 static NodeOutput
 node_output(
 	const Node* self
 ) {
-	NodeOutput ret = { .matrix = (Matrix*)self->data };
+	NodeOutput ret = { .matrix = &(self->output_buffer) };
 	return ret;
 }
@@ -65,6 +65,7 @@ root_rgb_surface_overlay_node_delegate = {
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__stateless
 };
 
 
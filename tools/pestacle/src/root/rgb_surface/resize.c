@@ -70,6 +70,7 @@ root_rgb_surface_resize_node_delegate = {
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__stateless
 };
 
 
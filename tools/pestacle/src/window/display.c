@@ -49,6 +49,7 @@ display_node_delegate = {
 		node_update,
 		0
 	},
+	NodeDelegateFlag__main_thread
 }; // display_node_delegate
 
 
@@ -62,6 +62,7 @@ mouse_motion_node_delegate = {
 		node_update,
 		node_output
 	},
+	NodeDelegateFlag__main_thread
 };
 
 
@@ -160,9 +161,9 @@ node_setup(
 	// Allocate
 	MouseMotion* mouse_motion = (MouseMotion*)checked_malloc(sizeof(MouseMotion));
 
-	// Setup output descriptor
-	int w, h;
-	SDL_GetWindowSize(window->window, &w, &h);
+	// Setup output descriptor, the window surface having the window size
+	int w = window->surface->w;
+	int h = window->surface->h;
 	DataDescriptor_set_as_matrix(&(self->out_descriptor), w, h);
 
 	// Initialize
@@ -198,8 +199,10 @@ node_update(
 	// Swap
 	MouseMotion_swap(mouse_motion);
 
-	// Retrieve the window
+	// Retrieve the window, an offscreen one has no mouse
 	Window* window = (Window*)self->delegate_scope->data;
+	if (Window_is_offscreen(window))
+		return;
 
 	// Get the window position and size
 	int win_x, win_y;
@@ -80,6 +80,7 @@ scope_setup(
 	Window* window = 
 		WindowManager_add_window(
 			window_manager,
+			self->name,
 			title,
 			width,
 			height
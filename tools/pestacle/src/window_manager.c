@@ -1,5 +1,6 @@
 #include <assert.h>
 #include <pestacle/memory.h>
+#include <pestacle/strings.h>
 #include "window_manager.h"
 
 
@@ -50,52 +51,88 @@ Window_destroy(
 		#endif
 	}
 
-	// Destroy the window
+	// Destroy the window, or the surface of an offscreen window
 	if (self->window) {
 		SDL_DestroyWindow(self->window);
 		#ifdef DEBUG
 		self->window = 0;
 		#endif
 	}
+	else if (self->surface)
+		SDL_FreeSurface(self->surface);
+
+	free(self->name);
+
+	#ifdef DEBUG
+	self->surface = 0;
+	self->name = 0;
+	#endif
 }
 
 
 static bool
 Window_init(
 	Window* self,
+	const char* name,
 	const char* title,
 	int width,
-	int height
+	int height,
+	bool is_offscreen
 ) {
 	assert(self);
+	assert(name);
 	assert(title);
 
 	self->next = 0;
+	self->name = strclone(name);
 	self->window = 0;
 	self->surface = 0;
 	self->renderer = 0;
 	self->listener_head = 0;
 
-	self->window = SDL_CreateWindow(
-		title,
-		SDL_WINDOWPOS_CENTERED,
-		SDL_WINDOWPOS_CENTERED,
-		width,
-		height,
-		0
-	);
-	
-	if (!self->window) {
-		SDL_LogError(
-			SDL_LOG_CATEGORY_VIDEO,
-			"Could not create window: %s\n",
-			SDL_GetError()
+	// Create the window and retrieve its surface, or create an offscreen
+	// surface in the usual format of the window surfaces
+	if (is_offscreen) {
+		self->surface = SDL_CreateRGBSurfaceWithFormat(
+			0,
+			width,
+			height,
+			32,
+			SDL_PIXELFORMAT_RGB888
 		);
-		goto failure;
+
+		if (!self->surface) {
+			SDL_LogError(
+				SDL_LOG_CATEGORY_VIDEO,
+				"Could not create offscreen surface: %s\n",
+				SDL_GetError()
+			);
+			goto failure;
+		}
+	}
+	else {
+		self->window = SDL_CreateWindow(
+			title,
+			SDL_WINDOWPOS_CENTERED,
+			SDL_WINDOWPOS_CENTERED,
+			width,
+			height,
+			0
+		);
+
+		if (!self->window) {
+			SDL_LogError(
+				SDL_LOG_CATEGORY_VIDEO,
+				"Could not create window: %s\n",
+				SDL_GetError()
+			);
+			goto failure;
+		}
+
+		self->surface = SDL_GetWindowSurface(self->window);
 	}
 
 	// Create a renderer
-	self->surface = SDL_GetWindowSurface(self->window);
 	self->renderer = SDL_CreateSoftwareRenderer(self->surface);
 
 	if (!self->renderer) {
@@ -123,9 +160,19 @@ Window_update(
 	Window* self
 ) {
 	assert(self);
-	assert(self->window);
 
-	SDL_UpdateWindowSurface(self->window);
+	if (self->window)
+		SDL_UpdateWindowSurface(self->window);
+}
+
+
+bool
+Window_is_offscreen(
+	const Window* self
+) {
+	assert(self);
+
+	return !self->window;
 }
 
 
@@ -136,7 +183,8 @@ Window_set_bordered(
 ) {
 	assert(self);
 
-	SDL_SetWindowBordered(self->window, bordered);
+	if (self->window)
+		SDL_SetWindowBordered(self->window, bordered);
 }
 
 
@@ -168,6 +216,9 @@ Window_dispatch_event(
 ) {
 	assert(self);
 
+	if (!self->window)
+		return;
+
 	// Select the event
 	Uint32 windowID = SDL_GetWindowID(self->window);
 	switch(event->type) {
@@ -224,6 +275,18 @@ WindowManager_init(
 	assert(self);
 
 	self->head = 0;
+	self->is_offscreen = false;
+}
+
+
+void
+WindowManager_set_offscreen(
+	WindowManager* self
+) {
+	assert(self);
+	assert(!self->head);
+
+	self->is_offscreen = true;
 }
 
 
@@ -272,11 +335,13 @@ WindowManager_find_window_before(
 Window*
 WindowManager_add_window(
 	WindowManager* self,
+	const char* name,
 	const char* title,
 	int width,
 	int height
 ) {
 	assert(self);
+	assert(name);
 	assert(title);
 
 	// Allocate
@@ -285,7 +350,7 @@ WindowManager_add_window(
 		return 0;
 
 	// Initialisation
-	if (!Window_init(ret, title, width, height)) {
+	if (!Window_init(ret, name, title, width, height, self->is_offscreen)) {
 		free(ret);
 		return 0;
 	}